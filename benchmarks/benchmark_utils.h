@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_BENCHMARK_UTILS_H
+#define BITSERY_BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// each benchmark is a single translation unit executable, so it is fine to
+// define EASTL allocation functions here
+void* __cdecl
+operator new[](size_t size,
+               const char* name,
+               int flags,
+               unsigned debugFlags,
+               const char* file,
+               int line)
+{
+  (void)name;
+  (void)flags;
+  (void)debugFlags;
+  (void)file;
+  (void)line;
+  return new uint8_t[size];
+}
+
+void* __cdecl
+operator new[](size_t size,
+               size_t alignement,
+               size_t offset,
+               const char* name,
+               int flags,
+               unsigned debugFlags,
+               const char* file,
+               int line)
+{
+  (void)name;
+  (void)alignement;
+  (void)offset;
+  (void)flags;
+  (void)debugFlags;
+  (void)file;
+  (void)line;
+  return new uint8_t[size];
+}
+
+namespace bench {
+
+// prevents compiler from optimizing away computed value
+template<typename T>
+inline void
+doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const T* sink;
+  sink = &value;
+#endif
+}
+
+// runs fnc `repeat` times and returns best run duration in nanoseconds
+template<typename Fnc>
+double
+bestOf(size_t repeat, Fnc&& fnc)
+{
+  double best = 0;
+  for (size_t i = 0; i < repeat; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fnc();
+    auto end = std::chrono::steady_clock::now();
+    auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+    if (i == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+inline void
+report(const char* name, size_t items, double ns)
+{
+  std::printf("%-48s %12zu items %12.2f ns/item %10.3f ms\n",
+              name,
+              items,
+              ns / static_cast<double>(items),
+              ns / 1e6);
+}
+
+// number of repeats can be overridden from command line, first argument
+inline size_t
+repeatCount(int argc, char** argv, size_t defaultCount = 5)
+{
+  if (argc > 1) {
+    auto n = std::strtoul(argv[1], nullptr, 10);
+    if (n > 0)
+      return static_cast<size_t>(n);
+  }
+  return defaultCount;
+}
+
+}
+
+#endif // BITSERY_BENCHMARK_UTILS_H
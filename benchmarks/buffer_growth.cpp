@@ -0,0 +1,76 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// writes large "snapshot" into empty buffer, comparing growth policies and
+// buffer types: eastl::vector fills new memory with zeros when growing,
+// eastl::string grows without initializing it.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+#include <cstdio>
+
+static constexpr size_t SnapshotSize = 64 * 1024 * 1024;
+static constexpr size_t ChunkSize = 4096;
+
+template<typename Buffer, typename Growth>
+void
+run(const char* name, size_t repeat)
+{
+  using Writer = bitsery::Serializer<
+    bitsery::OutputBufferAdapter<Buffer, bitsery::DefaultConfig, Growth>>;
+  eastl::vector<uint8_t> chunk(ChunkSize, 0xAB);
+  bench::report(name, SnapshotSize, bench::bestOf(repeat, [&] {
+                  Buffer buf{};
+                  Writer ser{ buf };
+                  for (size_t i = 0; i < SnapshotSize / ChunkSize; ++i) {
+                    ser.value4b(static_cast<uint32_t>(i));
+                    ser.container1b(chunk, ChunkSize);
+                  }
+                  ser.adapter().flush();
+                  bench::doNotOptimize(buf.data());
+                }));
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  using Vector = eastl::vector<uint8_t>;
+  using String = eastl::string;
+  using HugePage = bitsery::GrowthHugePageAligned<>;
+  run<Vector, bitsery::GrowthGeometric>("vector, geometric", repeat);
+  run<Vector, bitsery::GrowthPowerOfTwo>("vector, power of two", repeat);
+  run<Vector, bitsery::GrowthPageAligned>("vector, page aligned", repeat);
+  run<Vector, HugePage>("vector, huge page aligned", repeat);
+  run<String, bitsery::GrowthGeometric>("string, geometric", repeat);
+  run<String, bitsery::GrowthPowerOfTwo>("string, power of two", repeat);
+  run<String, bitsery::GrowthPageAligned>("string, page aligned", repeat);
+  run<String, HugePage>("string, huge page aligned", repeat);
+}
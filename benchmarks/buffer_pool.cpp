@@ -0,0 +1,80 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// request/response path: serialize small message into fresh buffer with
+// quickSerialization, compared to buffer from thread local BufferPool.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/utils/buffer_pool.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+using Buffer = eastl::vector<uint8_t>;
+
+static constexpr size_t MessagesCount = 1000000;
+
+struct Response
+{
+  uint64_t requestId{};
+  uint32_t status{};
+  eastl::string body{};
+};
+
+template<typename S>
+void
+serialize(S& s, Response& o)
+{
+  s.value8b(o.requestId);
+  s.value4b(o.status);
+  s.text1b(o.body, 4096);
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  Response res{ 1, 200, eastl::string(300, 'x') };
+
+  bench::report("fresh buffer", MessagesCount, bench::bestOf(repeat, [&] {
+                  for (size_t i = 0; i < MessagesCount; ++i) {
+                    res.requestId = i;
+                    Buffer buf{};
+                    auto written = bitsery::quickSerialization(
+                      bitsery::OutputBufferAdapter<Buffer>{ buf }, res);
+                    bench::doNotOptimize(buf.data()[written - 1]);
+                  }
+                }));
+
+  bench::report("pooled buffer", MessagesCount, bench::bestOf(repeat, [&] {
+                  for (size_t i = 0; i < MessagesCount; ++i) {
+                    res.requestId = i;
+                    auto lease = bitsery::ext::quickSerializationPooled(res);
+                    bench::doNotOptimize(lease.data()[lease.size() - 1]);
+                  }
+                }));
+}
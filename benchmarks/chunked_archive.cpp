@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// archive with 64 subsystems (1MB each): loading single chunk from archive
+// compared with deserializing whole state, and loading all chunks in parallel.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/utils/chunked_archive.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdio>
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::OutputBufferAdapter<Buffer>;
+using Reader = bitsery::InputBufferAdapter<Buffer>;
+
+struct Subsystem
+{
+  eastl::vector<uint32_t> values{};
+};
+
+template<typename S>
+void
+serialize(S& s, Subsystem& o)
+{
+  s.container4b(o.values, 1u << 20);
+}
+
+struct State
+{
+  eastl::vector<Subsystem> subsystems{};
+};
+
+template<typename S>
+void
+serialize(S& s, State& o)
+{
+  s.container(o.subsystems, 1000);
+}
+
+static constexpr size_t SubsystemsCount = 64;
+static constexpr size_t SubsystemSize = 1024 * 1024 / 4;
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  State state{};
+  state.subsystems.resize(SubsystemsCount);
+  for (auto& subsystem : state.subsystems)
+    subsystem.values.resize(SubsystemSize, 5);
+
+  Buffer whole{};
+  const auto wholeSize = bitsery::quickSerialization(Writer{ whole }, state);
+  Buffer archive{};
+  {
+    bitsery::ext::ArchiveWriter<Writer> writer{ Writer{ archive } };
+    for (size_t i = 0; i < SubsystemsCount; ++i)
+      writer.write(i, state.subsystems[i]);
+    archive.resize(writer.finish());
+  }
+
+  State res{};
+  bench::report("deserialize whole state", 1, bench::bestOf(repeat, [&] {
+                  bitsery::quickDeserialization(
+                    Reader{ whole.begin(), wholeSize }, res);
+                  bench::doNotOptimize(res.subsystems.back().values.back());
+                }));
+  Subsystem single{};
+  bench::report("open archive and load one chunk", 1,
+                bench::bestOf(repeat, [&] {
+                  bitsery::ext::ArchiveReader<> reader{ archive.data(),
+                                                        archive.size() };
+                  reader.load(SubsystemsCount / 2, single);
+                  bench::doNotOptimize(single.values.back());
+                }));
+  for (size_t threads = 1; threads <= 8; threads *= 2) {
+    bitsery::ext::ThreadPoolExecutor pool{ threads };
+    bitsery::ext::ArchiveReader<> reader{ archive.data(), archive.size() };
+    eastl::vector<bitsery::ext::ArchiveReader<>::LoadRequest> requests{};
+    res.subsystems.resize(SubsystemsCount);
+    for (size_t i = 0; i < SubsystemsCount; ++i)
+      requests.push_back(reader.request(i, res.subsystems[i]));
+    char name[64];
+    std::snprintf(name, sizeof(name), "load all chunks, %zu threads", threads);
+    bench::report(name, 1, bench::bestOf(repeat, [&] {
+                    reader.loadParallel(pool, requests.data(), requests.size());
+                    bench::doNotOptimize(res.subsystems.back().values.back());
+                  }));
+  }
+  bench::report("crc32c 64MB", 1, bench::bestOf(repeat, [&] {
+                  bench::doNotOptimize(
+                    bitsery::ext::crc32c(archive.data(), archive.size()));
+                }));
+}
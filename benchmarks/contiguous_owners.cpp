@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// deserializes vector of owning pointers and then traverses it, comparing
+// separately allocated objects (UntrackedEastlSmartPtr) with single contiguous
+// block (ContiguousPointerOwners).
+// heap is fragmented before each run, to simulate long running process.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/contiguous_owners.h>
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/traits/vector.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+struct Body
+{
+  float position[3]{};
+  float velocity[3]{};
+  float mass{};
+  uint32_t id{};
+};
+
+template<typename S>
+void
+serialize(S& s, Body& o)
+{
+  s.container4b(o.position);
+  s.container4b(o.velocity);
+  s.value4b(o.mass);
+  s.value4b(o.id);
+}
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::Serializer<bitsery::OutputBufferAdapter<Buffer>>;
+using Reader = bitsery::Deserializer<bitsery::InputBufferAdapter<Buffer>>;
+
+static constexpr size_t BodiesCount = 1000000;
+
+// allocates many blocks of the same size and frees them in random order, so
+// that allocator hands out scattered addresses
+class FragmentedHeap
+{
+public:
+  FragmentedHeap()
+  {
+    _blocks.resize(BodiesCount * 2);
+    for (auto& b : _blocks)
+      b = ::operator new(sizeof(Body));
+    std::shuffle(_blocks.begin(), _blocks.end(), std::mt19937{ 42 });
+    // free half of them, keep other half alive
+    for (size_t i = 0; i < BodiesCount; ++i) {
+      ::operator delete(_blocks.back());
+      _blocks.pop_back();
+    }
+  }
+
+  ~FragmentedHeap()
+  {
+    for (auto b : _blocks)
+      ::operator delete(b);
+  }
+
+private:
+  std::vector<void*> _blocks;
+};
+
+template<typename T>
+float
+traverse(const eastl::vector<T>& bodies)
+{
+  float res{};
+  for (auto& b : bodies)
+    res += b->mass * b->velocity[0] + b->position[1];
+  return res;
+}
+
+template<typename T, typename TDeserialize>
+void
+run(const char* name,
+    const Buffer& buf,
+    size_t written,
+    size_t repeat,
+    TDeserialize&& deserialize)
+{
+  FragmentedHeap heap{};
+  eastl::vector<T> res{};
+  char fullName[64];
+  std::snprintf(fullName, sizeof(fullName), "%s, deserialize", name);
+  bench::report(fullName, BodiesCount, bench::bestOf(repeat, [&] {
+                  res.clear();
+                  Reader des{ buf.begin(), written };
+                  deserialize(des, res);
+                  bench::doNotOptimize(res.size());
+                }));
+  std::snprintf(fullName, sizeof(fullName), "%s, traverse", name);
+  bench::report(fullName, BodiesCount, bench::bestOf(repeat, [&] {
+                  bench::doNotOptimize(traverse(res));
+                }));
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+
+  eastl::vector<bitsery::ext::ContiguousUniquePtr<Body>> data{};
+  data.reserve(BodiesCount);
+  for (size_t i = 0; i < BodiesCount; ++i) {
+    data.emplace_back(new Body{});
+    data.back()->id = static_cast<uint32_t>(i);
+    data.back()->mass = 1.0f;
+  }
+  Buffer buf{};
+  Writer ser{ buf };
+  ser.ext(data, bitsery::ext::ContiguousPointerOwners{ BodiesCount });
+  ser.adapter().flush();
+  const auto written = ser.adapter().writtenBytesCount();
+  data.clear();
+
+  // both write the same data
+  run<eastl::unique_ptr<Body>>(
+    "UntrackedEastlSmartPtr",
+    buf,
+    written,
+    repeat,
+    [](Reader& des, eastl::vector<eastl::unique_ptr<Body>>& res) {
+      des.container(
+        res, BodiesCount, [](Reader& d, eastl::unique_ptr<Body>& b) {
+          d.ext(b, bitsery::ext::UntrackedEastlSmartPtr{});
+        });
+    });
+  run<bitsery::ext::ContiguousUniquePtr<Body>>(
+    "ContiguousPointerOwners",
+    buf,
+    written,
+    repeat,
+    [](Reader& des,
+       eastl::vector<bitsery::ext::ContiguousUniquePtr<Body>>& res) {
+      des.ext(res, bitsery::ext::ContiguousPointerOwners{ BodiesCount });
+    });
+}
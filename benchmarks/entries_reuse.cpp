@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// deserializes the same state into existing map every "tick", comparing
+// default EastlMap (clear and insert new nodes) with reuseEntries mode, that
+// keeps existing nodes and values.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/eastl_map.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/map.h>
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+
+#include <cstdio>
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::Serializer<bitsery::OutputBufferAdapter<Buffer>>;
+using Reader = bitsery::Deserializer<bitsery::InputBufferAdapter<Buffer>>;
+
+static constexpr size_t EntriesCount = 100000;
+
+struct Entity
+{
+  eastl::string name{};
+  float position[3]{};
+  uint32_t flags{};
+};
+
+template<typename S>
+void
+serialize(S& s, Entity& o)
+{
+  s.text1b(o.name, 64);
+  s.container4b(o.position);
+  s.value4b(o.flags);
+}
+
+template<typename S>
+void
+serializeEntry(S& s, uint32_t& key, Entity& value)
+{
+  s.value4b(key);
+  s.object(value);
+}
+
+template<typename TMap>
+void
+run(const char* name, size_t repeat)
+{
+  TMap data{};
+  for (uint32_t i = 0; i < EntriesCount; ++i) {
+    auto& e = data[i * 7u];
+    // long enough to not fit in small string buffer
+    e.name = "entity with reasonably long name";
+    e.flags = i;
+  }
+  Buffer buf{};
+  Writer ser{ buf };
+  ser.ext(data, bitsery::ext::EastlMap{ EntriesCount }, serializeEntry<Writer>);
+  ser.adapter().flush();
+  const auto written = ser.adapter().writtenBytesCount();
+
+  for (auto reuse : { false, true }) {
+    TMap res{};
+    char fullName[64];
+    std::snprintf(fullName,
+                  sizeof(fullName),
+                  "%s, %s",
+                  name,
+                  reuse ? "reuseEntries" : "default");
+    bench::report(fullName, EntriesCount, bench::bestOf(repeat, [&] {
+                    Reader des{ buf.begin(), written };
+                    des.ext(res,
+                            bitsery::ext::EastlMap{ EntriesCount, reuse },
+                            serializeEntry<Reader>);
+                    bench::doNotOptimize(res.size());
+                  }));
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  run<eastl::map<uint32_t, Entity>>("map", repeat);
+  run<eastl::unordered_map<uint32_t, Entity>>("unordered_map", repeat);
+}
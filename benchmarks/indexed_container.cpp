@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// query that touches 2% of 1M elements: deserializing whole container compared
+// with LazyContainerView, that deserializes only accessed elements.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/indexed_container.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::OutputBufferAdapter<Buffer>;
+using Reader = bitsery::InputBufferAdapter<Buffer>;
+
+struct Document
+{
+  uint64_t id{};
+  eastl::string title{};
+  eastl::vector<uint32_t> tags{};
+};
+
+template<typename S>
+void
+serialize(S& s, Document& o)
+{
+  s.value8b(o.id);
+  s.text1b(o.title, 256);
+  s.container4b(o.tags, 64);
+}
+
+struct Collection
+{
+  eastl::vector<Document> documents{};
+};
+
+template<typename S>
+void
+serialize(S& s, Collection& o)
+{
+  s.container(o.documents, 1u << 24);
+}
+
+// the same collection with offsets table, documents are either
+// eastl::vector<Document> or LazyContainerView<Document>
+template<typename TDocuments>
+struct IndexedCollection
+{
+  TDocuments documents{};
+};
+
+template<typename S, typename TDocuments>
+void
+serialize(S& s, IndexedCollection<TDocuments>& o)
+{
+  s.ext(o.documents, bitsery::ext::IndexedContainer{ 1u << 24 });
+}
+
+static constexpr size_t DocumentsCount = 1000000;
+static constexpr size_t QueriedCount = DocumentsCount / 50;
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  Collection data{};
+  for (size_t i = 0; i < DocumentsCount; ++i) {
+    data.documents.push_back(
+      Document{ i,
+                eastl::string(i % 40, 'a'),
+                eastl::vector<uint32_t>(i % 5, static_cast<uint32_t>(i)) });
+  }
+  Buffer plain{};
+  const auto plainSize = bitsery::quickSerialization(Writer{ plain }, data);
+  IndexedCollection<eastl::vector<Document>> indexed{ data.documents };
+  Buffer withTable{};
+  const auto withTableSize =
+    bitsery::quickSerialization(Writer{ withTable }, indexed);
+
+  bench::report("container, deserialize all", QueriedCount,
+                bench::bestOf(repeat, [&] {
+                  Collection res{};
+                  bitsery::quickDeserialization(
+                    Reader{ plain.begin(), plainSize }, res);
+                  uint64_t sum = 0;
+                  for (size_t i = 0; i < QueriedCount; ++i)
+                    sum += res.documents[(i * 7919) % DocumentsCount].id;
+                  bench::doNotOptimize(sum);
+                }));
+  bench::report("lazy view, deserialize queried", QueriedCount,
+                bench::bestOf(repeat, [&] {
+                  IndexedCollection<bitsery::ext::LazyContainerView<Document>>
+                    res{};
+                  bitsery::quickDeserialization(
+                    Reader{ withTable.begin(), withTableSize }, res);
+                  uint64_t sum = 0;
+                  Document doc{};
+                  for (size_t i = 0; i < QueriedCount; ++i) {
+                    res.documents.get((i * 7919) % DocumentsCount, doc);
+                    sum += doc.id;
+                  }
+                  bench::doNotOptimize(sum);
+                }));
+}
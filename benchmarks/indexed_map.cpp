@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// lookups of 1000 keys in map of 500K entries: deserializing whole map with
+// EastlMap compared with LazyMapView, that searches serialized keys in place
+// and deserializes only matching values, in sorted and Eytzinger layouts.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/eastl_map.h>
+#include <bitsery/ext/indexed_map.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/map.h>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::OutputBufferAdapter<Buffer>;
+using Reader = bitsery::InputBufferAdapter<Buffer>;
+
+struct Document
+{
+  uint64_t id{};
+  eastl::string title{};
+  eastl::vector<uint32_t> tags{};
+};
+
+template<typename S>
+void
+serialize(S& s, Document& o)
+{
+  s.value8b(o.id);
+  s.text1b(o.title, 256);
+  s.container4b(o.tags, 64);
+}
+
+using Documents = eastl::map<uint64_t, Document>;
+using DocumentsView = bitsery::ext::LazyMapView<uint64_t, Document>;
+
+struct Collection
+{
+  Documents documents{};
+};
+
+template<typename S>
+void
+serialize(S& s, Collection& o)
+{
+  s.ext(o.documents,
+        bitsery::ext::EastlMap{ 1u << 24 },
+        [](S& s, uint64_t& key, Document& doc) {
+          s.value8b(key);
+          s.object(doc);
+        });
+}
+
+// the same collection with key block, documents are either Documents or
+// DocumentsView
+template<typename TDocuments>
+struct IndexedCollection
+{
+  TDocuments documents{};
+  bitsery::ext::MapKeyLayout layout{ bitsery::ext::MapKeyLayout::Sorted };
+};
+
+template<typename S, typename TDocuments>
+void
+serialize(S& s, IndexedCollection<TDocuments>& o)
+{
+  s.ext(o.documents, bitsery::ext::IndexedMap{ 1u << 24, o.layout });
+}
+
+static constexpr size_t DocumentsCount = 500000;
+static constexpr size_t QueriedCount = 1000;
+
+static uint64_t
+queriedKey(size_t i)
+{
+  // every second key is missing
+  return ((i * 7919) % DocumentsCount) * 2 + (i % 2);
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  Collection data{};
+  for (size_t i = 0; i < DocumentsCount; ++i) {
+    data.documents.emplace(
+      i * 2,
+      Document{ i,
+                eastl::string(i % 40, 'a'),
+                eastl::vector<uint32_t>(i % 5, static_cast<uint32_t>(i)) });
+  }
+  Buffer plain{};
+  const auto plainSize = bitsery::quickSerialization(Writer{ plain }, data);
+
+  bench::report("eastl map, deserialize all", QueriedCount,
+                bench::bestOf(repeat, [&] {
+                  Collection res{};
+                  bitsery::quickDeserialization(
+                    Reader{ plain.begin(), plainSize }, res);
+                  uint64_t sum = 0;
+                  for (size_t i = 0; i < QueriedCount; ++i) {
+                    auto it = res.documents.find(queriedKey(i));
+                    if (it != res.documents.end())
+                      sum += it->second.id;
+                  }
+                  bench::doNotOptimize(sum);
+                }));
+
+  for (auto layout : { bitsery::ext::MapKeyLayout::Sorted,
+                       bitsery::ext::MapKeyLayout::Eytzinger }) {
+    IndexedCollection<Documents> indexed{ data.documents, layout };
+    Buffer withKeys{};
+    const auto withKeysSize =
+      bitsery::quickSerialization(Writer{ withKeys }, indexed);
+    const char* name = layout == bitsery::ext::MapKeyLayout::Sorted
+                         ? "lazy map view, sorted keys"
+                         : "lazy map view, eytzinger keys";
+    bench::report(name, QueriedCount, bench::bestOf(repeat, [&] {
+                    IndexedCollection<DocumentsView> res{};
+                    bitsery::quickDeserialization(
+                      Reader{ withKeys.begin(), withKeysSize }, res);
+                    uint64_t sum = 0;
+                    Document doc{};
+                    for (size_t i = 0; i < QueriedCount; ++i) {
+                      if (res.documents.get(queriedKey(i), doc))
+                        sum += doc.id;
+                    }
+                    bench::doNotOptimize(sum);
+                  }));
+  }
+}
@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// measures ParallelContainer scaling for 5M entities with 1 to 32 threads, for
+// both serialization and deserialization, sequential container is baseline.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/parallel_container.h>
+#include <bitsery/ext/utils/executor.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdio>
+
+using Buffer = eastl::vector<uint8_t>;
+using Writer = bitsery::OutputBufferAdapter<Buffer>;
+using Reader = bitsery::InputBufferAdapter<Buffer>;
+
+struct Entity
+{
+  uint32_t id{};
+  float position[3]{};
+  float velocity[3]{};
+  uint16_t flags{};
+};
+
+template<typename S>
+void
+serialize(S& s, Entity& o)
+{
+  s.value4b(o.id);
+  s.container4b(o.position);
+  s.container4b(o.velocity);
+  s.value2b(o.flags);
+}
+
+static constexpr size_t EntitiesCount = 5000000;
+static constexpr size_t ChunkSize = 16 * 1024;
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  eastl::vector<Entity> data(EntitiesCount);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i].id = static_cast<uint32_t>(i);
+    data[i].flags = static_cast<uint16_t>(i);
+  }
+  Buffer buf{};
+  eastl::vector<Entity> res{};
+
+  size_t written = 0;
+  bench::report("sequential serialize", EntitiesCount,
+                bench::bestOf(repeat, [&] {
+                  bitsery::Serializer<Writer> ser{ buf };
+                  ser.container(data, EntitiesCount);
+                  ser.adapter().flush();
+                  written = ser.adapter().writtenBytesCount();
+                  bench::doNotOptimize(buf.data()[written - 1]);
+                }));
+  bench::report("sequential deserialize", EntitiesCount,
+                bench::bestOf(repeat, [&] {
+                  bitsery::Deserializer<Reader> des{ buf.begin(), written };
+                  des.container(res, EntitiesCount);
+                  bench::doNotOptimize(res.back().id);
+                }));
+
+  for (size_t threads = 1; threads <= 32; threads *= 2) {
+    bitsery::ext::ThreadPoolExecutor pool{ threads };
+    char name[64];
+    std::snprintf(name, sizeof(name), "parallel serialize, %zu threads",
+                  threads);
+    bench::report(name, EntitiesCount, bench::bestOf(repeat, [&] {
+                    bitsery::Serializer<Writer> ser{ buf };
+                    ser.ext(data,
+                            bitsery::ext::ParallelContainer{
+                              pool, EntitiesCount, ChunkSize });
+                    ser.adapter().flush();
+                    written = ser.adapter().writtenBytesCount();
+                    bench::doNotOptimize(buf.data()[written - 1]);
+                  }));
+    std::snprintf(name, sizeof(name), "parallel deserialize, %zu threads",
+                  threads);
+    bench::report(name, EntitiesCount, bench::bestOf(repeat, [&] {
+                    bitsery::Deserializer<Reader> des{ buf.begin(), written };
+                    des.ext(res,
+                            bitsery::ext::ParallelContainer{
+                              pool, EntitiesCount, ChunkSize });
+                    bench::doNotOptimize(res.back().id);
+                  }));
+  }
+}
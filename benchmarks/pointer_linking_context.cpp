@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// compares pointer linking context used during serialization:
+// node based hash map (PointerLinkingContextSerialization) vs flat
+// open-addressing table (PointerLinkingContextSerializationDense).
+// every pointer is looked up twice: first as owner (insert), then as observer.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/ext/utils/pointer_utils.h>
+
+#include <EASTL/vector.h>
+
+using bitsery::ext::MemResourceBase;
+using bitsery::ext::PointerOwnershipType;
+using bitsery::ext::pointer_utils::PointerLinkingContextSerialization;
+using bitsery::ext::pointer_utils::PointerLinkingContextSerializationDense;
+
+// simple bump allocator, memory is released all at once on destruction
+class ArenaResource final : public MemResourceBase
+{
+public:
+  explicit ArenaResource(size_t capacity)
+    : _begin{ static_cast<uint8_t*>(::operator new(capacity)) }
+    , _pos{ 0 }
+    , _capacity{ capacity }
+  {
+  }
+
+  ArenaResource(const ArenaResource&) = delete;
+  ArenaResource& operator=(const ArenaResource&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment, size_t /*typeId*/) override
+  {
+    auto pos = (_pos + alignment - 1) & ~(alignment - 1);
+    if (pos + bytes > _capacity)
+      return ::operator new(bytes);
+    _pos = pos + bytes;
+    return _begin + pos;
+  }
+
+  void deallocate(void* ptr,
+                  size_t /*bytes*/,
+                  size_t /*alignment*/,
+                  size_t /*typeId*/) noexcept override
+  {
+    auto p = static_cast<uint8_t*>(ptr);
+    if (p < _begin || p >= _begin + _capacity)
+      ::operator delete(ptr);
+  }
+
+  ~ArenaResource() noexcept override { ::operator delete(_begin); }
+
+private:
+  uint8_t* _begin;
+  size_t _pos;
+  size_t _capacity;
+};
+
+// bytes of all tables that dense context allocates for `count` pointers: last
+// table has at least 2 * count slots (starting from 64), and capacity doubles,
+// so all previous tables together are smaller than the last one
+size_t
+denseTablesBytes(size_t count)
+{
+  // slot is pointer, generation and PLCInfoSerializer
+  const size_t slotSize =
+    sizeof(void*) + sizeof(size_t) +
+    sizeof(bitsery::ext::pointer_utils::PLCInfoSerializer);
+  size_t slots = 64;
+  while (slots < count * 2)
+    slots *= 2;
+  return slots * 2 * slotSize;
+}
+
+// arena case is skipped for larger counts, it would need gigabytes of memory
+static constexpr size_t MaxArenaCount = 1000000;
+
+template<typename TContext>
+size_t
+linkAll(TContext& ctx, const eastl::vector<const void*>& ptrs)
+{
+  size_t sum = 0;
+  for (auto p : ptrs)
+    sum += ctx.getInfoByPtr(p, PointerOwnershipType::Owner).id;
+  for (auto p : ptrs)
+    sum += ctx.getInfoByPtr(p, PointerOwnershipType::Observer).id;
+  return sum;
+}
+
+void
+run(size_t count, size_t repeat)
+{
+  eastl::vector<int64_t> objects(count);
+  eastl::vector<const void*> ptrs{};
+  ptrs.reserve(count);
+  // visit objects in scattered order, like a graph traversal would
+  const size_t step = 7919;
+  for (size_t i = 0; i < count; ++i)
+    ptrs.push_back(&objects[(i * step) % count]);
+
+  char name[64];
+  const auto items = count * 2;
+
+  std::snprintf(name, sizeof(name), "map, new context [%zu]", count);
+  bench::report(name, items, bench::bestOf(repeat, [&] {
+                  PointerLinkingContextSerialization ctx{};
+                  bench::doNotOptimize(linkAll(ctx, ptrs));
+                }));
+
+  std::snprintf(name, sizeof(name), "dense, new context [%zu]", count);
+  bench::report(name, items, bench::bestOf(repeat, [&] {
+                  PointerLinkingContextSerializationDense ctx{};
+                  bench::doNotOptimize(linkAll(ctx, ptrs));
+                }));
+
+  if (count <= MaxArenaCount) {
+    std::snprintf(name, sizeof(name), "dense, arena [%zu]", count);
+    bench::report(name, items, bench::bestOf(repeat, [&] {
+                    // enough for all rehashes on the way
+                    ArenaResource arena{ denseTablesBytes(count) };
+                    PointerLinkingContextSerializationDense ctx{ &arena };
+                    bench::doNotOptimize(linkAll(ctx, ptrs));
+                  }));
+  }
+
+  {
+    PointerLinkingContextSerializationDense ctx{};
+    ctx.reserve(count);
+    std::snprintf(name, sizeof(name), "dense, reused after clear [%zu]", count);
+    bench::report(name, items, bench::bestOf(repeat, [&] {
+                    ctx.clear();
+                    bench::doNotOptimize(linkAll(ctx, ptrs));
+                  }));
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  for (auto count : { size_t{ 1000 }, size_t{ 100000 }, size_t{ 10000000 } })
+    run(count, count >= 10000000 ? 1 : repeat);
+}
@@ -0,0 +1,236 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// multi-threaded (de)serialization of eastl::shared_ptr<Shape> with single
+// polymorphic context shared between all threads.
+// shared PolymorphicContext copies reference counted handlers to shared_ptr
+// deleters, so counters bounce between cores, FrozenPolymorphicContext
+// handlers are not reference counted.
+// usage: bitsery.benchmark.polymorphic_context_threads [repeat] [max threads]
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/traits/vector.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using bitsery::ext::BaseClass;
+
+struct Shape
+{
+  uint32_t id{};
+
+  virtual ~Shape() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Shape& o)
+{
+  s.value4b(o.id);
+}
+
+struct Circle : Shape
+{
+  float r{};
+};
+
+template<typename S>
+void
+serialize(S& s, Circle& o)
+{
+  s.ext(o, BaseClass<Shape>{});
+  s.value4b(o.r);
+}
+
+struct Rect : Shape
+{
+  float w{};
+  float h{};
+};
+
+template<typename S>
+void
+serialize(S& s, Rect& o)
+{
+  s.ext(o, BaseClass<Shape>{});
+  s.value4b(o.w);
+  s.value4b(o.h);
+}
+
+namespace bitsery {
+namespace ext {
+
+template<>
+struct PolymorphicBaseClass<Shape> : PolymorphicDerivedClasses<Circle, Rect>
+{
+};
+
+}
+}
+
+using Buffer = eastl::vector<uint8_t>;
+using Shapes = eastl::vector<eastl::shared_ptr<Shape>>;
+
+template<typename TPolyContext>
+using TContext =
+  eastl::tuple<bitsery::ext::PointerLinkingContext, TPolyContext&>;
+
+template<typename TPolyContext>
+using Writer = bitsery::Serializer<bitsery::OutputBufferAdapter<Buffer>,
+                                   TContext<TPolyContext>>;
+
+template<typename TPolyContext>
+using Reader = bitsery::Deserializer<bitsery::InputBufferAdapter<Buffer>,
+                                     TContext<TPolyContext>>;
+
+static constexpr size_t ItemsPerThread = 200000;
+
+Shapes
+createShapes()
+{
+  Shapes res{};
+  res.reserve(ItemsPerThread);
+  for (size_t i = 0; i < ItemsPerThread; ++i) {
+    eastl::shared_ptr<Shape> s{};
+    if (i % 2)
+      s.reset(new Circle{});
+    else
+      s.reset(new Rect{});
+    s->id = static_cast<uint32_t>(i);
+    res.push_back(s);
+  }
+  return res;
+}
+
+// single thread work: serialize and deserialize all shapes
+template<typename TPolyContext>
+void
+roundTrip(const Shapes& data,
+          Buffer& buf,
+          Shapes& res,
+          TPolyContext& serPc,
+          TPolyContext& desPc)
+{
+  size_t written = 0;
+  {
+    TContext<TPolyContext> ctx{ bitsery::ext::PointerLinkingContext{},
+                                serPc };
+    Writer<TPolyContext> ser{ ctx, buf };
+    ser.container(
+      data,
+      data.size(),
+      [](Writer<TPolyContext>& s, const eastl::shared_ptr<Shape>& v) {
+        s.ext(v, bitsery::ext::EastlSmartPtr{});
+      });
+    ser.adapter().flush();
+    written = ser.adapter().writtenBytesCount();
+  }
+  TContext<TPolyContext> ctx{ bitsery::ext::PointerLinkingContext{}, desPc };
+  Reader<TPolyContext> des{ ctx, buf.begin(), written };
+  res.clear();
+  des.container(res,
+                data.size(),
+                [](Reader<TPolyContext>& d, eastl::shared_ptr<Shape>& v) {
+                  d.ext(v, bitsery::ext::EastlSmartPtr{});
+                });
+  eastl::get<0>(ctx).clearSharedState();
+  bench::doNotOptimize(res.size());
+}
+
+template<typename TPolyContext>
+void
+run(const char* name,
+    size_t repeat,
+    size_t maxThreads,
+    TPolyContext& serPc,
+    TPolyContext& desPc)
+{
+  const auto data = createShapes();
+  double singleThreadNs = 0;
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    std::vector<Buffer> bufs(threads);
+    std::vector<Shapes> results(threads);
+    auto ns = bench::bestOf(repeat, [&] {
+      std::atomic<size_t> ready{ 0 };
+      std::vector<std::thread> workers{};
+      for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+          ++ready;
+          while (ready.load() != threads) {
+          }
+          roundTrip(data, bufs[t], results[t], serPc, desPc);
+        });
+      }
+      for (auto& w : workers)
+        w.join();
+    });
+    if (threads == 1)
+      singleThreadNs = ns;
+    char fullName[64];
+    std::snprintf(fullName, sizeof(fullName), "%s, %zu threads", name, threads);
+    bench::report(fullName, ItemsPerThread * threads, ns);
+    // ideal scaling keeps wall time constant while threads are added
+    std::printf("%-48s %12.2fx of linear scaling\n", "", singleThreadNs / ns);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  size_t maxThreads = std::thread::hardware_concurrency();
+  if (argc > 2)
+    maxThreads = std::strtoul(argv[2], nullptr, 10);
+  if (maxThreads == 0)
+    maxThreads = 1;
+
+  {
+    using TPc = bitsery::ext::PolymorphicContext<bitsery::ext::StandardRTTI>;
+    TPc serPc{};
+    serPc.registerBasesList<Writer<TPc>>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    TPc desPc{};
+    desPc.registerBasesList<Reader<TPc>>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    run("shared PolymorphicContext", repeat, maxThreads, serPc, desPc);
+  }
+  {
+    using TPc =
+      bitsery::ext::FrozenPolymorphicContext<bitsery::ext::StandardRTTI>;
+    TPc serPc{};
+    serPc.registerBasesList<Writer<TPc>>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    serPc.freeze();
+    TPc desPc{};
+    desPc.registerBasesList<Reader<TPc>>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    desPc.freeze();
+    run("FrozenPolymorphicContext", repeat, maxThreads, serPc, desPc);
+  }
+}
@@ -0,0 +1,230 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// serializes vector of polymorphic components (unique_ptr<Component>) using
+// runtime PolymorphicContext, compile time StaticPolymorphicContext and
+// ClosedPolymorphic extension (requires c++14).
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/closed_polymorphic.h>
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/traits/vector.h>
+
+using bitsery::ext::BaseClass;
+
+struct Component
+{
+  uint32_t entity{};
+
+  virtual ~Component() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Component& o)
+{
+  s.value4b(o.entity);
+}
+
+struct Position : Component
+{
+  float x{};
+  float y{};
+  float z{};
+};
+
+template<typename S>
+void
+serialize(S& s, Position& o)
+{
+  s.ext(o, BaseClass<Component>{});
+  s.value4b(o.x);
+  s.value4b(o.y);
+  s.value4b(o.z);
+}
+
+struct Velocity : Component
+{
+  float dx{};
+  float dy{};
+};
+
+template<typename S>
+void
+serialize(S& s, Velocity& o)
+{
+  s.ext(o, BaseClass<Component>{});
+  s.value4b(o.dx);
+  s.value4b(o.dy);
+}
+
+struct Health : Component
+{
+  uint16_t hp{};
+};
+
+template<typename S>
+void
+serialize(S& s, Health& o)
+{
+  s.ext(o, BaseClass<Component>{});
+  s.value2b(o.hp);
+}
+
+namespace bitsery {
+namespace ext {
+
+template<>
+struct PolymorphicBaseClass<Component>
+  : PolymorphicDerivedClasses<Position, Velocity, Health>
+{
+};
+
+}
+}
+
+using Buffer = eastl::vector<uint8_t>;
+using Components = eastl::vector<eastl::unique_ptr<Component>>;
+
+template<typename TContext>
+using Writer =
+  bitsery::Serializer<bitsery::OutputBufferAdapter<Buffer>, TContext>;
+
+template<typename TContext>
+using Reader =
+  bitsery::Deserializer<bitsery::InputBufferAdapter<Buffer>, TContext>;
+
+Components
+createComponents(size_t count)
+{
+  Components res{};
+  res.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    Component* c = nullptr;
+    switch (i % 3) {
+      case 0:
+        c = new Position{};
+        break;
+      case 1:
+        c = new Velocity{};
+        break;
+      default:
+        c = new Health{};
+    }
+    c->entity = static_cast<uint32_t>(i);
+    res.emplace_back(c);
+  }
+  return res;
+}
+
+template<typename TExt, typename TContext, typename TPrepare>
+void
+run(const char* name,
+    const Components& data,
+    size_t repeat,
+    TContext& ctx,
+    TPrepare&& prepare)
+{
+  Buffer buf{};
+  size_t written = 0;
+  char fullName[64];
+  std::snprintf(fullName, sizeof(fullName), "%s, serialize", name);
+  bench::report(fullName, data.size(), bench::bestOf(repeat, [&] {
+                  Writer<TContext> ser{ ctx, buf };
+                  prepare(ser);
+                  ser.container(data,
+                                data.size(),
+                                [](decltype(ser)& s,
+                                   const eastl::unique_ptr<Component>& c) {
+                                  s.ext(c, TExt{});
+                                });
+                  ser.adapter().flush();
+                  written = ser.adapter().writtenBytesCount();
+                }));
+
+  Components res{};
+  std::snprintf(fullName, sizeof(fullName), "%s, deserialize", name);
+  bench::report(fullName, data.size(), bench::bestOf(repeat, [&] {
+                  res.clear();
+                  Reader<TContext> des{ ctx, buf.begin(), written };
+                  prepare(des);
+                  des.container(
+                    res,
+                    data.size(),
+                    [](decltype(des)& d, eastl::unique_ptr<Component>& c) {
+                      d.ext(c, TExt{});
+                    });
+                  bench::doNotOptimize(res.size());
+                }));
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  const auto data = createComponents(1000000);
+
+  {
+    using TContext = eastl::tuple<bitsery::ext::PointerLinkingContext,
+                                  bitsery::ext::PolymorphicContext<
+                                    bitsery::ext::StandardRTTI>>;
+    TContext ctx{};
+    run<bitsery::ext::EastlSmartPtr>(
+      "PolymorphicContext", data, repeat, ctx, [&ctx](auto& s) {
+        using S = typename eastl::decay<decltype(s)>::type;
+        eastl::get<0>(ctx) = bitsery::ext::PointerLinkingContext{};
+        auto& pc = eastl::get<1>(ctx);
+        pc.clear();
+        pc.template registerBasesList<S>(
+          bitsery::ext::PolymorphicClassesList<Component>{});
+      });
+  }
+  {
+    using TContext = eastl::tuple<bitsery::ext::PointerLinkingContext,
+                                  bitsery::ext::StaticPolymorphicContext<
+                                    bitsery::ext::StandardRTTI>>;
+    TContext ctx{};
+    run<bitsery::ext::EastlSmartPtr>(
+      "StaticPolymorphicContext", data, repeat, ctx, [&ctx](auto&) {
+        eastl::get<0>(ctx) = bitsery::ext::PointerLinkingContext{};
+      });
+  }
+  {
+    using TContext =
+      eastl::tuple<bitsery::ext::StaticPolymorphicContext<
+        bitsery::ext::StandardRTTI>>;
+    TContext ctx{};
+    run<bitsery::ext::UntrackedEastlSmartPtr>(
+      "StaticPolymorphicContext, untracked", data, repeat, ctx, [](auto&) {});
+  }
+  {
+    // doesn't require any context
+    eastl::tuple<> ctx{};
+    run<bitsery::ext::
+          ClosedPolymorphic<Component, Position, Velocity, Health>>(
+      "ClosedPolymorphic", data, repeat, ctx, [](auto&) {});
+  }
+}
@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// appends 64B records: write + fdatasync for each record compared with
+// RecordLogWriter, where records are committed in groups by background thread,
+// both from single thread and from several threads that wait for each record
+// to become durable.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/ext/utils/record_log.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdio>
+#include <thread>
+
+#if BITSERY_HAS_MMAP
+
+struct Record
+{
+  uint64_t id{};
+  eastl::vector<uint8_t> payload{};
+};
+
+template<typename S>
+void
+serialize(S& s, Record& o)
+{
+  s.value8b(o.id);
+  s.container1b(o.payload, 1024);
+}
+
+static constexpr size_t RecordsCount = 20000;
+
+static void
+removeDirectory(const char* path)
+{
+  if (auto dir = ::opendir(path)) {
+    while (auto entry = ::readdir(dir)) {
+      if (entry->d_name[0] != '.')
+        ::unlink((eastl::string{ path } + "/" + entry->d_name).c_str());
+    }
+    ::closedir(dir);
+  }
+  ::rmdir(path);
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  const char* path = "bitsery_record_log_benchmark";
+  const Record record{ 1, eastl::vector<uint8_t>(55, 7) };
+
+  bench::report("write + fdatasync each record", RecordsCount,
+                bench::bestOf(repeat, [&] {
+                  removeDirectory(path);
+                  ::mkdir(path, 0755);
+                  const auto file = eastl::string{ path } + "/records.log";
+                  const int fd =
+                    ::open(file.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+                  eastl::vector<uint8_t> buf{};
+                  for (size_t i = 0; i < RecordsCount; ++i) {
+                    bitsery::ext::serializeExact(buf, record);
+                    bitsery::ext::record_log_details::writeAll(
+                      fd, buf.data(), buf.size());
+                    bitsery::ext::record_log_details::syncFile(fd);
+                  }
+                  ::close(fd);
+                }));
+
+  bench::report("record log, wait for last record", RecordsCount,
+                bench::bestOf(repeat, [&] {
+                  removeDirectory(path);
+                  bitsery::ext::RecordLogWriter<> writer{ path };
+                  uint64_t last{};
+                  for (size_t i = 0; i < RecordsCount; ++i)
+                    last = writer.append(record);
+                  writer.waitDurable(last);
+                }));
+
+  for (size_t threadsCount = 1; threadsCount <= 16; threadsCount *= 4) {
+    char name[64];
+    std::snprintf(name,
+                  sizeof(name),
+                  "record log, wait each record, %zu threads",
+                  threadsCount);
+    bench::report(name, RecordsCount, bench::bestOf(repeat, [&] {
+                    removeDirectory(path);
+                    bitsery::ext::RecordLogWriter<> writer{ path };
+                    eastl::vector<std::thread> threads{};
+                    for (size_t t = 0; t < threadsCount; ++t) {
+                      threads.push_back(std::thread{ [&]() {
+                        for (size_t i = 0; i < RecordsCount / threadsCount; ++i)
+                          writer.waitDurable(writer.append(record));
+                      } });
+                    }
+                    for (auto& thread : threads)
+                      thread.join();
+                  }));
+  }
+  removeDirectory(path);
+}
+
+#else
+
+int
+main()
+{
+  std::printf("record log requires POSIX file api\n");
+}
+
+#endif
@@ -0,0 +1,102 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// encodes batch of 10k messages with very different sizes into one buffer:
+// sequential serializeExact for each message (copied into batch buffer)
+// compared with serializeBatch on SequentialExecutor and ThreadPoolExecutor.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/utils/executor.h>
+#include <bitsery/ext/utils/serialize_batch.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdio>
+#include <cstring>
+
+using Buffer = eastl::vector<uint8_t>;
+
+struct Message
+{
+  uint64_t id{};
+  eastl::vector<float> values{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.value8b(o.id);
+  s.container4b(o.values, 1u << 20);
+}
+
+static constexpr size_t MessagesCount = 10000;
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  eastl::vector<Message> messages(MessagesCount);
+  uint32_t seed = 1;
+  for (size_t i = 0; i < messages.size(); ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    // mostly small messages with few big ones
+    const auto size = (seed >> 8) % 100 == 0 ? 16384 : (seed >> 8) % 64;
+    messages[i].id = i;
+    messages[i].values.resize(size);
+  }
+
+  Buffer batch{};
+  Buffer single{};
+  bench::report("serializeExact each message", MessagesCount,
+                bench::bestOf(repeat, [&] {
+                  batch.clear();
+                  for (auto& msg : messages) {
+                    auto size = bitsery::ext::serializeExact(single, msg);
+                    auto pos = batch.size();
+                    batch.resize(pos + size);
+                    std::memcpy(batch.data() + pos, single.data(), size);
+                  }
+                  bench::doNotOptimize(batch.back());
+                }));
+
+  bitsery::ext::SequentialExecutor seq{};
+  bench::report("serializeBatch, sequential", MessagesCount,
+                bench::bestOf(repeat, [&] {
+                  auto size =
+                    bitsery::ext::serializeBatch(seq, batch, messages);
+                  bench::doNotOptimize(batch.data()[size - 1]);
+                }));
+  for (size_t threads = 1; threads <= 32; threads *= 2) {
+    bitsery::ext::ThreadPoolExecutor pool{ threads };
+    char name[64];
+    std::snprintf(name, sizeof(name), "serializeBatch, %zu threads", threads);
+    bench::report(name, MessagesCount, bench::bestOf(repeat, [&] {
+                    auto size =
+                      bitsery::ext::serializeBatch(pool, batch, messages);
+                    bench::doNotOptimize(batch.data()[size - 1]);
+                  }));
+  }
+}
@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// compares serializeExact (measure pass, single allocation, unchecked writes)
+// with OutputBufferAdapter that grows buffer while writing, for message sizes
+// from 64B to 64MB, both into fresh and into reused buffer.
+
+#include "benchmark_utils.h"
+
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/ext/utils/serialize_exact.h>
+#include <bitsery/traits/vector.h>
+
+#include <EASTL/vector.h>
+
+#include <cstdio>
+
+using Buffer = eastl::vector<uint8_t>;
+
+struct Point
+{
+  float x{};
+  float y{};
+  float z{};
+};
+
+template<typename S>
+void
+serialize(S& s, Point& o)
+{
+  s.value4b(o.x);
+  s.value4b(o.y);
+  s.value4b(o.z);
+}
+
+struct Message
+{
+  uint32_t id{};
+  eastl::vector<Point> points{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.value4b(o.id);
+  s.container(o.points, 1u << 30);
+}
+
+static constexpr size_t TotalBytes = 64 * 1024 * 1024;
+
+template<typename Fnc>
+void
+run(const char* name, size_t messageSize, size_t count, size_t repeat, Fnc fnc)
+{
+  char fullName[64];
+  std::snprintf(fullName, sizeof(fullName), "%s, %zuB", name, messageSize);
+  bench::report(fullName, count, bench::bestOf(repeat, [&] {
+                  for (size_t i = 0; i < count; ++i)
+                    fnc();
+                }));
+}
+
+int
+main(int argc, char** argv)
+{
+  const auto repeat = bench::repeatCount(argc, argv);
+  for (size_t size = 64; size <= TotalBytes; size *= 4) {
+    Message msg{ 1, eastl::vector<Point>(size / sizeof(Point)) };
+    const auto count = TotalBytes / size;
+    Buffer reused{};
+
+    run("growth, fresh buffer", size, count, repeat, [&] {
+      Buffer buf{};
+      auto written = bitsery::quickSerialization(
+        bitsery::OutputBufferAdapter<Buffer>{ buf }, msg);
+      bench::doNotOptimize(buf.data()[written - 1]);
+    });
+    run("exact, fresh buffer", size, count, repeat, [&] {
+      Buffer buf{};
+      auto written = bitsery::ext::serializeExact(buf, msg);
+      bench::doNotOptimize(buf.data()[written - 1]);
+    });
+    run("growth, reused buffer", size, count, repeat, [&] {
+      auto written = bitsery::quickSerialization(
+        bitsery::OutputBufferAdapter<Buffer>{ reused }, msg);
+      bench::doNotOptimize(reused.data()[written - 1]);
+    });
+    run("exact, reused buffer", size, count, repeat, [&] {
+      auto written = bitsery::ext::serializeExact(reused, msg);
+      bench::doNotOptimize(reused.data()[written - 1]);
+    });
+  }
+}
@@ -26,6 +26,7 @@
 #include "../bitsery.h"
 #include "../details/adapter_bit_packing.h"
 #include "../traits/core/traits.h"
+#include "growth_policy.h"
 #include <EASTL/algorithm.h>
 #include <cassert>
 #include <cstring>
@@ -127,9 +128,37 @@ public:
 
   bool isCompletedSuccessfully() const { return _currOffset == _bufferSize; }
 
+  // skips `size` bytes and returns iterator to the first one, so that they can
+  // be read without copying, e.g. by another adapter.
+  // if there is not enough data, DataOverflow error is set.
+  TIterator skipBytes(size_t size)
+  {
+    return skipBytesImpl(
+      size, eastl::integral_constant<bool, Config::CheckAdapterErrors>{});
+  }
+
 private:
   using diff_t = typename eastl::iterator_traits<TIterator>::difference_type;
 
+  TIterator skipBytesImpl(size_t size, eastl::false_type)
+  {
+    assert(_currOffset + size <= _endReadOffset);
+    const auto it = _beginIt + static_cast<diff_t>(_currOffset);
+    _currOffset += size;
+    return it;
+  }
+
+  TIterator skipBytesImpl(size_t size, eastl::true_type)
+  {
+    if (_currOffset > _endReadOffset || size > _endReadOffset - _currOffset) {
+      error(ReaderError::DataOverflow);
+      return _beginIt;
+    }
+    const auto it = _beginIt + static_cast<diff_t>(_currOffset);
+    _currOffset += size;
+    return it;
+  }
+
   template<size_t SIZE>
   void readInternalValue(TValue* data)
   {
@@ -190,16 +219,38 @@ private:
   bool _overflowOnReadEndPos = true;
 };
 
-template<typename Buffer, typename Config = DefaultConfig>
+namespace details {
+template<typename T>
+struct HasGrowBufferHelper
+{
+  template<typename Q,
+           typename = decltype(traits::BufferAdapterTraits<Q>::growBuffer(
+             eastl::declval<Q&>(),
+             size_t{}))>
+  static eastl::true_type tester(Q*);
+  template<typename Q>
+  static eastl::false_type tester(...);
+  using type = decltype(tester<T>(nullptr));
+};
+}
+
+// Growth policy is only used for resizable buffers, whose BufferAdapterTraits
+// defines growBuffer, otherwise increaseBufferSize is called
+template<typename Buffer,
+         typename Config = DefaultConfig,
+         typename Growth = GrowthGeometric>
 class OutputBufferAdapter
-  : public details::OutputAdapterBaseCRTP<OutputBufferAdapter<Buffer, Config>>
+  : public details::OutputAdapterBaseCRTP<
+      OutputBufferAdapter<Buffer, Config, Growth>>
 {
 public:
-  friend details::OutputAdapterBaseCRTP<OutputBufferAdapter<Buffer, Config>>;
+  friend details::OutputAdapterBaseCRTP<
+    OutputBufferAdapter<Buffer, Config, Growth>>;
 
   using BitPackingEnabled = details::OutputAdapterBitPackingWrapper<
-    OutputBufferAdapter<Buffer, Config>>;
+    OutputBufferAdapter<Buffer, Config, Growth>>;
   using TConfig = Config;
+  using TGrowth = Growth;
   using TIterator = typename traits::BufferAdapterTraits<Buffer>::TIterator;
   using TValue = typename traits::BufferAdapterTraits<Buffer>::TValue;
 
@@ -292,11 +343,23 @@ private:
 
   BITSERY_NOINLINE void doResize(size_t newOffset)
   {
-    traits::BufferAdapterTraits<Buffer>::increaseBufferSize(
-      *_buffer, _currOffset, newOffset);
+    increaseBufferSize(newOffset,
+                       typename details::HasGrowBufferHelper<Buffer>::type{});
     _beginIt = eastl::begin(*_buffer);
     _bufferSize = traits::ContainerTraits<Buffer>::size(*_buffer);
   }
+
+  void increaseBufferSize(size_t newOffset, eastl::true_type)
+  {
+    traits::BufferAdapterTraits<Buffer>::growBuffer(
+      *_buffer, Growth::newSize(_bufferSize, newOffset));
+  }
+
+  void increaseBufferSize(size_t newOffset, eastl::false_type)
+  {
+    traits::BufferAdapterTraits<Buffer>::increaseBufferSize(
+      *_buffer, _currOffset, newOffset);
+  }
 };
 
 }
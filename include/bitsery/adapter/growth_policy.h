@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_ADAPTER_GROWTH_POLICY_H
+#define BITSERY_ADAPTER_GROWTH_POLICY_H
+
+#include <cstddef>
+
+namespace bitsery {
+
+/*
+ * growth policies for resizable output buffers.
+ * newSize is called only when buffer is too small, and returns new buffer size
+ * that is at least minSize.
+ */
+
+// grows 1.5x + 128 bytes, rounded to cache line size, so that small buffers
+// skip 2/4/8/16... byte allocations
+struct GrowthGeometric
+{
+  static size_t newSize(size_t size, size_t minSize)
+  {
+    auto res = static_cast<size_t>(static_cast<double>(size) * 1.5) + 128;
+    res -= res % 64;
+    return res > minSize ? res : minSize;
+  }
+};
+
+// grows to smallest power of two, that fits minSize
+struct GrowthPowerOfTwo
+{
+  static size_t newSize(size_t /*size*/, size_t minSize)
+  {
+    size_t res = 64;
+    while (res < minSize)
+      res <<= 1;
+    return res;
+  }
+};
+
+// rounds size, returned by Base policy, up to multiple of Alignment
+template<size_t Alignment, typename Base = GrowthGeometric>
+struct GrowthAligned
+{
+  static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                "Alignment must be power of two");
+
+  static size_t newSize(size_t size, size_t minSize)
+  {
+    const auto res = Base::newSize(size, minSize);
+    return (res + Alignment - 1) & ~(Alignment - 1);
+  }
+};
+
+// whole pages, so allocator can hand out page aligned blocks without waste
+using GrowthPageAligned = GrowthAligned<4096>;
+
+// same as Base policy for small buffers, but once buffer reaches Threshold it
+// grows in whole huge pages (2MB by default), so that big outputs can be backed
+// by transparent huge pages
+template<size_t Threshold = 2 * 1024 * 1024,
+         size_t HugePageSize = 2 * 1024 * 1024,
+         typename Base = GrowthGeometric>
+struct GrowthHugePageAligned
+{
+  static_assert(HugePageSize != 0 && (HugePageSize & (HugePageSize - 1)) == 0,
+                "HugePageSize must be power of two");
+
+  static size_t newSize(size_t size, size_t minSize)
+  {
+    const auto res = Base::newSize(size, minSize);
+    if (res < Threshold)
+      return res;
+    return (res + HugePageSize - 1) & ~(HugePageSize - 1);
+  }
+};
+
+}
+
+#endif // BITSERY_ADAPTER_GROWTH_POLICY_H
@@ -121,7 +121,8 @@ private:
     if (size - static_cast<size_t>(_ios->rdbuf()->sgetn(
                  data, static_cast<std::streamsize>(size))) !=
         _zeroIfNoErrors) {
-      *data = {};
+      // set everything to zeros, buffer might be uninitialized
+      eastl::fill_n(data, size, TValue{});
       if (_zeroIfNoErrors == 0) {
         error(_ios->rdstate() == std::ios_base::badbit
                 ? ReaderError::ReadingError
@@ -23,6 +23,7 @@
 #ifndef BITSERY_DESERIALIZER_H
 #define BITSERY_DESERIALIZER_H
 
+#include "details/allocation_budget.h"
 #include "details/serialization_common.h"
 
 namespace bitsery {
@@ -164,8 +165,12 @@ public:
       "use text(T&) overload without `maxSize` for static containers");
     size_t length;
     readSize(length, maxSize);
-    traits::ContainerTraits<T>::resize(
-      str, length + (traits::TextTraits<T>::addNUL ? 1u : 0u));
+    details::chargeAllocationBudget<typename traits::TextTraits<T>::TValue>(
+      *this, length);
+    resizeForBulkRead(
+      str,
+      length + (traits::TextTraits<T>::addNUL ? 1u : 0u),
+      eastl::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
     procText<VSIZE>(str, length);
   }
 
@@ -200,6 +205,8 @@ public:
       "use container(T&) overload without `maxSize` for static containers");
     size_t size{};
     readSize(size, maxSize);
+    details::chargeAllocationBudget<typename traits::ContainerTraits<T>::TValue>(
+      *this, size);
     traits::ContainerTraits<T>::resize(obj, size);
     procContainer(eastl::begin(obj), eastl::end(obj), eastl::forward<Fnc>(fnc));
   }
@@ -215,7 +222,12 @@ public:
       "use container(T&) overload without `maxSize` for static containers");
     size_t size{};
     readSize(size, maxSize);
-    traits::ContainerTraits<T>::resize(obj, size);
+    details::chargeAllocationBudget<typename traits::ContainerTraits<T>::TValue>(
+      *this, size);
+    resizeForBulkRead(
+      obj,
+      size,
+      eastl::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
     procContainer<VSIZE>(
       eastl::begin(obj),
       eastl::end(obj),
@@ -233,6 +245,8 @@ public:
       "use container(T&) overload without `maxSize` for static containers");
     size_t size{};
     readSize(size, maxSize);
+    details::chargeAllocationBudget<typename traits::ContainerTraits<T>::TValue>(
+      *this, size);
     traits::ContainerTraits<T>::resize(obj, size);
     procContainer(eastl::begin(obj), eastl::end(obj));
   }
@@ -449,6 +463,20 @@ private:
       eastl::integral_constant<bool, TInputAdapter::TConfig::CheckDataErrors>{});
   }
 
+  // contiguous containers are read as whole buffer, so elements doesn't need
+  // to be initialized
+  template<typename T>
+  void resizeForBulkRead(T& obj, size_t size, eastl::true_type)
+  {
+    details::resizeForOverwrite(obj, size);
+  }
+
+  template<typename T>
+  void resizeForBulkRead(T& obj, size_t size, eastl::false_type)
+  {
+    traits::ContainerTraits<T>::resize(obj, size);
+  }
+
   // process value types
   // false_type means that we must process all elements individually
   template<size_t VSIZE, typename It>
@@ -0,0 +1,120 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_DETAILS_ALLOCATION_BUDGET_H
+#define BITSERY_DETAILS_ALLOCATION_BUDGET_H
+
+#include "adapter_common.h"
+#include <cstddef>
+
+namespace bitsery {
+
+// optional deserialization context, that limits how much heap memory a single
+// message can cause to allocate: resizable containers and text, EastlMap and
+// EastlSet elements, and objects created by pointer extensions.
+// when limit is exceeded, ReaderError::InvalidData is set and budget stays
+// exceeded, so nothing else is allocated until it is reset.
+// add it to your context (or context tuple), when it is not present there is
+// no overhead at all.
+class AllocationBudget
+{
+public:
+  explicit AllocationBudget(size_t maxBytes)
+    : _maxBytes{ maxBytes }
+  {
+  }
+
+  // charge raw bytes, returns false if budget is (or was already) exceeded
+  bool charge(size_t bytes)
+  {
+    if (_isExceeded || bytes > remainingBytes()) {
+      _isExceeded = true;
+      return false;
+    }
+    _usedBytes += bytes;
+    return true;
+  }
+
+  // charge memory for `count` elements of type T, checks for overflow
+  template<typename T>
+  bool charge(size_t count)
+  {
+    if (count > remainingBytes() / sizeof(T)) {
+      _isExceeded = true;
+      return false;
+    }
+    return charge(count * sizeof(T));
+  }
+
+  // call this before deserializing next message
+  void reset()
+  {
+    _usedBytes = 0;
+    _isExceeded = false;
+  }
+
+  // if already used more than new limit, budget becomes exceeded
+  void maxBytes(size_t maxBytes)
+  {
+    _maxBytes = maxBytes;
+    if (_usedBytes > _maxBytes)
+      _isExceeded = true;
+  }
+
+  size_t maxBytes() const { return _maxBytes; }
+
+  size_t usedBytes() const { return _usedBytes; }
+
+  size_t remainingBytes() const
+  {
+    return _usedBytes < _maxBytes ? _maxBytes - _usedBytes : 0;
+  }
+
+  bool isExceeded() const { return _isExceeded; }
+
+private:
+  size_t _maxBytes;
+  size_t _usedBytes{};
+  bool _isExceeded{};
+};
+
+namespace details {
+
+// charge budget for `size` elements before they're allocated,
+// if budget doesn't allow it, then set error and reset size to zero
+template<typename T, typename Des>
+void
+chargeAllocationBudget(Des& des, size_t& size)
+{
+  if (auto budget = des.template contextOrNull<AllocationBudget>()) {
+    if (!budget->template charge<T>(size)) {
+      des.adapter().error(ReaderError::InvalidData);
+      size = {};
+    }
+  }
+}
+
+}
+
+}
+
+#endif // BITSERY_DETAILS_ALLOCATION_BUDGET_H
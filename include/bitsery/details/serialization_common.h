@@ -135,6 +135,44 @@ struct IsExtensionTraitsDefined
 {
 };
 
+// ContainerTraits::resizeForOverwrite is optional, use resize if it is not
+// defined
+template<typename T>
+struct HasResizeForOverwriteHelper
+{
+  template<typename Q,
+           typename = decltype(traits::ContainerTraits<Q>::resizeForOverwrite(
+             eastl::declval<Q&>(),
+             size_t{}))>
+  static eastl::true_type tester(Q*);
+  template<typename Q>
+  static eastl::false_type tester(...);
+  using type = decltype(tester<T>(nullptr));
+};
+
+template<typename T>
+void
+resizeForOverwriteImpl(T& obj, size_t size, eastl::true_type)
+{
+  traits::ContainerTraits<T>::resizeForOverwrite(obj, size);
+}
+
+template<typename T>
+void
+resizeForOverwriteImpl(T& obj, size_t size, eastl::false_type)
+{
+  traits::ContainerTraits<T>::resize(obj, size);
+}
+
+// resize container, when all elements will be overwritten afterwards
+template<typename T>
+void
+resizeForOverwrite(T& obj, size_t size)
+{
+  resizeForOverwriteImpl(
+    obj, size, typename HasResizeForOverwriteHelper<T>::type{});
+}
+
 #ifdef _MSC_VER
 // helper types for HasSerializeFunction
 template<typename S, typename T>
@@ -457,15 +495,45 @@ getContext(TContext& ctx)
     ctx, eastl::is_convertible<TContext&, TCast&>{});
 }
 
-// tuple context
 template<bool AssertExists, typename TCast, typename... TArgs>
 TCast*
-getContext(eastl::tuple<TArgs...>& ctx)
+getFromTuple(eastl::tuple<TArgs...>& ctx, eastl::true_type)
+{
+  return &ctx;
+}
+
+template<bool AssertExists, typename TCast, typename... TArgs>
+TCast*
+getFromTuple(eastl::tuple<TArgs...>& ctx, eastl::false_type)
 {
   return getFromTupleIfExists<AssertExists, TCast>(
     ctx, IsExistsConvertibleTupleType<TCast, eastl::tuple<TArgs...>>{});
 }
 
+// tuple context, whole tuple can also be requested
+template<bool AssertExists, typename TCast, typename... TArgs>
+TCast*
+getContext(eastl::tuple<TArgs...>& ctx)
+{
+  return getFromTuple<AssertExists, TCast>(
+    ctx, eastl::is_same<TCast, eastl::tuple<TArgs...>>{});
+}
+
+// check at compile time if context (or one of tuple elements) is convertible
+template<typename TCast, typename TContext>
+struct IsContextExists : eastl::is_convertible<TContext&, TCast&>
+{
+};
+
+template<typename TCast, typename... TArgs>
+struct IsContextExists<TCast, eastl::tuple<TArgs...>>
+  : eastl::integral_constant<
+      bool,
+      eastl::is_same<TCast, eastl::tuple<TArgs...>>::value ||
+        IsExistsConvertibleTupleType<TCast, eastl::tuple<TArgs...>>::value>
+{
+};
+
 template<typename Adapter, typename Context>
 class AdapterAndContextRef
 {
@@ -501,6 +569,14 @@ public:
     return getContext<false, T>(_context);
   }
 
+  // compile time alternative for contextOrNull, useful when functionality
+  // can work with different context types
+  template<typename T>
+  static constexpr bool hasContext()
+  {
+    return IsContextExists<T, Context>::value;
+  }
+
   Adapter& adapter() & { return _adapter; }
 
   Adapter adapter() && { return eastl::move(_adapter); }
@@ -535,6 +611,12 @@ public:
     return nullptr;
   }
 
+  template<typename T>
+  static constexpr bool hasContext()
+  {
+    return false;
+  }
+
   Adapter& adapter() & { return _adapter; }
 
   Adapter adapter() && { return eastl::move(_adapter); }
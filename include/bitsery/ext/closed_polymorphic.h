@@ -0,0 +1,300 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_CLOSED_POLYMORPHIC_H
+#define BITSERY_EXT_CLOSED_POLYMORPHIC_H
+
+#include "../details/adapter_common.h"
+#include "../traits/core/traits.h"
+#include "utils/pointer_utils.h"
+#include "utils/rtti_utils.h"
+#include <EASTL/unique_ptr.h>
+#include <cassert>
+
+namespace bitsery {
+
+namespace ext {
+
+namespace closed_polymorphic_details {
+
+constexpr size_t
+bitsRequired(size_t v, size_t bits = 0)
+{
+  return v > 0 ? bitsRequired(v / 2, bits + 1) : bits;
+}
+
+// exact runtime type is already checked, so static_cast is enough, unless
+// TBase is virtual base
+template<typename RTTI, typename TBase, typename TDerived>
+TDerived*
+downcast(TBase* obj, eastl::true_type /*can static cast*/)
+{
+  return static_cast<TDerived*>(obj);
+}
+
+template<typename RTTI, typename TBase, typename TDerived>
+TDerived*
+downcast(TBase* obj, eastl::false_type /*can static cast*/)
+{
+  return RTTI::template cast<TBase, TDerived>(obj);
+}
+
+// owning pointer types that are supported
+template<typename TBase>
+TBase*
+getPtr(TBase* obj)
+{
+  return obj;
+}
+
+template<typename TBase, typename TDeleter>
+TBase*
+getPtr(const eastl::unique_ptr<TBase, TDeleter>& obj)
+{
+  return obj.get();
+}
+
+template<typename TBase>
+void
+resetPtr(TBase*& obj, TBase* ptr)
+{
+  obj = ptr;
+}
+
+template<typename TBase, typename TDeleter>
+void
+resetPtr(eastl::unique_ptr<TBase, TDeleter>& obj, TBase* ptr)
+{
+  // previous object is already destroyed
+  obj.release();
+  obj.reset(ptr);
+}
+
+}
+
+/*
+ * owning pointer (raw pointer or unique_ptr) to polymorphic type, when all
+ * derived types are known at compile time (sealed hierarchy).
+ * doesn't require PolymorphicContext nor PointerLinkingContext, writes compact
+ * type index (0 means null), using minimal number of bits when bit-packing is
+ * enabled, and dispatches via table of functions.
+ * index is a position in TDerived list, so new types must be appended to the
+ * end to keep compatibility.
+ */
+template<typename RTTI, typename TBase, typename... TDerived>
+class ClosedPolymorphicBase
+{
+public:
+  static_assert(sizeof...(TDerived) > 0, "at least one type is required");
+
+  explicit ClosedPolymorphicBase(PointerType ptrType = PointerType::Nullable,
+                                 MemResourceBase* resource = nullptr)
+    : _ptrType{ ptrType }
+    , _resource{ resource }
+  {
+  }
+
+  template<typename Ser, typename T, typename Fnc>
+  void serialize(Ser& ser, const T& obj, Fnc&&) const
+  {
+    auto ptr = closed_polymorphic_details::getPtr(obj);
+    assert(ptr != nullptr || _ptrType == PointerType::Nullable);
+    const size_t index = ptr ? indexOf(RTTI::template get<TBase>(*ptr)) : 0;
+    // type is not in the list
+    assert(index <= TypesCount);
+    writeIndex(ser, index, isBitPackingEnabled(ser));
+    if (index) {
+      using TFnc = void (*)(Ser&, TBase*);
+      static constexpr TFnc fncs[] = { &serializeAs<Ser, TDerived>... };
+      fncs[index - 1](ser, ptr);
+    }
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&&) const
+  {
+    size_t index{};
+    readIndex(des, index, isBitPackingEnabled(des));
+    if (index > TypesCount) {
+      des.adapter().error(ReaderError::InvalidData);
+      return;
+    }
+    pointer_utils::PolyAllocWithTypeId alloc{
+      _resource, des.template contextOrNull<AllocationBudget>()
+    };
+    auto ptr = closed_polymorphic_details::getPtr(obj);
+    const size_t prevIndex =
+      ptr ? indexOf(RTTI::template get<TBase>(*ptr)) : 0;
+    // existing object type is not in the list, so we don't know how to
+    // destroy or reuse it
+    if (prevIndex > TypesCount) {
+      des.adapter().error(ReaderError::InvalidData);
+      return;
+    }
+    if (index == 0 && _ptrType == PointerType::NotNull) {
+      des.adapter().error(ReaderError::InvalidPointer);
+      return;
+    }
+    if (prevIndex != index && prevIndex != 0) {
+      using TDestroyFnc =
+        void (*)(const pointer_utils::PolyAllocWithTypeId&, TBase*);
+      static constexpr TDestroyFnc destroyFncs[] = { &destroyAs<TDerived>... };
+      destroyFncs[prevIndex - 1](alloc, ptr);
+      ptr = nullptr;
+      closed_polymorphic_details::resetPtr(obj, ptr);
+    }
+    if (index) {
+      using TFnc =
+        void (*)(Des&, const pointer_utils::PolyAllocWithTypeId&, T&);
+      static constexpr TFnc fncs[] = { &deserializeAs<Des, T, TDerived>... };
+      // resource is not propagated, so subtree keeps current memory resource
+      fncs[index - 1](des, alloc, obj);
+    }
+  }
+
+private:
+  static constexpr size_t TypesCount = sizeof...(TDerived);
+
+  static size_t indexOf(size_t typeId)
+  {
+    // computed once, type ids might not be compile time constants (e.g.
+    // StandardRTTI hashes type name)
+    static const size_t typeIds[] = { RTTI::template get<TDerived>()... };
+    for (size_t i = 0; i < TypesCount; ++i) {
+      if (typeIds[i] == typeId)
+        return i + 1;
+    }
+    return TypesCount + 1;
+  }
+
+  template<typename S>
+  static eastl::integral_constant<
+    bool,
+    eastl::is_same<typename eastl::decay<decltype(eastl::declval<S&>()
+                                                    .adapter())>::type,
+                   typename eastl::decay<decltype(eastl::declval<S&>()
+                                                    .adapter())>::type::
+                     BitPackingEnabled>::value>
+  isBitPackingEnabled(S&)
+  {
+    return {};
+  }
+
+  template<typename Ser>
+  static void writeIndex(Ser& ser, size_t index, eastl::true_type)
+  {
+    ser.adapter().template writeBits<uint32_t>(
+      static_cast<uint32_t>(index),
+      closed_polymorphic_details::bitsRequired(TypesCount));
+  }
+
+  template<typename Ser>
+  static void writeIndex(Ser& ser, size_t index, eastl::false_type)
+  {
+    details::writeSize(ser.adapter(), index);
+  }
+
+  template<typename Des>
+  static void readIndex(Des& des, size_t& index, eastl::true_type)
+  {
+    uint32_t res{};
+    des.adapter().readBits(
+      res, closed_polymorphic_details::bitsRequired(TypesCount));
+    index = res;
+  }
+
+  template<typename Des>
+  static void readIndex(Des& des, size_t& index, eastl::false_type)
+  {
+    details::readSize(des.adapter(), index, 0, eastl::false_type{});
+  }
+
+  template<typename TObj>
+  static TObj* cast(TBase* obj)
+  {
+    return closed_polymorphic_details::downcast<RTTI, TBase, TObj>(
+      obj, rtti_details::CanStaticCast<TBase, TObj>{});
+  }
+
+  template<typename Ser, typename TObj>
+  static void serializeAs(Ser& ser, TBase* obj)
+  {
+    ser.object(*cast<TObj>(obj));
+  }
+
+  template<typename TObj>
+  static void destroyAs(const pointer_utils::PolyAllocWithTypeId& alloc,
+                        TBase* obj)
+  {
+    alloc.deleteObject(cast<TObj>(obj), RTTI::template get<TObj>());
+  }
+
+  template<typename Des, typename T, typename TObj>
+  static void deserializeAs(Des& des,
+                            const pointer_utils::PolyAllocWithTypeId& alloc,
+                            T& obj)
+  {
+    static_assert(eastl::is_base_of<TBase, TObj>::value,
+                  "all types must be derived from TBase");
+    static_assert(!eastl::is_abstract<TObj>::value,
+                  "abstract type cannot be created");
+    TObj* res{};
+    if (auto ptr = closed_polymorphic_details::getPtr(obj)) {
+      res = cast<TObj>(ptr);
+    } else {
+      res = alloc.newObject<TObj>(RTTI::template get<TObj>());
+      closed_polymorphic_details::resetPtr(obj, static_cast<TBase*>(res));
+      auto budget = alloc.getBudget();
+      if (budget && budget->isExceeded()) {
+        des.adapter().error(ReaderError::InvalidData);
+        return;
+      }
+    }
+    des.object(*res);
+  }
+
+  PointerType _ptrType;
+  MemResourceBase* _resource;
+};
+
+template<typename TBase, typename... TDerived>
+using ClosedPolymorphic =
+  ClosedPolymorphicBase<DefaultRTTI, TBase, TDerived...>;
+
+}
+
+namespace traits {
+
+template<typename T, typename RTTI, typename TBase, typename... TDerived>
+struct ExtensionTraits<ext::ClosedPolymorphicBase<RTTI, TBase, TDerived...>, T>
+{
+  using TValue = void;
+  static constexpr bool SupportValueOverload = false;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = false;
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_CLOSED_POLYMORPHIC_H
@@ -0,0 +1,247 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_CONTIGUOUS_OWNERS_H
+#define BITSERY_EXT_CONTIGUOUS_OWNERS_H
+
+#include "../details/allocation_budget.h"
+#include "../details/serialization_common.h"
+#include "../traits/core/traits.h"
+#include "utils/memory_resource.h"
+#include <EASTL/unique_ptr.h>
+#include <cassert>
+
+namespace bitsery {
+namespace ext {
+
+namespace contiguous_owners_details {
+
+// header of memory block, objects are placed right after it.
+// block is freed when last object is destroyed.
+struct Block
+{
+  MemResourceBase* resource;
+  size_t bytes;
+  size_t alignment;
+  // number of live objects, not thread safe
+  size_t refs;
+
+  void release() noexcept
+  {
+    if (--refs == 0) {
+      auto res = resource;
+      res ? res->deallocate(this, bytes, alignment, 0)
+          : MemResourceNewDelete{}.deallocate(this, bytes, alignment, 0);
+    }
+  }
+};
+
+constexpr size_t
+alignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+// deleter for objects, that are allocated by ContiguousPointerOwners.
+// default constructed deleter calls delete, so it can be used for objects
+// created by user as well.
+// block is released only once: after first call or when moved from, deleter
+// calls delete, so unique_ptr::reset(new T{}) is safe. pointer obtained by
+// unique_ptr::release() must be destroyed by this deleter.
+template<typename T>
+class ContiguousDeleter
+{
+public:
+  constexpr ContiguousDeleter() noexcept = default;
+
+  explicit ContiguousDeleter(contiguous_owners_details::Block* block) noexcept
+    : _block{ block }
+  {
+  }
+
+  ContiguousDeleter(ContiguousDeleter&& other) noexcept
+    : _block{ other._block }
+  {
+    other._block = nullptr;
+  }
+
+  ContiguousDeleter& operator=(ContiguousDeleter&& other) noexcept
+  {
+    if (this != &other) {
+      _block = other._block;
+      other._block = nullptr;
+    }
+    return *this;
+  }
+
+  ContiguousDeleter(const ContiguousDeleter&) = delete;
+  ContiguousDeleter& operator=(const ContiguousDeleter&) = delete;
+
+  void operator()(T* ptr) noexcept
+  {
+    if (_block) {
+      auto block = _block;
+      _block = nullptr;
+      ptr->~T();
+      block->release();
+    } else {
+      delete ptr;
+    }
+  }
+
+private:
+  contiguous_owners_details::Block* _block{};
+};
+
+template<typename T>
+using ContiguousUniquePtr = eastl::unique_ptr<T, ContiguousDeleter<T>>;
+
+/*
+ * extension for containers of owning pointers to non polymorphic type, e.g.
+ * eastl::vector<ContiguousUniquePtr<T>>.
+ * when deserializing, all objects are allocated as single contiguous block,
+ * that is freed when the last object is destroyed, so objects are close
+ * together in memory like in eastl::vector<T>.
+ * it is not tracked by pointer linking context (pointers cannot be observed
+ * by PointerObserver) and it writes the same data as container of
+ * UntrackedEastlSmartPtr: size, then presence flag and object for each
+ * element.
+ * memory is allocated from provided memory resource or current memory resource
+ * (see MemResourceScope).
+ */
+class ContiguousPointerOwners
+{
+public:
+  explicit ContiguousPointerOwners(size_t maxSize,
+                                   MemResourceBase* resource = nullptr)
+    : _maxSize{ maxSize }
+    , _resource{ resource }
+  {
+  }
+
+  template<typename Ser, typename T, typename Fnc>
+  void serialize(Ser& ser, const T& obj, Fnc&& fnc) const
+  {
+    auto size = traits::ContainerTraits<T>::size(obj);
+    assert(size <= _maxSize);
+    details::writeSize(ser.adapter(), size);
+    for (auto& ptr : obj) {
+      ser.boolValue(ptr != nullptr);
+      if (ptr)
+        fnc(ser, *ptr);
+    }
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  {
+    using TPtr = typename traits::ContainerTraits<T>::TValue;
+    using TElement = typename TPtr::element_type;
+    static_assert(
+      eastl::is_same<typename TPtr::deleter_type,
+                     ContiguousDeleter<TElement>>::value,
+      "container element must be ContiguousUniquePtr<T>");
+    static_assert(!eastl::is_polymorphic<TElement>::value,
+                  "polymorphic types are not supported, use "
+                  "UntrackedEastlSmartPtr or ClosedPolymorphic instead");
+    size_t size{};
+    details::readSize(
+      des.adapter(),
+      size,
+      _maxSize,
+      eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>{});
+    details::chargeAllocationBudget<TElement>(des, size);
+    // destroy previous objects first, so their blocks can be reused
+    obj.clear();
+    traits::ContainerTraits<T>::resize(obj, size);
+    if (size == 0)
+      return;
+
+    auto resource = _resource ? _resource : currentMemResource();
+    MemResourceScope scope{ resource };
+    auto block = allocateBlock<TElement>(resource, size);
+    auto objects = reinterpret_cast<TElement*>(
+      reinterpret_cast<uint8_t*>(block) + objectsOffset<TElement>());
+    // block must outlive this function, even if no objects are created
+    block->refs = 1;
+    for (auto& ptr : obj) {
+      bool exists{};
+      des.boolValue(exists);
+      if (exists) {
+        ++block->refs;
+        ptr = TPtr{ ::bitsery::Access::create<TElement>(objects),
+                    ContiguousDeleter<TElement>{ block } };
+        fnc(des, *ptr);
+      }
+      ++objects;
+    }
+    block->release();
+  }
+
+private:
+  template<typename TElement>
+  static constexpr size_t objectsOffset()
+  {
+    return contiguous_owners_details::alignUp(
+      sizeof(contiguous_owners_details::Block), alignof(TElement));
+  }
+
+  template<typename TElement>
+  static contiguous_owners_details::Block* allocateBlock(
+    MemResourceBase* resource,
+    size_t size)
+  {
+    using Block = contiguous_owners_details::Block;
+    const size_t bytes = objectsOffset<TElement>() + sizeof(TElement) * size;
+    const size_t alignment = alignof(TElement) > alignof(Block)
+                               ? alignof(TElement)
+                               : alignof(Block);
+    auto ptr = resource
+                 ? resource->allocate(bytes, alignment, 0)
+                 : MemResourceNewDelete{}.allocate(bytes, alignment, 0);
+    return new (ptr) Block{ resource, bytes, alignment, 0 };
+  }
+
+  size_t _maxSize;
+  MemResourceBase* _resource;
+};
+
+}
+
+namespace traits {
+
+template<typename T>
+struct ExtensionTraits<ext::ContiguousPointerOwners, T>
+{
+  using TValue = typename ContainerTraits<T>::TValue::element_type;
+  static constexpr bool SupportValueOverload = false;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = true;
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_CONTIGUOUS_OWNERS_H
@@ -23,8 +23,10 @@
 #ifndef BITSERY_EXT_EASTL_MAP_H
 #define BITSERY_EXT_EASTL_MAP_H
 
+#include "../details/allocation_budget.h"
 #include "../details/serialization_common.h"
 #include "../traits/core/traits.h"
+#include "utils/entries_reuse.h"
 // we need this, so we could reserve for non ordered map
 #include <EASTL/unordered_map.h>
 
@@ -34,8 +36,13 @@ namespace ext {
 class EastlMap
 {
 public:
-  constexpr explicit EastlMap(size_t maxSize)
+  // when reuseEntries is true, deserialization doesn't clear map: values with
+  // existing keys are deserialized in place of existing ones (node and
+  // allocated memory of old value is reused), missing keys are erased.
+  // unordered multimaps are always cleared.
+  constexpr explicit EastlMap(size_t maxSize, bool reuseEntries = false)
     : _maxSize{ maxSize }
+    , _reuseEntries{ reuseEntries }
   {
   }
 
@@ -64,6 +71,10 @@ public:
       size,
       _maxSize,
       eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>{});
+    details::chargeAllocationBudget<typename T::value_type>(des, size);
+    if (_reuseEntries &&
+        deserializeReuse(des, obj, size, fnc, CanReuse<T>{}, IsOrdered<T>{}))
+      return;
     obj.clear();
     reserve(obj, size);
 
@@ -77,6 +88,93 @@ public:
   }
 
 private:
+  template<typename T>
+  using IsOrdered = entries_reuse_details::IsOrdered<T>;
+
+  template<typename T>
+  using CanReuse = eastl::integral_constant<
+    bool,
+    IsOrdered<T>::value || entries_reuse_details::HasUniqueKeys<T>::value>;
+
+  // reads key and value to scratch objects, that are reused between entries
+  template<typename Des, typename T, typename Fnc>
+  struct Entries
+  {
+    using TKey = typename T::key_type;
+    using TValue = typename T::mapped_type;
+
+    void read() { fnc(des, scratchKey, scratchValue); }
+
+    const TKey& key() const { return scratchKey; }
+
+    static const TKey& keyOf(const typename T::value_type& v)
+    {
+      return v.first;
+    }
+
+    // old value goes to scratch, so its memory is reused for next entry
+    void update(typename T::value_type& v)
+    {
+      using eastl::swap;
+      swap(v.second, scratchValue);
+    }
+
+    typename T::iterator insert(T& obj, typename T::const_iterator hint)
+    {
+      return obj.emplace_hint(
+        hint, eastl::move(scratchKey), eastl::move(scratchValue));
+    }
+
+    Des& des;
+    Fnc& fnc;
+    TKey scratchKey;
+    TValue scratchValue;
+  };
+
+  template<typename Des, typename T, typename Fnc, typename TOrdered>
+  bool deserializeReuse(Des&, T&, size_t, Fnc&, eastl::false_type, TOrdered)
+    const
+  {
+    return false;
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  bool deserializeReuse(Des& des,
+                        T& obj,
+                        size_t size,
+                        Fnc& fnc,
+                        eastl::true_type,
+                        eastl::true_type) const
+  {
+    Entries<Des, T, Fnc> entries{
+      des,
+      fnc,
+      bitsery::Access::create<typename T::key_type>(),
+      bitsery::Access::create<typename T::mapped_type>()
+    };
+    entries_reuse_details::mergeOrdered(obj, size, entries);
+    return true;
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  bool deserializeReuse(Des& des,
+                        T& obj,
+                        size_t size,
+                        Fnc& fnc,
+                        eastl::true_type,
+                        eastl::false_type) const
+  {
+    reserve(obj, size);
+    Entries<Des, T, Fnc> entries{
+      des,
+      fnc,
+      bitsery::Access::create<typename T::key_type>(),
+      bitsery::Access::create<typename T::mapped_type>()
+    };
+    entries_reuse_details::mergeUnordered(obj, size, entries);
+    return true;
+  }
+
   template<typename Key,
            typename T,
            typename Hash,
@@ -103,6 +201,7 @@ private:
     // for ordered container do nothing
   }
   size_t _maxSize;
+  bool _reuseEntries;
 };
 }
 
@@ -23,7 +23,9 @@
 #ifndef BITSERY_EXT_EASTL_SET_H
 #define BITSERY_EXT_EASTL_SET_H
 
+#include "../details/allocation_budget.h"
 #include "../details/serialization_common.h"
+#include "utils/entries_reuse.h"
 #include <EASTL/unordered_set.h>
 
 namespace bitsery {
@@ -32,8 +34,12 @@ namespace ext {
 class EastlSet
 {
 public:
-  constexpr explicit EastlSet(size_t maxSize)
+  // when reuseEntries is true, deserialization doesn't clear set: existing
+  // keys are kept (without reallocating node), missing keys are erased.
+  // unordered multisets are always cleared.
+  constexpr explicit EastlSet(size_t maxSize, bool reuseEntries = false)
     : _maxSize{ maxSize }
+    , _reuseEntries{ reuseEntries }
   {
   }
 
@@ -60,6 +66,10 @@ public:
       size,
       _maxSize,
       eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>{});
+    details::chargeAllocationBudget<typename T::value_type>(des, size);
+    if (_reuseEntries &&
+        deserializeReuse(des, obj, size, fnc, CanReuse<T>{}, IsOrdered<T>{}))
+      return;
     obj.clear();
     reserve(obj, size);
     auto hint = obj.begin();
@@ -71,6 +81,77 @@ public:
   }
 
 private:
+  template<typename T>
+  using IsOrdered = entries_reuse_details::IsOrdered<T>;
+
+  template<typename T>
+  using CanReuse = eastl::integral_constant<
+    bool,
+    IsOrdered<T>::value || entries_reuse_details::HasUniqueKeys<T>::value>;
+
+  // reads key to scratch object, that is reused between entries
+  template<typename Des, typename T, typename Fnc>
+  struct Entries
+  {
+    using TKey = typename T::key_type;
+
+    void read() { fnc(des, scratchKey); }
+
+    const TKey& key() const { return scratchKey; }
+
+    static const TKey& keyOf(const TKey& v) { return v; }
+
+    // equal key is already in set
+    void update(const TKey&) {}
+
+    typename T::iterator insert(T& obj, typename T::const_iterator hint)
+    {
+      return obj.emplace_hint(hint, eastl::move(scratchKey));
+    }
+
+    Des& des;
+    Fnc& fnc;
+    TKey scratchKey;
+  };
+
+  template<typename Des, typename T, typename Fnc, typename TOrdered>
+  bool deserializeReuse(Des&, T&, size_t, Fnc&, eastl::false_type, TOrdered)
+    const
+  {
+    return false;
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  bool deserializeReuse(Des& des,
+                        T& obj,
+                        size_t size,
+                        Fnc& fnc,
+                        eastl::true_type,
+                        eastl::true_type) const
+  {
+    Entries<Des, T, Fnc> entries{
+      des, fnc, bitsery::Access::create<typename T::key_type>()
+    };
+    entries_reuse_details::mergeOrdered(obj, size, entries);
+    return true;
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  bool deserializeReuse(Des& des,
+                        T& obj,
+                        size_t size,
+                        Fnc& fnc,
+                        eastl::true_type,
+                        eastl::false_type) const
+  {
+    reserve(obj, size);
+    Entries<Des, T, Fnc> entries{
+      des, fnc, bitsery::Access::create<typename T::key_type>()
+    };
+    entries_reuse_details::mergeUnordered(obj, size, entries);
+    return true;
+  }
+
   template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
   void reserve(eastl::unordered_set<Key, Hash, KeyEqual, Allocator>& obj,
                size_t size) const
@@ -90,6 +171,7 @@ private:
     // for ordered container do nothing
   }
   size_t _maxSize;
+  bool _reuseEntries;
 };
 }
 
@@ -137,45 +137,48 @@ struct SmartPtrOwnerManager
   // define a type that will store shared state for shared and weak ptrs
   using TSharedState = SharedPtrSharedState;
 
+  // allocation budget (if any) is charged only for the object, deleter and
+  // control block allocator are stored in control block, so they only capture
+  // memory resource, because budget doesn't outlive deserialization
   static void createShared(TSharedState& state,
                            eastl::shared_ptr<TElement>& obj,
-                           MemResourceBase* memResource,
+                           pointer_utils::PolyAllocWithTypeId alloc,
                            size_t typeId)
   {
     // capture deleter parameters by value
-    pointer_utils::PolyAllocWithTypeId alloc{ memResource };
+    pointer_utils::PolyAllocWithTypeId dealloc{ alloc.getMemResource() };
     obj.reset(
       alloc.newObject<TElement>(typeId),
-      [alloc, typeId](TElement* data) { alloc.deleteObject(data, typeId); },
-      pointer_utils::StdPolyAlloc<TElement>(memResource));
+      [dealloc, typeId](TElement* data) { dealloc.deleteObject(data, typeId); },
+      pointer_utils::StdPolyAlloc<TElement>(dealloc));
     state.obj = obj;
   }
 
   static void createSharedPolymorphic(
     TSharedState& state,
     eastl::shared_ptr<TElement>& obj,
-    MemResourceBase* memResource,
+    pointer_utils::PolyAllocWithTypeId alloc,
     const eastl::shared_ptr<PolymorphicHandlerBase>& handler)
   {
     // capture deleter parameters by value
-    pointer_utils::PolyAllocWithTypeId alloc{ memResource };
+    pointer_utils::PolyAllocWithTypeId dealloc{ alloc.getMemResource() };
     obj.reset(
       static_cast<TElement*>(handler->create(alloc)),
-      [alloc, handler](TElement* data) { handler->destroy(alloc, data); },
-      pointer_utils::StdPolyAlloc<TElement>(memResource));
+      [dealloc, handler](TElement* data) { handler->destroy(dealloc, data); },
+      pointer_utils::StdPolyAlloc<TElement>(dealloc));
     state.obj = obj;
   }
 
   static void createShared(TSharedState& state,
                            eastl::weak_ptr<TElement>& obj,
-                           MemResourceBase* memResource,
+                           pointer_utils::PolyAllocWithTypeId alloc,
                            size_t typeId)
   {
-    pointer_utils::PolyAllocWithTypeId alloc{ memResource };
+    pointer_utils::PolyAllocWithTypeId dealloc{ alloc.getMemResource() };
     eastl::shared_ptr<TElement> res(
       alloc.newObject<TElement>(typeId),
-      [alloc, typeId](TElement* data) { alloc.deleteObject(data, typeId); },
-      pointer_utils::StdPolyAlloc<TElement>(memResource));
+      [dealloc, typeId](TElement* data) { dealloc.deleteObject(data, typeId); },
+      pointer_utils::StdPolyAlloc<TElement>(dealloc));
     obj = res;
     state.obj = res;
   }
@@ -183,14 +186,14 @@ struct SmartPtrOwnerManager
   static void createSharedPolymorphic(
     TSharedState& state,
     eastl::weak_ptr<TElement>& obj,
-    MemResourceBase* memResource,
+    pointer_utils::PolyAllocWithTypeId alloc,
     const eastl::shared_ptr<PolymorphicHandlerBase>& handler)
   {
-    pointer_utils::PolyAllocWithTypeId alloc{ memResource };
+    pointer_utils::PolyAllocWithTypeId dealloc{ alloc.getMemResource() };
     eastl::shared_ptr<TElement> res(
       static_cast<TElement*>(handler->create(alloc)),
-      [alloc, handler](TElement* data) { handler->destroy(alloc, data); },
-      pointer_utils::StdPolyAlloc<TElement>(memResource));
+      [dealloc, handler](TElement* data) { handler->destroy(dealloc, data); },
+      pointer_utils::StdPolyAlloc<TElement>(dealloc));
     obj = res;
     state.obj = res;
   }
@@ -216,7 +219,18 @@ using EastlSmartPtrBase = pointer_utils::PointerObjectExtensionBase<
   RTTI>;
 
 // helper type for convienience
-using EastlSmartPtr = EastlSmartPtrBase<StandardRTTI>;
+using EastlSmartPtr = EastlSmartPtrBase<DefaultRTTI>;
+
+// unique_ptr only, doesn't register pointer in pointer linking context,
+// so it doesn't require it, but unique_ptr cannot be observed by other pointers
+template<typename RTTI>
+using UntrackedEastlSmartPtrBase = pointer_utils::PointerObjectExtensionBase<
+  smart_ptr_details::SmartPtrOwnerManager,
+  PolymorphicContext,
+  RTTI,
+  false>;
+
+using UntrackedEastlSmartPtr = UntrackedEastlSmartPtrBase<DefaultRTTI>;
 
 }
 
@@ -233,6 +247,12 @@ struct ExtensionTraits<ext::EastlSmartPtrBase<RTTI>, T>
     !RTTI::template isPolymorphic<TValue>();
 };
 
+template<typename T, typename RTTI>
+struct ExtensionTraits<ext::UntrackedEastlSmartPtrBase<RTTI>, T>
+  : ExtensionTraits<ext::EastlSmartPtrBase<RTTI>, T>
+{
+};
+
 }
 
 }
@@ -0,0 +1,300 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_INDEXED_CONTAINER_H
+#define BITSERY_EXT_INDEXED_CONTAINER_H
+
+#include "../adapter/buffer.h"
+#include "../deserializer.h"
+#include "../serializer.h"
+#include "utils/serialize_exact.h"
+#include <EASTL/numeric_limits.h>
+#include <EASTL/vector.h>
+#include <cassert>
+#include <cstdint>
+
+namespace bitsery {
+namespace ext {
+
+namespace indexed_container_details {
+struct ViewAccess;
+}
+
+/*
+ * read-only view of container serialized with IndexedContainer, that
+ * references input buffer: deserializing it only validates offsets table,
+ * elements are deserialized on demand.
+ * buffer must outlive the view, Config must be the same as deserializer's.
+ */
+template<typename T, typename Config = DefaultConfig>
+class LazyContainerView
+{
+public:
+  using TValue = T;
+  using TInputAdapter =
+    InputBufferAdapter<UncheckedBufferView<uint8_t>, Config>;
+
+  size_t size() const { return _size; }
+
+  bool empty() const { return _size == 0; }
+
+  // serialized bytes of element
+  const uint8_t* elementData(size_t index) const
+  {
+    assert(index < _size);
+    return _data + elementBegin(index);
+  }
+
+  size_t elementSize(size_t index) const
+  {
+    assert(index < _size);
+    return elementEnd(index) - elementBegin(index);
+  }
+
+  eastl::pair<ReaderError, bool> get(size_t index, T& value) const
+  {
+    return quickDeserialization(
+      TInputAdapter{ elementData(index), elementSize(index) }, value);
+  }
+
+  template<typename Context>
+  eastl::pair<ReaderError, bool> get(Context& ctx,
+                                     size_t index,
+                                     T& value) const
+  {
+    return quickDeserialization(
+      ctx, TInputAdapter{ elementData(index), elementSize(index) }, value);
+  }
+
+  // for elements that were serialized with lambda
+  template<typename Fnc>
+  eastl::pair<ReaderError, bool> get(size_t index, T& value, Fnc&& fnc) const
+  {
+    Deserializer<TInputAdapter> des{ elementData(index), elementSize(index) };
+    fnc(des, value);
+    return { des.adapter().error(), des.adapter().isCompletedSuccessfully() };
+  }
+
+private:
+  friend struct indexed_container_details::ViewAccess;
+
+  size_t elementBegin(size_t index) const
+  {
+    return index == 0 ? 0 : elementEnd(index - 1);
+  }
+
+  size_t elementEnd(size_t index) const
+  {
+    TInputAdapter adapter{ _table + index * sizeof(uint32_t),
+                           sizeof(uint32_t) };
+    uint32_t end{};
+    adapter.template readBytes<4>(end);
+    return end;
+  }
+
+  const uint8_t* _table{};
+  const uint8_t* _data{};
+  size_t _size{};
+};
+
+namespace indexed_container_details {
+
+// reserves offsets table, writes `size` elements with writeElement(index) and
+// then fills the table
+template<typename Ser, typename Fnc>
+void
+writeElements(Ser& ser, size_t size, Fnc&& writeElement)
+{
+  auto& adapter = ser.adapter();
+  const auto tablePos = adapter.currentWritePos();
+  const auto dataPos = tablePos + size * sizeof(uint32_t);
+  adapter.currentWritePos(dataPos);
+  eastl::vector<uint32_t> ends(size);
+  for (size_t i = 0; i < size; ++i) {
+    writeElement(i);
+    assert(adapter.currentWritePos() - dataPos <= 0xFFFFFFFFu);
+    ends[i] = static_cast<uint32_t>(adapter.currentWritePos() - dataPos);
+  }
+  const auto endPos = adapter.currentWritePos();
+  adapter.currentWritePos(tablePos);
+  adapter.template writeBuffer<4>(ends.data(), size);
+  adapter.currentWritePos(endPos);
+}
+
+// reads offsets table and `size` elements with readElement(index), each
+// element must end exactly at its offset
+template<typename Des, typename Fnc>
+void
+readElements(Des& des, size_t size, Fnc&& readElement)
+{
+  auto& adapter = des.adapter();
+  eastl::vector<uint32_t> ends(size);
+  adapter.template readBuffer<4>(ends.data(), size);
+  const auto dataPos = adapter.currentReadPos();
+  for (size_t i = 0; i < size; ++i) {
+    readElement(i);
+    if (adapter.currentReadPos() - dataPos != ends[i]) {
+      adapter.error(ReaderError::InvalidData);
+      return;
+    }
+  }
+}
+
+struct ViewAccess
+{
+  // references offsets table and elements in input buffer, offsets must not
+  // decrease, so that every element is inside data
+  template<typename Des, typename T, typename Config>
+  static void init(Des& des, size_t size, LazyContainerView<T, Config>& view)
+  {
+    static_assert(eastl::is_same<typename Des::TConfig, Config>::value,
+                  "view config must match deserializer config");
+    auto& adapter = des.adapter();
+    view = LazyContainerView<T, Config>{};
+    if (size == 0)
+      return;
+    if (size > eastl::numeric_limits<size_t>::max() / sizeof(uint32_t)) {
+      adapter.error(ReaderError::DataOverflow);
+      return;
+    }
+    auto table = adapter.skipBytes(size * sizeof(uint32_t));
+    if (adapter.error() != ReaderError::NoError)
+      return;
+    view._table = reinterpret_cast<const uint8_t*>(&*table);
+    view._size = size;
+    size_t prev = 0;
+    for (size_t i = 0; i < size; ++i) {
+      const auto end = view.elementEnd(i);
+      if (end < prev) {
+        adapter.error(ReaderError::InvalidData);
+        view = LazyContainerView<T, Config>{};
+        return;
+      }
+      prev = end;
+    }
+    auto data = adapter.skipBytes(prev);
+    if (adapter.error() != ReaderError::NoError) {
+      view = LazyContainerView<T, Config>{};
+      return;
+    }
+    view._data = prev > 0 ? reinterpret_cast<const uint8_t*>(&*data) : nullptr;
+  }
+};
+
+}
+
+/*
+ * container extension, that writes offsets table before elements, so that any
+ * element can be found without deserializing previous ones: size, end offset
+ * of each element (4 bytes, relative to the first element) and elements.
+ * deserialize to container as usual, or to LazyContainerView to deserialize
+ * only elements that are accessed.
+ * table is filled after elements are written, so it only works with
+ * OutputBufferAdapter and InputBufferAdapter. elements data must be smaller
+ * than 4GB.
+ */
+class IndexedContainer
+{
+public:
+  explicit IndexedContainer(size_t maxSize)
+    : _maxSize{ maxSize }
+  {
+  }
+
+  template<typename Ser, typename T, typename Fnc>
+  void serialize(Ser& ser, const T& obj, Fnc&& fnc) const
+  {
+    const auto size = traits::ContainerTraits<T>::size(obj);
+    assert(size <= _maxSize);
+    details::writeSize(ser.adapter(), size);
+    auto it = eastl::begin(obj);
+    indexed_container_details::writeElements(ser, size, [&](size_t) {
+      fnc(ser, const_cast<ValueType<T>&>(*it));
+      ++it;
+    });
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  {
+    auto size = readSize(des);
+    details::chargeAllocationBudget<ValueType<T>>(des, size);
+    traits::ContainerTraits<T>::resize(obj, size);
+    auto it = eastl::begin(obj);
+    indexed_container_details::readElements(des, size, [&](size_t) {
+      fnc(des, *it);
+      ++it;
+    });
+  }
+
+  template<typename Des, typename T, typename Config, typename Fnc>
+  void deserialize(Des& des, LazyContainerView<T, Config>& view, Fnc&&) const
+  {
+    indexed_container_details::ViewAccess::init(des, readSize(des), view);
+  }
+
+private:
+  template<typename T>
+  using ValueType = typename traits::ContainerTraits<T>::TValue;
+
+  template<typename Des>
+  size_t readSize(Des& des) const
+  {
+    size_t size{};
+    details::readSize(
+      des.adapter(),
+      size,
+      _maxSize,
+      eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>{});
+    return size;
+  }
+
+  size_t _maxSize;
+};
+
+}
+
+namespace traits {
+
+template<typename T>
+struct ExtensionTraits<ext::IndexedContainer, T>
+{
+  using TValue = typename ContainerTraits<T>::TValue;
+  static constexpr bool SupportValueOverload = true;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = true;
+};
+
+template<typename T, typename Config>
+struct ExtensionTraits<ext::IndexedContainer, ext::LazyContainerView<T, Config>>
+{
+  // elements are not deserialized
+  using TValue = void;
+  static constexpr bool SupportValueOverload = false;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = false;
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_INDEXED_CONTAINER_H
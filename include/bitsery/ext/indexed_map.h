@@ -0,0 +1,491 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_INDEXED_MAP_H
+#define BITSERY_EXT_INDEXED_MAP_H
+
+#include "../details/allocation_budget.h"
+#include "indexed_container.h"
+#include <EASTL/algorithm.h>
+#include <EASTL/string.h>
+#include <EASTL/unordered_map.h>
+#include <EASTL/vector.h>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace bitsery {
+namespace ext {
+
+// order of keys in serialized key block.
+// Sorted is searched with binary search, Eytzinger stores keys in breadth
+// first order of implicit binary search tree, so that first levels of search
+// share cache lines, and is faster for large maps.
+enum class MapKeyLayout : uint8_t
+{
+  Sorted,
+  Eytzinger
+};
+
+namespace indexed_map_details {
+
+struct ViewAccess;
+
+// keys of fundamental types, stored with fixed stride
+template<typename Key, typename Config>
+class KeyBlock
+{
+public:
+  static_assert(details::IsFundamentalType<Key>::value,
+                "IndexedMap keys must be fundamental types or strings");
+
+  template<typename Ser, typename KeyAt>
+  static void write(Ser& ser, size_t size, KeyAt&& keyAt)
+  {
+    for (size_t i = 0; i < size; ++i)
+      ser.template value<sizeof(Key)>(keyAt(i));
+  }
+
+  static bool less(const Key& lhs, const Key& rhs) { return lhs < rhs; }
+
+  template<typename Des>
+  bool init(Des& des, size_t size)
+  {
+    auto& adapter = des.adapter();
+    _data = nullptr;
+    if (size > eastl::numeric_limits<size_t>::max() / sizeof(Key)) {
+      adapter.error(ReaderError::DataOverflow);
+      return false;
+    }
+    auto data = adapter.skipBytes(size * sizeof(Key));
+    if (adapter.error() != ReaderError::NoError)
+      return false;
+    if (size > 0)
+      _data = reinterpret_cast<const uint8_t*>(&*data);
+    return true;
+  }
+
+  Key key(size_t index) const
+  {
+    using TIntegral = typename details::IntegralFromFundamental<Key>::TValue;
+    TInputAdapter adapter{ _data + index * sizeof(Key), sizeof(Key) };
+    Key res{};
+    adapter.template readBytes<sizeof(Key)>(reinterpret_cast<TIntegral&>(res));
+    return res;
+  }
+
+  int compare(size_t index, const Key& key) const
+  {
+    const auto stored = this->key(index);
+    return stored < key ? -1 : (key < stored ? 1 : 0);
+  }
+
+private:
+  using TInputAdapter =
+    InputBufferAdapter<UncheckedBufferView<uint8_t>, Config>;
+
+  const uint8_t* _data{};
+};
+
+// string keys, stored as offsets table and characters, compared bytewise
+template<typename C, typename Allocator, typename Config>
+class KeyBlock<eastl::basic_string<C, Allocator>, Config>
+{
+public:
+  using TString = eastl::basic_string<C, Allocator>;
+  static_assert(sizeof(C) == 1, "IndexedMap string keys must use 1-byte chars");
+
+  template<typename Ser, typename KeyAt>
+  static void write(Ser& ser, size_t size, KeyAt&& keyAt)
+  {
+    indexed_container_details::writeElements(ser, size, [&](size_t i) {
+      const TString& key = keyAt(i);
+      ser.adapter().template writeBuffer<1>(key.data(), key.size());
+    });
+  }
+
+  static bool less(const TString& lhs, const TString& rhs)
+  {
+    return compareBytes(lhs.data(), lhs.size(), rhs.data(), rhs.size()) < 0;
+  }
+
+  template<typename Des>
+  bool init(Des& des, size_t size)
+  {
+    indexed_container_details::ViewAccess::init(des, size, _keys);
+    return des.adapter().error() == ReaderError::NoError;
+  }
+
+  TString key(size_t index) const
+  {
+    return TString(reinterpret_cast<const C*>(_keys.elementData(index)),
+                   _keys.elementSize(index));
+  }
+
+  // accepts any key type with data() and size(), e.g. string_view
+  template<typename K>
+  int compare(size_t index, const K& key) const
+  {
+    return compareBytes(_keys.elementData(index),
+                        _keys.elementSize(index),
+                        key.data(),
+                        key.size());
+  }
+
+private:
+  static int compareBytes(const void* lhs,
+                          size_t lhsSize,
+                          const void* rhs,
+                          size_t rhsSize)
+  {
+    const auto size = lhsSize < rhsSize ? lhsSize : rhsSize;
+    const auto res = size > 0 ? memcmp(lhs, rhs, size) : 0;
+    if (res != 0)
+      return res;
+    return lhsSize < rhsSize ? -1 : (rhsSize < lhsSize ? 1 : 0);
+  }
+
+  LazyContainerView<TString, Config> _keys{};
+};
+
+// fills out in order of Eytzinger layout from sorted in, node k (starting
+// from 1) has children 2k and 2k + 1 and is stored at index k - 1
+template<typename T>
+void
+eytzingerOrder(const T* in, T* out, size_t size, size_t& next, size_t node)
+{
+  if (node > size)
+    return;
+  eytzingerOrder(in, out, size, next, 2 * node);
+  out[node - 1] = in[next++];
+  eytzingerOrder(in, out, size, next, 2 * node + 1);
+}
+
+}
+
+/*
+ * read-only view of map serialized with IndexedMap, that references input
+ * buffer: deserializing it only validates key block and values offsets table,
+ * lookups search keys in place and deserialize only the matching value.
+ * indexes are positions in key block, with Eytzinger layout they don't follow
+ * key order.
+ * buffer must outlive the view, Config must be the same as deserializer's.
+ */
+template<typename TKey, typename TValue, typename Config = DefaultConfig>
+class LazyMapView
+{
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  size_t size() const { return _values.size(); }
+
+  bool empty() const { return _values.empty(); }
+
+  MapKeyLayout layout() const { return _layout; }
+
+  // returns index of key, or npos if key is not found
+  template<typename K>
+  size_t find(const K& key) const
+  {
+    return _layout == MapKeyLayout::Eytzinger ? findEytzinger(key)
+                                              : findSorted(key);
+  }
+
+  template<typename K>
+  bool contains(const K& key) const
+  {
+    return find(key) != npos;
+  }
+
+  TKey key(size_t index) const
+  {
+    assert(index < size());
+    return _keys.key(index);
+  }
+
+  eastl::pair<ReaderError, bool> value(size_t index, TValue& value) const
+  {
+    return _values.get(index, value);
+  }
+
+  template<typename Context>
+  eastl::pair<ReaderError, bool> value(Context& ctx,
+                                       size_t index,
+                                       TValue& value) const
+  {
+    return _values.get(ctx, index, value);
+  }
+
+  // for values that were serialized with lambda
+  template<typename Fnc>
+  eastl::pair<ReaderError, bool> value(size_t index,
+                                       TValue& value,
+                                       Fnc&& fnc) const
+  {
+    return _values.get(index, value, eastl::forward<Fnc>(fnc));
+  }
+
+  // returns true if key is found and its value deserialized successfully
+  template<typename K>
+  bool get(const K& key, TValue& value) const
+  {
+    const auto index = find(key);
+    return index != npos && this->value(index, value).second;
+  }
+
+private:
+  friend struct indexed_map_details::ViewAccess;
+
+  template<typename K>
+  size_t findSorted(const K& key) const
+  {
+    size_t first = 0;
+    size_t count = size();
+    while (count > 0) {
+      const auto half = count / 2;
+      if (_keys.compare(first + half, key) < 0) {
+        first += half + 1;
+        count -= half + 1;
+      } else {
+        count = half;
+      }
+    }
+    return first < size() && _keys.compare(first, key) == 0 ? first : npos;
+  }
+
+  template<typename K>
+  size_t findEytzinger(const K& key) const
+  {
+    const auto n = size();
+    size_t node = 1;
+    while (node <= n)
+      node = 2 * node + (_keys.compare(node - 1, key) < 0 ? 1u : 0u);
+    // go back up while we went right, and one more step, to lower bound
+    while (node & 1u)
+      node >>= 1;
+    node >>= 1;
+    return node != 0 && _keys.compare(node - 1, key) == 0 ? node - 1 : npos;
+  }
+
+  indexed_map_details::KeyBlock<TKey, Config> _keys{};
+  LazyContainerView<TValue, Config> _values{};
+  MapKeyLayout _layout{ MapKeyLayout::Sorted };
+};
+
+template<typename TKey, typename TValue, typename Config>
+constexpr size_t LazyMapView<TKey, TValue, Config>::npos;
+
+namespace indexed_map_details {
+
+struct ViewAccess
+{
+  template<typename Des, typename TKey, typename TValue, typename Config>
+  static void init(Des& des,
+                   size_t size,
+                   MapKeyLayout layout,
+                   LazyMapView<TKey, TValue, Config>& view)
+  {
+    view = LazyMapView<TKey, TValue, Config>{};
+    if (!view._keys.init(des, size))
+      return;
+    indexed_container_details::ViewAccess::init(des, size, view._values);
+    if (des.adapter().error() != ReaderError::NoError) {
+      view = LazyMapView<TKey, TValue, Config>{};
+      return;
+    }
+    view._layout = layout;
+  }
+};
+
+}
+
+/*
+ * map extension, that writes keys sorted into separate key block, so that
+ * value can be found without deserializing whole map: size, layout, key block,
+ * end offset of each value (4 bytes) and values.
+ * fundamental keys are stored with fixed size, string keys with offsets table.
+ * deserialize to map as usual, or to LazyMapView to lookup values in place.
+ * works only with OutputBufferAdapter and InputBufferAdapter, keys must be
+ * unique, values data must be smaller than 4GB.
+ */
+class IndexedMap
+{
+public:
+  explicit IndexedMap(size_t maxSize,
+                      MapKeyLayout layout = MapKeyLayout::Sorted)
+    : _maxSize{ maxSize }
+    , _layout{ layout }
+  {
+  }
+
+  template<typename Ser, typename T, typename Fnc>
+  void serialize(Ser& ser, const T& obj, Fnc&& fnc) const
+  {
+    using TKey = typename T::key_type;
+    using TEntry = typename T::value_type;
+    using TKeys = indexed_map_details::KeyBlock<TKey, typename Ser::TConfig>;
+    const auto size = obj.size();
+    assert(size <= _maxSize);
+    details::writeSize(ser.adapter(), size);
+    ser.adapter().template writeBytes<1>(static_cast<uint8_t>(_layout));
+
+    eastl::vector<const TEntry*> entries{};
+    entries.reserve(size);
+    for (auto& v : obj)
+      entries.push_back(&v);
+    auto less = [](const TEntry* lhs, const TEntry* rhs) {
+      return TKeys::less(lhs->first, rhs->first);
+    };
+    // ordered maps with default compare are already sorted
+    if (!eastl::is_sorted(entries.begin(), entries.end(), less))
+      eastl::sort(entries.begin(), entries.end(), less);
+    assert(eastl::adjacent_find(entries.begin(),
+                                entries.end(),
+                                [&less](const TEntry* lhs, const TEntry* rhs) {
+                                  return !less(lhs, rhs);
+                                }) == entries.end());
+    if (_layout == MapKeyLayout::Eytzinger && size > 0) {
+      eastl::vector<const TEntry*> sorted{ eastl::move(entries) };
+      entries.resize(size);
+      size_t next = 0;
+      indexed_map_details::eytzingerOrder(
+        sorted.data(), entries.data(), size, next, 1);
+    }
+
+    TKeys::write(ser, size, [&entries](size_t i) -> const TKey& {
+      return entries[i]->first;
+    });
+    indexed_container_details::writeElements(ser, size, [&](size_t i) {
+      fnc(ser, const_cast<typename T::mapped_type&>(entries[i]->second));
+    });
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  {
+    using TValue = typename T::mapped_type;
+    auto size = readSize(des);
+    // values are stored at the same index as keys, so layout doesn't matter
+    readLayout(des);
+    details::chargeAllocationBudget<typename T::value_type>(des, size);
+    obj.clear();
+    indexed_map_details::KeyBlock<typename T::key_type, typename Des::TConfig>
+      keys{};
+    if (!keys.init(des, size))
+      return;
+    reserve(obj, size);
+    indexed_container_details::readElements(des, size, [&](size_t i) {
+      auto value = bitsery::Access::create<TValue>();
+      fnc(des, value);
+      obj.emplace_hint(obj.end(), keys.key(i), eastl::move(value));
+    });
+    // keys must be unique
+    if (obj.size() != size)
+      des.adapter().error(ReaderError::InvalidData);
+  }
+
+  template<typename Des,
+           typename TKey,
+           typename TValue,
+           typename Config,
+           typename Fnc>
+  void deserialize(Des& des,
+                   LazyMapView<TKey, TValue, Config>& view,
+                   Fnc&&) const
+  {
+    const auto size = readSize(des);
+    const auto layout = readLayout(des);
+    indexed_map_details::ViewAccess::init(des, size, layout, view);
+  }
+
+private:
+  template<typename Des>
+  size_t readSize(Des& des) const
+  {
+    size_t size{};
+    details::readSize(
+      des.adapter(),
+      size,
+      _maxSize,
+      eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>{});
+    return size;
+  }
+
+  template<typename Des>
+  MapKeyLayout readLayout(Des& des) const
+  {
+    uint8_t layout{};
+    des.adapter().template readBytes<1>(layout);
+    if (layout > static_cast<uint8_t>(MapKeyLayout::Eytzinger)) {
+      des.adapter().error(ReaderError::InvalidData);
+      return MapKeyLayout::Sorted;
+    }
+    return static_cast<MapKeyLayout>(layout);
+  }
+
+  template<typename Key,
+           typename T,
+           typename Hash,
+           typename KeyEqual,
+           typename Allocator>
+  void reserve(eastl::unordered_map<Key, T, Hash, KeyEqual, Allocator>& obj,
+               size_t size) const
+  {
+    obj.reserve(size);
+  }
+  template<typename T>
+  void reserve(T&, size_t) const
+  {
+    // for ordered container do nothing
+  }
+
+  size_t _maxSize;
+  MapKeyLayout _layout;
+};
+
+}
+
+namespace traits {
+
+template<typename T>
+struct ExtensionTraits<ext::IndexedMap, T>
+{
+  using TValue = typename T::mapped_type;
+  static constexpr bool SupportValueOverload = true;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = true;
+};
+
+template<typename TKey, typename TMapped, typename Config>
+struct ExtensionTraits<ext::IndexedMap, ext::LazyMapView<TKey, TMapped, Config>>
+{
+  // values are not deserialized
+  using TValue = void;
+  static constexpr bool SupportValueOverload = false;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = false;
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_INDEXED_MAP_H
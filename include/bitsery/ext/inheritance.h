@@ -25,7 +25,8 @@
 
 #include "../ext/utils/memory_resource.h"
 #include "../traits/core/traits.h"
-#include <EASTL/unordered_set.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
 
 namespace bitsery {
 
@@ -37,7 +38,7 @@ class InheritanceContext
 {
 public:
   explicit InheritanceContext(MemResourceBase* memResource = nullptr)
-    : _virtualBases{ pointer_utils::StdPolyAlloc<const void*>{ memResource } }
+    : _overflow{ pointer_utils::StdPolyAlloc<const void*>{ memResource } }
   {
   }
   InheritanceContext(const InheritanceContext&) = delete;
@@ -50,8 +51,11 @@ public:
   {
     if (_depth == 0) {
       const void* ptr = eastl::addressof(derived);
-      if (_parentPtr != ptr)
-        _virtualBases.clear();
+      if (_parentPtr != ptr) {
+        // keep overflow capacity, so that next object doesn't allocate
+        _inlineSize = 0;
+        _overflow.clear();
+      }
       _parentPtr = ptr;
     }
     ++_depth;
@@ -61,21 +65,36 @@ public:
   bool beginVirtualBase(const TDerived& derived, const TBase& base)
   {
     beginBase(derived, base);
-    return _virtualBases.emplace(eastl::addressof(base)).second;
+    const void* ptr = eastl::addressof(base);
+    // object rarely has more than few virtual bases, so linear search is
+    // faster than hashing and doesn't require node allocations
+    for (size_t i = 0; i < _inlineSize; ++i) {
+      if (_inline[i] == ptr)
+        return false;
+    }
+    if (_inlineSize < InlineCapacity) {
+      _inline[_inlineSize++] = ptr;
+      return true;
+    }
+    if (eastl::find(_overflow.begin(), _overflow.end(), ptr) != _overflow.end())
+      return false;
+    _overflow.push_back(ptr);
+    return true;
   }
 
   void end() { --_depth; }
 
 private:
-  // these members are required to know when we can clear _virtualBases
+  static constexpr size_t InlineCapacity = 8;
+  // these members are required to know when we can clear virtual bases
   size_t _depth{};
   const void* _parentPtr{};
-  // add virtual bases to the list, as long as we're on the same parent
-  eastl::unordered_set<const void*,
-                     eastl::hash<const void*>,
-                     eastl::equal_to<const void*>,
-                     pointer_utils::StdPolyAlloc<const void*>>
-    _virtualBases;
+  // add virtual bases to the list, as long as we're on the same parent.
+  // first bases are stored inline, the rest goes to overflow
+  size_t _inlineSize{};
+  const void* _inline[InlineCapacity]{};
+  eastl::vector<const void*, pointer_utils::StdPolyAlloc<const void*>>
+    _overflow;
 };
 
 template<typename TBase>
@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_PARALLEL_CONTAINER_H
+#define BITSERY_EXT_PARALLEL_CONTAINER_H
+
+#include "../adapter/buffer.h"
+#include "../deserializer.h"
+#include "../details/allocation_budget.h"
+#include "../serializer.h"
+#include "utils/executor.h"
+#include <EASTL/vector.h>
+#include <cassert>
+
+namespace bitsery {
+namespace ext {
+
+namespace parallel_container_details {
+
+// chunks are (de)serialized by (de)serializer of the same type as parent, so
+// that user functions can be used for elements, it is only possible with
+// buffer adapters
+template<typename S>
+struct ChunkTypes
+{
+  static constexpr bool IsSupported = false;
+};
+
+template<typename Buffer, typename Config, typename Growth, typename Context>
+struct ChunkTypes<
+  Serializer<OutputBufferAdapter<Buffer, Config, Growth>, Context>>
+{
+  static constexpr bool IsSupported = true;
+  using TBuffer = Buffer;
+  using TContext = Context;
+};
+
+template<typename Buffer, typename Config, typename Context>
+struct ChunkTypes<Deserializer<InputBufferAdapter<Buffer, Config>, Context>>
+{
+  static constexpr bool IsSupported = true;
+  using TIterator = typename InputBufferAdapter<Buffer, Config>::TIterator;
+  using TContext = Context;
+};
+
+// creates (de)serializer of type S with parent context
+template<typename S, typename Context>
+struct ChunkFactory
+{
+  ChunkFactory(S& parent, size_t /*chunksCount*/)
+    : ctx{ parent.template context<Context>() }
+  {
+  }
+
+  template<typename Fnc, typename... TArgs>
+  void run(size_t /*index*/, Fnc&& fnc, TArgs&&... args)
+  {
+    S s{ ctx, eastl::forward<TArgs>(args)... };
+    fnc(s);
+  }
+
+  bool merge() { return true; }
+
+  Context& ctx;
+};
+
+template<typename S>
+struct ChunkFactory<S, void>
+{
+  ChunkFactory(S&, size_t) {}
+
+  template<typename Fnc, typename... TArgs>
+  void run(size_t /*index*/, Fnc&& fnc, TArgs&&... args)
+  {
+    S s{ eastl::forward<TArgs>(args)... };
+    fnc(s);
+  }
+
+  bool merge() { return true; }
+};
+
+// allocation budget is not thread safe, so each chunk gets equal slice of
+// remaining budget, and used bytes are charged to parent budget afterwards
+template<typename S>
+struct ChunkFactory<S, AllocationBudget>
+{
+  ChunkFactory(S& parent, size_t chunksCount)
+    : ctx{ parent.template context<AllocationBudget>() }
+    , budgets(chunksCount,
+              AllocationBudget{ ctx.remainingBytes() / chunksCount })
+  {
+  }
+
+  template<typename Fnc, typename... TArgs>
+  void run(size_t index, Fnc&& fnc, TArgs&&... args)
+  {
+    S s{ budgets[index], eastl::forward<TArgs>(args)... };
+    fnc(s);
+  }
+
+  // returns false if any slice or parent budget is exceeded
+  bool merge()
+  {
+    for (auto& budget : budgets) {
+      if (budget.isExceeded() || !ctx.charge(budget.usedBytes()))
+        return false;
+    }
+    return true;
+  }
+
+  AllocationBudget& ctx;
+  eastl::vector<AllocationBudget> budgets;
+};
+
+// budget that is part of context tuple cannot be replaced for chunks
+template<typename S, typename Context>
+struct IsContextSupported
+  : eastl::integral_constant<
+      bool,
+      eastl::is_same<Context, AllocationBudget>::value ||
+        !S::template hasContext<AllocationBudget>()>
+{
+};
+
+}
+
+/*
+ * extension for big contiguous containers of independent elements.
+ * container is split into chunks of `chunkSize` elements, each chunk is
+ * (de)serialized by separate (de)serializer on provided executor, and then
+ * spliced into main buffer after chunk sizes table.
+ * when deserializing, container is resized first, and chunks are deserialized
+ * in parallel directly into their elements.
+ * only works with OutputBufferAdapter and InputBufferAdapter (without
+ * bit-packing). chunk (de)serializers have the same type and share the same
+ * context as parent, so context must be safe to use from multiple threads
+ * (e.g. FrozenPolymorphicContext) or not used by elements at all, and lambda
+ * must be safe to call concurrently.
+ * AllocationBudget is supported only as the whole context: each chunk is
+ * deserialized with equal slice of remaining budget. budget in context tuple
+ * is not supported, because it would be charged from multiple threads.
+ */
+class ParallelContainer
+{
+public:
+  ParallelContainer(ParallelExecutor& executor,
+                    size_t maxSize,
+                    size_t chunkSize = 4096)
+    : _executor{ executor }
+    , _maxSize{ maxSize }
+    , _chunkSize{ chunkSize }
+  {
+    assert(chunkSize > 0);
+  }
+
+  template<typename Ser, typename T, typename Fnc>
+  void serialize(Ser& ser, const T& obj, Fnc&& fnc) const
+  {
+    using Types = parallel_container_details::ChunkTypes<Ser>;
+    static_assert(Types::IsSupported,
+                  "ParallelContainer only works with OutputBufferAdapter");
+    static_assert(traits::ContainerTraits<T>::isContiguous,
+                  "ParallelContainer only works with contiguous containers");
+    using TBuffer = typename Types::TBuffer;
+
+    const auto size = traits::ContainerTraits<T>::size(obj);
+    assert(size <= _maxSize);
+    details::writeSize(ser.adapter(), size);
+    if (size == 0)
+      return;
+    const auto chunkSize = _chunkSize < size ? _chunkSize : size;
+    details::writeSize(ser.adapter(), chunkSize);
+    const auto chunksCount = (size + chunkSize - 1) / chunkSize;
+
+    eastl::vector<TBuffer> buffers(chunksCount);
+    eastl::vector<size_t> written(chunksCount);
+    parallel_container_details::ChunkFactory<Ser, typename Types::TContext>
+      factory{ ser, chunksCount };
+    auto first = eastl::begin(obj);
+    auto task = [&](size_t index) {
+      const auto begin = index * chunkSize;
+      const auto end = begin + chunkSize < size ? begin + chunkSize : size;
+      factory.run(
+        index,
+        [&](Ser& chunk) {
+          for (auto i = begin; i < end; ++i)
+            fnc(chunk, const_cast<ValueType<T>&>(*(first + DiffType<T>(i))));
+          chunk.adapter().flush();
+          written[index] = chunk.adapter().writtenBytesCount();
+        },
+        buffers[index]);
+    };
+    _executor.parallelFor(chunksCount, task);
+
+    for (auto bytes : written)
+      ser.template value<8>(static_cast<uint64_t>(bytes));
+    for (size_t i = 0; i < chunksCount; ++i)
+      ser.adapter().template writeBuffer<1>(buffers[i].data(), written[i]);
+  }
+
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  {
+    using Types = parallel_container_details::ChunkTypes<Des>;
+    static_assert(Types::IsSupported,
+                  "ParallelContainer only works with InputBufferAdapter");
+    static_assert(parallel_container_details::IsContextSupported<
+                    Des,
+                    typename Types::TContext>::value,
+                  "ParallelContainer supports AllocationBudget only as the "
+                  "whole context, not as part of context tuple");
+    static_assert(traits::ContainerTraits<T>::isContiguous,
+                  "ParallelContainer only works with contiguous containers");
+    using TIterator = typename Types::TIterator;
+    using CheckErrors =
+      eastl::integral_constant<bool, Des::TConfig::CheckDataErrors>;
+
+    size_t size{};
+    details::readSize(des.adapter(), size, _maxSize, CheckErrors{});
+    details::chargeAllocationBudget<ValueType<T>>(des, size);
+    traits::ContainerTraits<T>::resize(obj, size);
+    if (size == 0)
+      return;
+    size_t chunkSize{};
+    details::readSize(des.adapter(), chunkSize, size, CheckErrors{});
+    if (chunkSize == 0) {
+      des.adapter().error(ReaderError::InvalidData);
+      return;
+    }
+    const auto chunksCount = (size + chunkSize - 1) / chunkSize;
+
+    eastl::vector<uint64_t> bytes(chunksCount);
+    for (auto& b : bytes)
+      des.template value<8>(b);
+    eastl::vector<TIterator> chunks(chunksCount);
+    for (size_t i = 0; i < chunksCount; ++i) {
+      if (bytes[i] > static_cast<uint64_t>(static_cast<size_t>(-1))) {
+        des.adapter().error(ReaderError::InvalidData);
+        return;
+      }
+      chunks[i] = des.adapter().skipBytes(static_cast<size_t>(bytes[i]));
+    }
+    if (des.adapter().error() != ReaderError::NoError)
+      return;
+
+    eastl::vector<ReaderError> errors(chunksCount, ReaderError::NoError);
+    parallel_container_details::ChunkFactory<Des, typename Types::TContext>
+      factory{ des, chunksCount };
+    auto first = eastl::begin(obj);
+    auto task = [&](size_t index) {
+      const auto begin = index * chunkSize;
+      const auto end = begin + chunkSize < size ? begin + chunkSize : size;
+      factory.run(
+        index,
+        [&](Des& chunk) {
+          for (auto i = begin; i < end; ++i)
+            fnc(chunk, *(first + DiffType<T>(i)));
+          auto error = chunk.adapter().error();
+          if (error == ReaderError::NoError &&
+              !chunk.adapter().isCompletedSuccessfully())
+            error = ReaderError::InvalidData;
+          errors[index] = error;
+        },
+        chunks[index],
+        static_cast<size_t>(bytes[index]));
+    };
+    _executor.parallelFor(chunksCount, task);
+
+    for (auto error : errors) {
+      if (error != ReaderError::NoError) {
+        des.adapter().error(error);
+        return;
+      }
+    }
+    if (!factory.merge())
+      des.adapter().error(ReaderError::InvalidData);
+  }
+
+private:
+  template<typename T>
+  using ValueType = typename traits::ContainerTraits<T>::TValue;
+
+  template<typename T>
+  using DiffType = typename eastl::iterator_traits<
+    decltype(eastl::begin(eastl::declval<T&>()))>::difference_type;
+
+  ParallelExecutor& _executor;
+  size_t _maxSize;
+  size_t _chunkSize;
+};
+
+}
+
+namespace traits {
+
+template<typename T>
+struct ExtensionTraits<ext::ParallelContainer, T>
+{
+  using TValue = typename ContainerTraits<T>::TValue;
+  static constexpr bool SupportValueOverload = true;
+  static constexpr bool SupportObjectOverload = true;
+  static constexpr bool SupportLambdaOverload = true;
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_PARALLEL_CONTAINER_H
@@ -128,7 +128,7 @@ struct NonPtrManager
   // this code is unreachable for reference type, but is necessary to compile
   // LCOV_EXCL_START
 
-  static void create(T&, MemResourceBase*, size_t) {}
+  static void create(T&, pointer_utils::PolyAllocWithTypeId, size_t) {}
 
   static void createPolymorphic(T&, MemResourceBase*, PolymorphicHandlerBase&)
   {
@@ -179,7 +179,19 @@ using PointerOwnerBase =
                                             PolymorphicContext,
                                             RTTI>;
 
-using PointerOwner = PointerOwnerBase<StandardRTTI>;
+using PointerOwner = PointerOwnerBase<DefaultRTTI>;
+
+// same as PointerOwner, but doesn't register pointer in pointer linking
+// context, so it doesn't require it, but this pointer cannot be observed by
+// PointerObserver
+template<typename RTTI>
+using UntrackedPointerOwnerBase =
+  pointer_utils::PointerObjectExtensionBase<pointer_details::PtrOwnerManager,
+                                            PolymorphicContext,
+                                            RTTI,
+                                            false>;
+
+using UntrackedPointerOwner = UntrackedPointerOwnerBase<DefaultRTTI>;
 
 using PointerObserver =
   pointer_utils::PointerObjectExtensionBase<pointer_details::PtrObserverManager,
@@ -219,6 +231,12 @@ struct ExtensionTraits<ext::PointerOwnerBase<RTTI>, T*>
     !RTTI::template isPolymorphic<TValue>();
 };
 
+template<typename T, typename RTTI>
+struct ExtensionTraits<ext::UntrackedPointerOwnerBase<RTTI>, T*>
+  : ExtensionTraits<ext::PointerOwnerBase<RTTI>, T*>
+{
+};
+
 template<typename T>
 struct ExtensionTraits<ext::PointerObserver, T*>
 {
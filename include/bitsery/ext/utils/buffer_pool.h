@@ -0,0 +1,354 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_BUFFER_POOL_H
+#define BITSERY_EXT_BUFFER_POOL_H
+
+#include "../../adapter/buffer.h"
+#include "../../serializer.h"
+#include "memory_resource.h"
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace bitsery {
+namespace ext {
+
+// allocations of at least `threshold` bytes are backed by transparent huge
+// pages (mmap + madvise(MADV_HUGEPAGE), size rounded up to 2MB), smaller ones
+// go to upstream resource. on other platforms everything goes to upstream.
+// use it for big pooled output buffers, e.g. via MemResourceEastlAllocator.
+class MemResourceHugePages final : public MemResourceBase
+{
+public:
+  static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+  explicit MemResourceHugePages(size_t threshold = HugePageSize / 2,
+                                MemResourceBase* upstream = nullptr)
+    : _threshold{ threshold }
+    , _upstream{ upstream }
+  {
+  }
+
+  MemResourceHugePages(const MemResourceHugePages&) = delete;
+  MemResourceHugePages& operator=(const MemResourceHugePages&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+#if defined(__linux__)
+    if (bytes >= _threshold) {
+      auto ptr = mmap(nullptr,
+                      roundUp(bytes),
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1,
+                      0);
+      if (ptr == MAP_FAILED)
+        throw std::bad_alloc{};
+#if defined(MADV_HUGEPAGE)
+      madvise(ptr, roundUp(bytes), MADV_HUGEPAGE);
+#endif
+      return ptr;
+    }
+#endif
+    return _upstream
+             ? _upstream->allocate(bytes, alignment, typeId)
+             : MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+#if defined(__linux__)
+    if (bytes >= _threshold) {
+      munmap(ptr, roundUp(bytes));
+      return;
+    }
+#endif
+    _upstream
+      ? _upstream->deallocate(ptr, bytes, alignment, typeId)
+      : MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  ~MemResourceHugePages() noexcept final = default;
+
+private:
+  static size_t roundUp(size_t bytes)
+  {
+    return (bytes + HugePageSize - 1) & ~(HugePageSize - 1);
+  }
+
+  size_t _threshold;
+  MemResourceBase* _upstream;
+};
+
+template<typename Buffer>
+class BufferPool;
+
+// buffer borrowed from BufferPool, returns it back to the pool when destroyed.
+// must be destroyed on the thread that acquired it, use release() to take
+// buffer out of the pool, e.g. when it is sent from another thread.
+template<typename Buffer>
+class BufferLease
+{
+public:
+  BufferLease() = default;
+
+  BufferLease(BufferPool<Buffer>& pool, Buffer&& buffer)
+    : _pool{ &pool }
+    , _buffer{ eastl::move(buffer) }
+  {
+  }
+
+  BufferLease(const BufferLease&) = delete;
+  BufferLease& operator=(const BufferLease&) = delete;
+
+  BufferLease(BufferLease&& other) noexcept
+    : _pool{ other._pool }
+    , _buffer{ eastl::move(other._buffer) }
+    , _size{ other._size }
+  {
+    other._pool = nullptr;
+    other._size = 0;
+  }
+
+  BufferLease& operator=(BufferLease&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      _pool = other._pool;
+      _buffer = eastl::move(other._buffer);
+      _size = other._size;
+      other._pool = nullptr;
+      other._size = 0;
+    }
+    return *this;
+  }
+
+  ~BufferLease() { reset(); }
+
+  // whole buffer, it can be bigger than written data
+  Buffer& buffer() { return _buffer; }
+
+  const Buffer& buffer() const { return _buffer; }
+
+  // written bytes count
+  size_t size() const { return _size; }
+
+  void size(size_t size) { _size = size; }
+
+  const typename Buffer::value_type* data() const { return _buffer.data(); }
+
+  bool isValid() const { return _pool != nullptr; }
+
+  // returns buffer back to the pool
+  void reset()
+  {
+    if (_pool) {
+      _pool->recycle(eastl::move(_buffer));
+      _pool = nullptr;
+      _size = 0;
+    }
+  }
+
+  // takes buffer out of the pool, it will not be recycled
+  Buffer release()
+  {
+    _pool = nullptr;
+    _size = 0;
+    return eastl::move(_buffer);
+  }
+
+private:
+  BufferPool<Buffer>* _pool{};
+  Buffer _buffer{};
+  size_t _size{};
+};
+
+// pool of pre-reserved output buffers. free buffers keep their size (equal to
+// capacity), so OutputBufferAdapter doesn't need to resize them at all.
+// retained memory is bounded: buffer is destroyed instead of recycled, when
+// pool already has maxBuffers, or it would exceed maxRetainedBytes.
+// buffers are created with allocator constructed from memResource, if buffer
+// allocator supports it (e.g. MemResourceEastlAllocator with
+// MemResourceHugePages).
+// not thread safe, use local() to get pool for current thread.
+template<typename Buffer = eastl::vector<uint8_t>>
+class BufferPool
+{
+public:
+  explicit BufferPool(size_t maxRetainedBytes = 64 * 1024 * 1024,
+                      size_t maxBuffers = 64,
+                      size_t initialCapacity = 4096,
+                      MemResourceBase* memResource = nullptr)
+    : _maxRetainedBytes{ maxRetainedBytes }
+    , _maxBuffers{ maxBuffers }
+    , _initialCapacity{ initialCapacity }
+    , _memResource{ memResource }
+    , _free{ pointer_utils::StdPolyAlloc<Buffer>{ memResource } }
+  {
+    _free.reserve(maxBuffers);
+  }
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  BufferLease<Buffer> acquire()
+  {
+    if (_free.empty()) {
+      ++_created;
+      auto buffer = createBuffer(
+        eastl::is_constructible<typename Buffer::allocator_type,
+                                MemResourceBase*>{});
+      traits::ContainerTraits<Buffer>::resize(buffer, _initialCapacity);
+      return BufferLease<Buffer>{ *this, eastl::move(buffer) };
+    }
+    ++_reused;
+    BufferLease<Buffer> res{ *this, eastl::move(_free.back()) };
+    _free.pop_back();
+    _retainedBytes -= capacityOf(res.buffer());
+    return res;
+  }
+
+  // called by BufferLease
+  void recycle(Buffer&& buffer)
+  {
+    const auto capacity = capacityOf(buffer);
+    if (_free.size() >= _maxBuffers ||
+        capacity > _maxRetainedBytes - _retainedBytes) {
+      ++_dropped;
+      return;
+    }
+    // make all capacity available for writing
+    if (traits::ContainerTraits<Buffer>::size(buffer) < capacity)
+      traits::ContainerTraits<Buffer>::resize(buffer, capacity);
+    _free.push_back(eastl::move(buffer));
+    _retainedBytes += capacity;
+  }
+
+  // destroys all free buffers
+  void clear()
+  {
+    _free.clear();
+    _retainedBytes = 0;
+  }
+
+  void limits(size_t maxRetainedBytes, size_t maxBuffers)
+  {
+    _maxRetainedBytes = maxRetainedBytes;
+    _maxBuffers = maxBuffers;
+    _free.reserve(maxBuffers);
+    while (_free.size() > _maxBuffers || _retainedBytes > _maxRetainedBytes) {
+      _retainedBytes -= capacityOf(_free.back());
+      _free.pop_back();
+    }
+  }
+
+  size_t freeBuffers() const { return _free.size(); }
+
+  size_t retainedBytes() const { return _retainedBytes; }
+
+  // buffers that were created, because pool was empty
+  size_t createdCount() const { return _created; }
+
+  // buffers that were handed out from the pool
+  size_t reusedCount() const { return _reused; }
+
+  // buffers that were destroyed, because pool was full
+  size_t droppedCount() const { return _dropped; }
+
+  // pool of current thread, it is destroyed when thread exits
+  static BufferPool& local()
+  {
+    static thread_local BufferPool pool{};
+    return pool;
+  }
+
+private:
+  static size_t capacityOf(const Buffer& buffer)
+  {
+    return buffer.capacity() * sizeof(typename Buffer::value_type);
+  }
+
+  Buffer createBuffer(eastl::true_type)
+  {
+    return Buffer{ typename Buffer::allocator_type{ _memResource } };
+  }
+
+  Buffer createBuffer(eastl::false_type) { return Buffer{}; }
+
+  size_t _maxRetainedBytes;
+  size_t _maxBuffers;
+  size_t _initialCapacity;
+  MemResourceBase* _memResource;
+  eastl::vector<Buffer, pointer_utils::StdPolyAlloc<Buffer>> _free;
+  size_t _retainedBytes{};
+  size_t _created{};
+  size_t _reused{};
+  size_t _dropped{};
+};
+
+// same as quickSerialization, but serializes to buffer from the pool and
+// returns lease, that gives it back to the pool when destroyed
+template<typename Config = DefaultConfig, typename Buffer, typename T>
+BufferLease<Buffer>
+quickSerializationPooled(BufferPool<Buffer>& pool, const T& value)
+{
+  auto lease = pool.acquire();
+  lease.size(quickSerialization(
+    OutputBufferAdapter<Buffer, Config>{ lease.buffer() }, value));
+  return lease;
+}
+
+template<typename Config = DefaultConfig,
+         typename Context,
+         typename Buffer,
+         typename T>
+BufferLease<Buffer>
+quickSerializationPooled(Context& ctx, BufferPool<Buffer>& pool, const T& value)
+{
+  auto lease = pool.acquire();
+  lease.size(quickSerialization(
+    ctx, OutputBufferAdapter<Buffer, Config>{ lease.buffer() }, value));
+  return lease;
+}
+
+// uses BufferPool<Buffer>::local()
+template<typename Buffer = eastl::vector<uint8_t>,
+         typename Config = DefaultConfig,
+         typename T>
+BufferLease<Buffer>
+quickSerializationPooled(const T& value)
+{
+  return quickSerializationPooled<Config>(BufferPool<Buffer>::local(), value);
+}
+
+}
+}
+
+#endif // BITSERY_EXT_BUFFER_POOL_H
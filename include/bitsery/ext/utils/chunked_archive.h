@@ -0,0 +1,459 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_CHUNKED_ARCHIVE_H
+#define BITSERY_EXT_CHUNKED_ARCHIVE_H
+
+#include "../../adapter/buffer.h"
+#include "../../deserializer.h"
+#include "../../serializer.h"
+#include "crc32.h"
+#include "executor.h"
+#include "rtti_utils.h"
+#include "serialize_exact.h"
+#include <EASTL/algorithm.h>
+#include <EASTL/vector.h>
+#include <cassert>
+#include <cstdint>
+
+namespace bitsery {
+
+namespace ext {
+
+// archive layout:
+// * header: magic and version (4 bytes each);
+// * chunks, each one is independently serialized (and optionally compressed)
+//   object;
+// * table of contents: entries count (8 bytes) and fixed size entries (key,
+//   offset, size, raw size, checksum, flags);
+// * trailer: table of contents offset (8 bytes), its checksum and magic (4
+//   bytes each).
+// checksums are crc32c of stored (compressed) bytes.
+
+namespace archive_details {
+
+constexpr uint32_t Magic = 0x41535442u;
+constexpr uint32_t Version = 1u;
+constexpr uint32_t FlagCompressed = 1u;
+constexpr size_t HeaderSize = 8;
+constexpr size_t EntrySize = 40;
+constexpr size_t TrailerSize = 16;
+constexpr size_t DefaultMaxChunkSize = size_t{ 256 } * 1024 * 1024;
+
+}
+
+// key from chunk name, e.g. archiveKey("physics")
+template<size_t N>
+constexpr uint64_t
+archiveKey(const char (&name)[N])
+{
+  return rtti_details::fnv1a(name, N - 1);
+}
+
+inline uint64_t
+archiveKey(const char* name, size_t size)
+{
+  return rtti_details::fnv1a(name, size);
+}
+
+// compresses chunks in ArchiveWriter and decompresses them in ArchiveReader,
+// implement it to plug in compression library.
+// decompress is called from multiple threads when chunks are loaded in
+// parallel.
+class ChunkCodec
+{
+public:
+  // replaces `out` content with compressed data, returns false if chunk should
+  // be stored uncompressed
+  virtual bool compress(const uint8_t* data,
+                        size_t size,
+                        eastl::vector<uint8_t>& out) = 0;
+
+  // decompresses to `out`, that has exactly uncompressed size, returns false
+  // if data is corrupted
+  virtual bool decompress(const uint8_t* data,
+                          size_t size,
+                          uint8_t* out,
+                          size_t outSize) const = 0;
+
+  virtual ~ChunkCodec() noexcept = default;
+};
+
+struct ArchiveEntry
+{
+  uint64_t key;
+  uint64_t offset;
+  // stored size
+  uint64_t size;
+  // uncompressed size
+  uint64_t rawSize;
+  uint32_t checksum;
+  uint32_t flags;
+
+  bool isCompressed() const
+  {
+    return (flags & archive_details::FlagCompressed) != 0;
+  }
+};
+
+// writes archive to output adapter (buffer or stream), chunks are written
+// immediately, table of contents is written by `finish`.
+template<typename OutputAdapter>
+class ArchiveWriter
+{
+public:
+  using TConfig = typename OutputAdapter::TConfig;
+
+  explicit ArchiveWriter(OutputAdapter adapter, ChunkCodec* codec = nullptr)
+    : _ser{ eastl::move(adapter) }
+    , _codec{ codec }
+  {
+    _ser.value4b(archive_details::Magic);
+    _ser.value4b(archive_details::Version);
+  }
+
+  ArchiveWriter(const ArchiveWriter&) = delete;
+  ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+  // serializes value as separate chunk, keys must be unique
+  template<typename T>
+  bool write(uint64_t key, const T& value)
+  {
+    serializeExact<TConfig>(_chunk, value);
+    return writeChunk(key, _chunk.data(), _chunk.size());
+  }
+
+  // same as serializeExact, each pass needs context in the same initial state
+  template<typename Context, typename T>
+  bool write(Context& measureCtx, Context& ctx, uint64_t key, const T& value)
+  {
+    serializeExact<TConfig>(measureCtx, ctx, _chunk, value);
+    return writeChunk(key, _chunk.data(), _chunk.size());
+  }
+
+  // writes already serialized chunk, returns false and writes nothing if
+  // chunk with the same key is already written
+  bool writeChunk(uint64_t key, const uint8_t* data, size_t size)
+  {
+    assert(!_isFinished);
+    const bool isDuplicate =
+      eastl::find_if(_entries.begin(),
+                     _entries.end(),
+                     [key](const ArchiveEntry& e) { return e.key == key; }) !=
+      _entries.end();
+    assert(!isDuplicate);
+    if (isDuplicate)
+      return false;
+    ArchiveEntry entry{ key, _offset, size, size, 0, 0 };
+    if (_codec && _codec->compress(data, size, _compressed) &&
+        _compressed.size() < size) {
+      data = _compressed.data();
+      entry.size = _compressed.size();
+      entry.flags |= archive_details::FlagCompressed;
+    }
+    entry.checksum = crc32c(data, static_cast<size_t>(entry.size));
+    _ser.adapter().template writeBuffer<1>(data,
+                                           static_cast<size_t>(entry.size));
+    _offset += entry.size;
+    _entries.push_back(entry);
+    return true;
+  }
+
+  // writes table of contents and flushes adapter, returns archive size
+  size_t finish()
+  {
+    assert(!_isFinished);
+    _isFinished = true;
+    _chunk.clear();
+    {
+      Serializer<OutputBufferAdapter<eastl::vector<uint8_t>, TConfig>> toc{
+        _chunk
+      };
+      toc.value8b(static_cast<uint64_t>(_entries.size()));
+      for (auto& entry : _entries) {
+        toc.value8b(entry.key);
+        toc.value8b(entry.offset);
+        toc.value8b(entry.size);
+        toc.value8b(entry.rawSize);
+        toc.value4b(entry.checksum);
+        toc.value4b(entry.flags);
+      }
+      toc.adapter().flush();
+      _chunk.resize(toc.adapter().writtenBytesCount());
+    }
+    const auto tocOffset = _offset;
+    _ser.adapter().template writeBuffer<1>(_chunk.data(), _chunk.size());
+    _ser.value8b(tocOffset);
+    _ser.value4b(crc32c(_chunk.data(), _chunk.size()));
+    _ser.value4b(archive_details::Magic);
+    _ser.adapter().flush();
+    return static_cast<size_t>(tocOffset) + _chunk.size() +
+           archive_details::TrailerSize;
+  }
+
+  OutputAdapter& adapter() { return _ser.adapter(); }
+
+private:
+  Serializer<OutputAdapter> _ser;
+  ChunkCodec* _codec;
+  uint64_t _offset{ archive_details::HeaderSize };
+  eastl::vector<ArchiveEntry> _entries{};
+  eastl::vector<uint8_t> _chunk{};
+  eastl::vector<uint8_t> _compressed{};
+  bool _isFinished{};
+};
+
+// reads archive from memory (e.g. MappedFile), only table of contents is read
+// when reader is created, chunks are read (and verified) when they're loaded.
+// chunks can be loaded from multiple threads.
+template<typename Config = DefaultConfig>
+class ArchiveReader
+{
+public:
+  using TInputAdapter =
+    InputBufferAdapter<UncheckedBufferView<uint8_t>, Config>;
+
+  // type erased load of single chunk, used by loadParallel
+  struct LoadRequest
+  {
+    uint64_t key;
+    void* value;
+    eastl::pair<ReaderError, bool> (*load)(const ArchiveReader&,
+                                           uint64_t,
+                                           void*);
+  };
+
+  // maxChunkSize limits uncompressed size of compressed chunk, because it is
+  // allocated before decompression
+  ArchiveReader(const uint8_t* data,
+                size_t size,
+                const ChunkCodec* codec = nullptr,
+                size_t maxChunkSize = archive_details::DefaultMaxChunkSize)
+    : _data{ data }
+    , _size{ size }
+    , _codec{ codec }
+    , _maxChunkSize{ maxChunkSize }
+  {
+    readTableOfContents();
+  }
+
+  ArchiveReader(const ArchiveReader&) = default;
+  ArchiveReader& operator=(const ArchiveReader&) = default;
+
+  // error found in header or table of contents, chunks cannot be loaded if it
+  // is set
+  ReaderError error() const { return _error; }
+
+  // entries sorted by key
+  const eastl::vector<ArchiveEntry>& entries() const { return _entries; }
+
+  const ArchiveEntry* find(uint64_t key) const
+  {
+    auto it = eastl::lower_bound(
+      _entries.begin(),
+      _entries.end(),
+      key,
+      [](const ArchiveEntry& entry, uint64_t k) { return entry.key < k; });
+    return it != _entries.end() && it->key == key ? &*it : nullptr;
+  }
+
+  bool contains(uint64_t key) const { return find(key) != nullptr; }
+
+  // missing chunk or wrong checksum sets InvalidData error
+  template<typename T>
+  eastl::pair<ReaderError, bool> load(uint64_t key, T& value) const
+  {
+    return loadChunk(key, DeserializeChunk<T>{ value });
+  }
+
+  template<typename Context, typename T>
+  eastl::pair<ReaderError, bool> load(Context& ctx,
+                                      uint64_t key,
+                                      T& value) const
+  {
+    return loadChunk(key,
+                     DeserializeChunkWithContext<Context, T>{ ctx, value });
+  }
+
+  template<typename T>
+  static LoadRequest request(uint64_t key, T& value)
+  {
+    return LoadRequest{ key, &value, &loadErased<T> };
+  }
+
+  // loads chunks in parallel, returns result of the first request that failed
+  eastl::pair<ReaderError, bool> loadParallel(ParallelExecutor& executor,
+                                              const LoadRequest* requests,
+                                              size_t count) const
+  {
+    eastl::vector<eastl::pair<ReaderError, bool>> results(count);
+    auto load = [this, requests, &results](size_t i) {
+      results[i] = requests[i].load(*this, requests[i].key, requests[i].value);
+    };
+    executor.parallelFor(count, load);
+    for (auto& res : results) {
+      if (res.first != ReaderError::NoError || !res.second)
+        return res;
+    }
+    return { ReaderError::NoError, true };
+  }
+
+private:
+  template<typename T>
+  struct DeserializeChunk
+  {
+    T& value;
+
+    eastl::pair<ReaderError, bool> operator()(const uint8_t* data,
+                                              size_t size) const
+    {
+      return quickDeserialization(TInputAdapter{ data, size }, value);
+    }
+  };
+
+  template<typename Context, typename T>
+  struct DeserializeChunkWithContext
+  {
+    Context& ctx;
+    T& value;
+
+    eastl::pair<ReaderError, bool> operator()(const uint8_t* data,
+                                              size_t size) const
+    {
+      return quickDeserialization(ctx, TInputAdapter{ data, size }, value);
+    }
+  };
+
+  template<typename T>
+  static eastl::pair<ReaderError, bool> loadErased(const ArchiveReader& reader,
+                                                   uint64_t key,
+                                                   void* value)
+  {
+    return reader.load(key, *static_cast<T*>(value));
+  }
+
+  template<typename Fnc>
+  eastl::pair<ReaderError, bool> loadChunk(uint64_t key, const Fnc& fnc) const
+  {
+    if (_error != ReaderError::NoError)
+      return { _error, false };
+    auto entry = find(key);
+    if (!entry)
+      return { ReaderError::InvalidData, false };
+    if (entry->isCompressed() && (!_codec || entry->rawSize > _maxChunkSize))
+      return { ReaderError::InvalidData, false };
+    const auto data = _data + entry->offset;
+    const auto size = static_cast<size_t>(entry->size);
+    if (crc32c(data, size) != entry->checksum)
+      return { ReaderError::InvalidData, false };
+    if (!entry->isCompressed())
+      return fnc(data, size);
+    eastl::vector<uint8_t> raw{};
+    details::resizeForOverwrite(raw, static_cast<size_t>(entry->rawSize));
+    if (!_codec->decompress(data, size, raw.data(), raw.size()))
+      return { ReaderError::InvalidData, false };
+    return fnc(raw.data(), raw.size());
+  }
+
+  void readTableOfContents()
+  {
+    const size_t headerSize = archive_details::HeaderSize;
+    const size_t trailerSize = archive_details::TrailerSize;
+    const size_t entrySize = archive_details::EntrySize;
+    if (_size < headerSize + 8 + trailerSize)
+      return setError(ReaderError::DataOverflow);
+    uint32_t magic{};
+    uint32_t version{};
+    {
+      Deserializer<TInputAdapter> des{ _data, headerSize };
+      des.value4b(magic);
+      des.value4b(version);
+    }
+    uint64_t tocOffset{};
+    uint32_t tocChecksum{};
+    uint32_t trailerMagic{};
+    {
+      Deserializer<TInputAdapter> des{ _data + _size - trailerSize,
+                                       trailerSize };
+      des.value8b(tocOffset);
+      des.value4b(tocChecksum);
+      des.value4b(trailerMagic);
+    }
+    if (magic != archive_details::Magic || trailerMagic != magic ||
+        version != archive_details::Version)
+      return setError(ReaderError::InvalidData);
+    const auto tocEnd = _size - trailerSize;
+    if (tocOffset < headerSize || tocOffset > tocEnd - 8)
+      return setError(ReaderError::DataOverflow);
+    const auto tocData = _data + tocOffset;
+    const auto tocSize = tocEnd - static_cast<size_t>(tocOffset);
+    if (crc32c(tocData, tocSize) != tocChecksum)
+      return setError(ReaderError::InvalidData);
+
+    Deserializer<TInputAdapter> des{ tocData, tocSize };
+    uint64_t count{};
+    des.value8b(count);
+    if (count != (tocSize - 8) / entrySize || (tocSize - 8) % entrySize != 0)
+      return setError(ReaderError::InvalidData);
+    _entries.resize(static_cast<size_t>(count));
+    for (auto& entry : _entries) {
+      des.value8b(entry.key);
+      des.value8b(entry.offset);
+      des.value8b(entry.size);
+      des.value8b(entry.rawSize);
+      des.value4b(entry.checksum);
+      des.value4b(entry.flags);
+      // chunk must be between header and table of contents
+      if (entry.offset < headerSize || entry.offset > tocOffset ||
+          entry.size > tocOffset - entry.offset ||
+          (!entry.isCompressed() && entry.rawSize != entry.size))
+        return setError(ReaderError::InvalidData);
+    }
+    eastl::sort(_entries.begin(),
+                _entries.end(),
+                [](const ArchiveEntry& a, const ArchiveEntry& b) {
+                  return a.key < b.key;
+                });
+    for (size_t i = 1; i < _entries.size(); ++i) {
+      if (_entries[i - 1].key == _entries[i].key)
+        return setError(ReaderError::InvalidData);
+    }
+  }
+
+  void setError(ReaderError error)
+  {
+    _error = error;
+    _entries.clear();
+  }
+
+  const uint8_t* _data;
+  size_t _size;
+  const ChunkCodec* _codec;
+  size_t _maxChunkSize;
+  eastl::vector<ArchiveEntry> _entries{};
+  ReaderError _error{ ReaderError::NoError };
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_CHUNKED_ARCHIVE_H
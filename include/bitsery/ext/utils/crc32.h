@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_CRC32_H
+#define BITSERY_EXT_CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace bitsery {
+namespace ext {
+
+namespace crc32_details {
+
+// lookup tables for slicing-by-8
+struct Crc32cTable
+{
+  uint32_t values[8][256];
+
+  Crc32cTable()
+    : values{}
+  {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j)
+        crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+      values[0][i] = crc;
+    }
+    for (size_t t = 1; t < 8; ++t) {
+      for (size_t i = 0; i < 256; ++i) {
+        const auto prev = values[t - 1][i];
+        values[t][i] = (prev >> 8) ^ values[0][prev & 0xFFu];
+      }
+    }
+  }
+};
+
+inline const Crc32cTable&
+crc32cTable()
+{
+  static const Crc32cTable table{};
+  return table;
+}
+
+inline uint32_t
+loadLittleEndian(const uint8_t* p)
+{
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+}
+
+// crc32c (castagnoli polynomial), uses SSE4.2 instruction when enabled.
+// pass previous result as `crc` to continue checksum of data that is split
+// into several parts.
+inline uint32_t
+crc32c(const void* data, size_t size, uint32_t crc = 0)
+{
+  auto p = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+#if defined(__SSE4_2__) && defined(__x86_64__)
+  uint64_t crc64 = crc;
+  for (; size >= 8; size -= 8, p += 8) {
+    uint64_t value{};
+    std::memcpy(&value, p, 8);
+    crc64 = _mm_crc32_u64(crc64, value);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size, ++p)
+    crc = _mm_crc32_u8(crc, *p);
+#else
+  const auto& t = crc32_details::crc32cTable().values;
+  for (; size >= 8; size -= 8, p += 8) {
+    const auto lo = crc ^ crc32_details::loadLittleEndian(p);
+    const auto hi = crc32_details::loadLittleEndian(p + 4);
+    crc = t[7][lo & 0xFFu] ^ t[6][(lo >> 8) & 0xFFu] ^
+          t[5][(lo >> 16) & 0xFFu] ^ t[4][lo >> 24] ^ t[3][hi & 0xFFu] ^
+          t[2][(hi >> 8) & 0xFFu] ^ t[1][(hi >> 16) & 0xFFu] ^ t[0][hi >> 24];
+  }
+  for (; size > 0; --size, ++p)
+    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFFu];
+#endif
+  return ~crc;
+}
+
+}
+}
+
+#endif // BITSERY_EXT_CRC32_H
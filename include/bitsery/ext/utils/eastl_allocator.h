@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_EASTL_ALLOCATOR_H
+#define BITSERY_EXT_EASTL_ALLOCATOR_H
+
+#include "memory_resource.h"
+#include <cassert>
+#include <cstddef>
+
+namespace bitsery {
+namespace ext {
+
+// EASTL allocator that forwards to MemResourceBase (typeId is always 0).
+// when allocator is default constructed (or constructed with name only, as
+// EASTL containers do), it uses current memory resource (see
+// currentMemResource), so containers that are created while deserializing
+// pointer extension object (including elements created by
+// ContainerTraits::resize, EastlMap, EastlSet) are allocated from the same
+// resource as nested pointers (object resource with resourcePropagate), and
+// whole tree can be freed at once with e.g. MemResourceMonotonic::release.
+// copies share the same resource, and allocators compare equal only if they
+// use the same resource. over-aligned types are not supported.
+class MemResourceEastlAllocator
+{
+public:
+  explicit MemResourceEastlAllocator(const char* name = "bitsery") noexcept
+    : _resource{ currentMemResource() }
+    , _name{ name }
+  {
+  }
+
+  explicit MemResourceEastlAllocator(MemResourceBase* resource,
+                                     const char* name = "bitsery") noexcept
+    : _resource{ resource }
+    , _name{ name }
+  {
+  }
+
+  MemResourceEastlAllocator(const MemResourceEastlAllocator&) = default;
+
+  MemResourceEastlAllocator(const MemResourceEastlAllocator& other,
+                            const char* name) noexcept
+    : _resource{ other._resource }
+    , _name{ name }
+  {
+  }
+
+  MemResourceEastlAllocator& operator=(const MemResourceEastlAllocator&) =
+    default;
+
+  void* allocate(size_t n, int /*flags*/ = 0)
+  {
+    return allocate(n, Alignment, 0);
+  }
+
+  // deallocate doesn't get alignment, so all allocations use the same one
+  void* allocate(size_t n,
+                 size_t alignment,
+                 size_t /*offset*/,
+                 int /*flags*/ = 0)
+  {
+    assert(alignment <= Alignment);
+    (void)alignment;
+    return _resource ? _resource->allocate(n, Alignment, 0)
+                     : MemResourceNewDelete{}.allocate(n, Alignment, 0);
+  }
+
+  void deallocate(void* p, size_t n) noexcept
+  {
+    _resource ? _resource->deallocate(p, n, Alignment, 0)
+              : MemResourceNewDelete{}.deallocate(p, n, Alignment, 0);
+  }
+
+  const char* get_name() const noexcept { return _name; }
+
+  void set_name(const char* name) noexcept { _name = name; }
+
+  MemResourceBase* getMemResource() const noexcept { return _resource; }
+
+  friend bool operator==(const MemResourceEastlAllocator& lhs,
+                         const MemResourceEastlAllocator& rhs) noexcept
+  {
+    return lhs._resource == rhs._resource;
+  }
+
+  friend bool operator!=(const MemResourceEastlAllocator& lhs,
+                         const MemResourceEastlAllocator& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+private:
+  static constexpr size_t Alignment = alignof(std::max_align_t);
+
+  MemResourceBase* _resource;
+  const char* _name;
+};
+
+}
+}
+
+#endif // BITSERY_EXT_EASTL_ALLOCATOR_H
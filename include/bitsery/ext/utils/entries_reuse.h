@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_ENTRIES_REUSE_H
+#define BITSERY_EXT_ENTRIES_REUSE_H
+
+#include <EASTL/algorithm.h>
+#include <EASTL/functional.h>
+#include <EASTL/vector.h>
+
+namespace bitsery {
+namespace ext {
+
+// helpers for EastlMap and EastlSet, that deserialize into existing container
+// without clearing it: entries with equal keys are updated in place (nodes
+// are kept), entries that are missing from data are erased and new ones are
+// inserted. all algorithms use TEntries accessor that reads next entry to
+// scratch key (and value) and moves it to container.
+namespace entries_reuse_details {
+
+// ordered containers (map, set, multimap, multiset) has key_comp()
+template<typename T>
+struct IsOrderedHelper
+{
+  template<typename Q>
+  static eastl::true_type tester(
+    decltype(eastl::declval<const Q&>().key_comp())*);
+  template<typename Q>
+  static eastl::false_type tester(...);
+  using type = decltype(tester<T>(nullptr));
+};
+
+template<typename T>
+struct IsOrdered : IsOrderedHelper<T>::type
+{
+};
+
+// insert returns pair<iterator, bool> only for containers with unique keys
+template<typename T>
+struct HasUniqueKeys
+  : eastl::is_same<decltype(eastl::declval<T&>().insert(
+                     eastl::declval<const typename T::value_type&>())),
+                   eastl::pair<typename T::iterator, bool>>
+{
+};
+
+// serializer writes ordered container in sorted order, so we can merge it
+// with existing entries in single pass.
+template<typename T, typename TEntries>
+void
+mergeOrdered(T& obj, size_t size, TEntries& entries)
+{
+  auto comp = obj.key_comp();
+  auto it = obj.begin();
+  auto last = obj.end();
+  bool merging = true;
+  for (size_t i = 0; i < size; ++i) {
+    entries.read();
+    if (merging && last != obj.end() &&
+        comp(entries.key(), TEntries::keyOf(*last))) {
+      // data is not sorted, drop entries that are not visited yet, and
+      // insert the rest as usual
+      obj.erase(it, obj.end());
+      merging = false;
+    }
+    if (!merging) {
+      entries.insert(obj, obj.end());
+      continue;
+    }
+    while (it != obj.end() && comp(TEntries::keyOf(*it), entries.key()))
+      it = obj.erase(it);
+    if (it != obj.end() && !comp(entries.key(), TEntries::keyOf(*it))) {
+      entries.update(*it);
+      last = it++;
+    } else {
+      last = entries.insert(obj, it);
+    }
+  }
+  if (merging)
+    obj.erase(it, obj.end());
+}
+
+// unordered container is iterated in hash order, which might be different
+// from container that was serialized, so each key is looked up and visited
+// entries are remembered, to erase the rest.
+// visited entries are stored in thread local scratch buffer (default
+// allocator), that is kept between calls, so container allocator (e.g. arena)
+// is not used. nested containers append to the same buffer after this range
+// and remove their part before returning.
+template<typename T, typename TEntries>
+void
+mergeUnordered(T& obj, size_t size, TEntries& entries)
+{
+  static thread_local eastl::vector<const void*> visited{};
+  const auto begin = visited.size();
+  visited.reserve(begin + size);
+  for (size_t i = 0; i < size; ++i) {
+    entries.read();
+    auto it = obj.find(entries.key());
+    if (it != obj.end())
+      entries.update(*it);
+    else
+      it = entries.insert(obj, obj.end());
+    visited.push_back(eastl::addressof(*it));
+  }
+  auto first = visited.begin() + static_cast<ptrdiff_t>(begin);
+  eastl::less<const void*> less{};
+  eastl::sort(first, visited.end(), less);
+  // data might contain duplicate keys, so count distinct entries
+  auto last = eastl::unique(first, visited.end());
+  if (static_cast<size_t>(last - first) != obj.size()) {
+    for (auto it = obj.begin(); it != obj.end();) {
+      if (eastl::binary_search(first, last, eastl::addressof(*it), less))
+        ++it;
+      else
+        it = obj.erase(it);
+    }
+  }
+  visited.resize(begin);
+}
+
+}
+}
+}
+
+#endif // BITSERY_EXT_ENTRIES_REUSE_H
@@ -0,0 +1,277 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_EXECUTOR_H
+#define BITSERY_EXT_EXECUTOR_H
+
+#include <EASTL/unique_ptr.h>
+#include <EASTL/vector.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace bitsery {
+namespace ext {
+
+// runs independent tasks for parallel extensions, implement it to plug in your
+// own thread pool.
+// tasks must not throw.
+class ParallelExecutor
+{
+public:
+  using TTask = void (*)(void* data, size_t index);
+
+  // calls task(data, i) for each i in [0, count), possibly in parallel, and
+  // returns when all calls have finished
+  virtual void run(size_t count, TTask task, void* data) = 0;
+
+  // number of tasks that can run at the same time
+  virtual size_t concurrency() const = 0;
+
+  template<typename Fnc>
+  void parallelFor(size_t count, Fnc& fnc)
+  {
+    run(
+      count,
+      [](void* data, size_t index) { (*static_cast<Fnc*>(data))(index); },
+      &fnc);
+  }
+
+  virtual ~ParallelExecutor() noexcept = default;
+};
+
+// runs all tasks on calling thread
+class SequentialExecutor final : public ParallelExecutor
+{
+public:
+  void run(size_t count, TTask task, void* data) final
+  {
+    for (size_t i = 0; i < count; ++i)
+      task(data, i);
+  }
+
+  size_t concurrency() const final { return 1; }
+
+  ~SequentialExecutor() noexcept final = default;
+};
+
+// fixed size thread pool, calling thread also runs tasks, so `threads` is the
+// total number of threads that execute tasks (threads - 1 workers are created).
+// tasks are split into equal ranges, one for each thread, so that each thread
+// runs adjacent tasks. when thread finishes its range, it steals half of the
+// remaining range from another thread, so uneven tasks are still balanced.
+// run can be called from multiple threads, calls are executed one at a time,
+// nested calls (from a task) run sequentially on current thread.
+class ThreadPoolExecutor final : public ParallelExecutor
+{
+public:
+  explicit ThreadPoolExecutor(
+    size_t threads = std::thread::hardware_concurrency())
+    : _ranges{ new WorkRange[threads > 1 ? threads : 1] }
+  {
+    for (size_t i = 1; i < threads; ++i)
+      _workers.push_back(std::thread{ [this, i]() { workerLoop(i); } });
+  }
+
+  ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+  ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+  void run(size_t count, TTask task, void* data) final
+  {
+    if (count == 0)
+      return;
+    if (count == 1 || _workers.empty() || isWorkerThread()) {
+      SequentialExecutor{}.run(count, task, data);
+      return;
+    }
+    std::lock_guard<std::mutex> runLock{ _runMutex };
+    // range bounds are 32bit, so huge counts are split into several runs
+    for (size_t offset = 0; offset < count; offset += MaxRunCount) {
+      const auto left = count - offset;
+      runRanges(offset, left < MaxRunCount ? left : MaxRunCount, task, data);
+    }
+  }
+
+  size_t concurrency() const final { return _workers.size() + 1; }
+
+  ~ThreadPoolExecutor() noexcept final
+  {
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      _isStopped = true;
+    }
+    _wakeWorkers.notify_all();
+    for (auto& worker : _workers)
+      worker.join();
+  }
+
+private:
+  static constexpr size_t MaxRunCount = 0xFFFFFFFFu;
+
+  // [begin, end) packed in single atomic, begin in high bits.
+  // ranges only hand out task indexes, everything else is published via mutex,
+  // so relaxed order is enough
+  struct WorkRange
+  {
+    std::atomic<uint64_t> range{};
+    // keep ranges of different threads on separate cache lines
+    char padding[64 - sizeof(std::atomic<uint64_t>)]{};
+  };
+
+  static uint64_t packRange(size_t begin, size_t end)
+  {
+    return (static_cast<uint64_t>(begin) << 32) | end;
+  }
+
+  static size_t rangeBegin(uint64_t range)
+  {
+    return static_cast<size_t>(range >> 32);
+  }
+
+  static size_t rangeEnd(uint64_t range)
+  {
+    return static_cast<size_t>(range & 0xFFFFFFFFu);
+  }
+
+  static bool& isWorkerThread()
+  {
+    static thread_local bool value{};
+    return value;
+  }
+
+  void runRanges(size_t offset, size_t count, TTask task, void* data)
+  {
+    const auto threads = concurrency();
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      _task = task;
+      _data = data;
+      _offset = offset;
+      for (size_t i = 0; i < threads; ++i)
+        _ranges[i].range.store(
+          packRange(count * i / threads, count * (i + 1) / threads),
+          std::memory_order_relaxed);
+      _activeWorkers = _workers.size();
+      ++_generation;
+    }
+    _wakeWorkers.notify_all();
+    isWorkerThread() = true;
+    runTasks(0, task, data, offset);
+    isWorkerThread() = false;
+    std::unique_lock<std::mutex> lock{ _mutex };
+    _workersDone.wait(lock, [this]() { return _activeWorkers == 0; });
+  }
+
+  void runTasks(size_t self, TTask task, void* data, size_t offset)
+  {
+    size_t index{};
+    while (popFront(self, index) || steal(self, index))
+      task(data, offset + index);
+  }
+
+  bool popFront(size_t self, size_t& index)
+  {
+    auto& range = _ranges[self].range;
+    auto value = range.load(std::memory_order_relaxed);
+    while (rangeBegin(value) < rangeEnd(value)) {
+      if (range.compare_exchange_weak(value,
+                                      value + (uint64_t{ 1 } << 32),
+                                      std::memory_order_relaxed)) {
+        index = rangeBegin(value);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // takes upper half of victim's range, runs its first task and keeps the rest
+  // in own range, which is empty at this point, so no one else modifies it
+  bool steal(size_t self, size_t& index)
+  {
+    const auto threads = concurrency();
+    for (size_t i = 1; i < threads; ++i) {
+      auto& victim = _ranges[(self + i) % threads].range;
+      auto value = victim.load(std::memory_order_relaxed);
+      while (rangeBegin(value) < rangeEnd(value)) {
+        const auto begin = rangeBegin(value);
+        const auto end = rangeEnd(value);
+        const auto mid = begin + (end - begin) / 2;
+        if (victim.compare_exchange_weak(
+              value, packRange(begin, mid), std::memory_order_relaxed)) {
+          _ranges[self].range.store(packRange(mid + 1, end),
+                                    std::memory_order_relaxed);
+          index = mid;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void workerLoop(size_t self)
+  {
+    isWorkerThread() = true;
+    size_t generation{};
+    for (;;) {
+      TTask task{};
+      void* data{};
+      size_t offset{};
+      {
+        std::unique_lock<std::mutex> lock{ _mutex };
+        _wakeWorkers.wait(lock, [this, generation]() {
+          return _isStopped || _generation != generation;
+        });
+        if (_isStopped)
+          return;
+        generation = _generation;
+        task = _task;
+        data = _data;
+        offset = _offset;
+      }
+      runTasks(self, task, data, offset);
+      std::lock_guard<std::mutex> lock{ _mutex };
+      if (--_activeWorkers == 0)
+        _workersDone.notify_one();
+    }
+  }
+
+  eastl::unique_ptr<WorkRange[]> _ranges;
+  eastl::vector<std::thread> _workers{};
+  std::mutex _runMutex{};
+  std::mutex _mutex{};
+  std::condition_variable _wakeWorkers{};
+  std::condition_variable _workersDone{};
+  TTask _task{};
+  void* _data{};
+  size_t _offset{};
+  size_t _activeWorkers{};
+  size_t _generation{};
+  bool _isStopped{};
+};
+
+}
+}
+
+#endif // BITSERY_EXT_EXECUTOR_H
@@ -0,0 +1,155 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_MAPPED_FILE_H
+#define BITSERY_EXT_MAPPED_FILE_H
+
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BITSERY_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define BITSERY_HAS_MMAP 0
+#include <cstdio>
+#endif
+
+namespace bitsery {
+namespace ext {
+
+// read-only file mapped to memory, so that parts of it can be read with
+// InputBufferAdapter without reading whole file.
+// on platforms without mmap whole file is read to memory.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+
+  explicit MappedFile(const char* path) { open(path); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other) noexcept
+    : _data{ other._data }
+    , _size{ other._size }
+    , _isOpen{ other._isOpen }
+    , _content{ eastl::move(other._content) }
+  {
+    other._data = nullptr;
+    other._size = 0;
+    other._isOpen = false;
+  }
+
+  MappedFile& operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other) {
+      close();
+      _data = other._data;
+      _size = other._size;
+      _isOpen = other._isOpen;
+      _content = eastl::move(other._content);
+      other._data = nullptr;
+      other._size = 0;
+      other._isOpen = false;
+    }
+    return *this;
+  }
+
+  // maps whole file, previously mapped file is closed.
+  // returns false if file cannot be opened or mapped
+  bool open(const char* path)
+  {
+    close();
+#if BITSERY_HAS_MMAP
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      return false;
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size > 0) {
+      auto ptr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        ::close(fd);
+        _size = 0;
+        return false;
+      }
+      _data = static_cast<const uint8_t*>(ptr);
+    }
+    // mapping stays valid after descriptor is closed
+    ::close(fd);
+#else
+    auto file = std::fopen(path, "rb");
+    if (!file)
+      return false;
+    uint8_t chunk[4096];
+    for (size_t read = 0;
+         (read = std::fread(chunk, 1, sizeof(chunk), file)) > 0;)
+      _content.insert(_content.end(), chunk, chunk + read);
+    std::fclose(file);
+    _data = _content.data();
+    _size = _content.size();
+#endif
+    _isOpen = true;
+    return true;
+  }
+
+  void close()
+  {
+#if BITSERY_HAS_MMAP
+    if (_size > 0)
+      ::munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+    _content = eastl::vector<uint8_t>{};
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+  }
+
+  bool isOpen() const { return _isOpen; }
+
+  const uint8_t* data() const { return _data; }
+
+  size_t size() const { return _size; }
+
+  ~MappedFile() noexcept { close(); }
+
+private:
+  const uint8_t* _data{};
+  size_t _size{};
+  bool _isOpen{};
+  // used when mmap is not available
+  eastl::vector<uint8_t> _content{};
+};
+
+}
+}
+
+#endif // BITSERY_EXT_MAPPED_FILE_H
@@ -0,0 +1,547 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_MEMORY_POOLS_H
+#define BITSERY_EXT_MEMORY_POOLS_H
+
+#include "memory_resource.h"
+#include "type_id_table.h"
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace bitsery {
+namespace ext {
+
+namespace memory_pools_details {
+
+inline void*
+upstreamAllocate(MemResourceBase* upstream,
+                 size_t bytes,
+                 size_t alignment,
+                 size_t typeId = 0)
+{
+  return upstream ? upstream->allocate(bytes, alignment, typeId)
+                  : MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+}
+
+inline void
+upstreamDeallocate(MemResourceBase* upstream,
+                   void* ptr,
+                   size_t bytes,
+                   size_t alignment,
+                   size_t typeId = 0) noexcept
+{
+  upstream
+    ? upstream->deallocate(ptr, bytes, alignment, typeId)
+    : MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+}
+
+inline uintptr_t
+alignUp(uintptr_t value, size_t alignment)
+{
+  return (value + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+// header of memory chunk that was allocated from upstream resource
+struct alignas(std::max_align_t) Chunk
+{
+  Chunk* next;
+  size_t size;
+
+  uintptr_t begin() { return reinterpret_cast<uintptr_t>(this + 1); }
+
+  uintptr_t end() { return reinterpret_cast<uintptr_t>(this) + size; }
+};
+
+}
+
+// monotonic (bump pointer) memory resource, deallocate does nothing.
+// memory is requested from upstream resource in chunks, each new chunk is
+// twice as big as previous one.
+// release() is O(1), it doesn't free chunks, but rewinds to the first one, so
+// that after first message(frame) deserialization, steady state doesn't
+// allocate at all. destroy all objects before calling release().
+// not thread safe.
+class MemResourceMonotonic final : public MemResourceBase
+{
+public:
+  explicit MemResourceMonotonic(size_t initialChunkSize = 4096,
+                                MemResourceBase* upstream = nullptr)
+    : _upstream{ upstream }
+    , _nextChunkSize{ initialChunkSize < MinChunkSize ? size_t{ MinChunkSize }
+                                                      : initialChunkSize }
+  {
+  }
+
+  // use provided buffer first, before requesting memory from upstream
+  MemResourceMonotonic(void* buffer,
+                       size_t size,
+                       MemResourceBase* upstream = nullptr)
+    : _upstream{ upstream }
+    , _nextChunkSize{ size < MinChunkSize ? size_t{ MinChunkSize } : size * 2 }
+    , _buffer{ reinterpret_cast<uintptr_t>(buffer) }
+    , _bufferSize{ size }
+    , _ptr{ _buffer }
+    , _end{ _buffer + size }
+  {
+  }
+
+  MemResourceMonotonic(const MemResourceMonotonic&) = delete;
+  MemResourceMonotonic& operator=(const MemResourceMonotonic&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment, size_t /*typeId*/) final
+  {
+    auto ptr = memory_pools_details::alignUp(_ptr, alignment);
+    if (ptr + bytes > _end || ptr < _ptr || ptr == 0) {
+      ptr = nextChunk(bytes, alignment);
+    }
+    _ptr = ptr + bytes;
+    _allocatedBytes += bytes;
+    return reinterpret_cast<void*>(ptr);
+  }
+
+  void deallocate(void* /*ptr*/,
+                  size_t /*bytes*/,
+                  size_t /*alignment*/,
+                  size_t /*typeId*/) noexcept final
+  {
+  }
+
+  // rewind to the beginning, all chunks are kept for reuse
+  void release() noexcept
+  {
+    _ptr = _buffer;
+    _end = _buffer + _bufferSize;
+    _nextChunk = _head;
+    _allocatedBytes = 0;
+  }
+
+  // returns all chunks to upstream resource
+  void releaseChunks() noexcept
+  {
+    release();
+    while (_head) {
+      auto chunk = _head;
+      _head = _head->next;
+      _capacity -= chunk->size;
+      memory_pools_details::upstreamDeallocate(
+        _upstream, chunk, chunk->size, alignof(memory_pools_details::Chunk));
+    }
+    _tail = nullptr;
+    _nextChunk = nullptr;
+  }
+
+  // bytes allocated since last release
+  size_t allocatedBytes() const noexcept { return _allocatedBytes; }
+
+  // total size of chunks, requested from upstream resource
+  size_t capacity() const noexcept { return _capacity; }
+
+  ~MemResourceMonotonic() noexcept final { releaseChunks(); }
+
+private:
+  using Chunk = memory_pools_details::Chunk;
+  static constexpr size_t MinChunkSize = 256;
+
+  uintptr_t nextChunk(size_t bytes, size_t alignment)
+  {
+    // chunks are kept after release, so try to reuse them first
+    while (_nextChunk) {
+      auto chunk = _nextChunk;
+      _nextChunk = chunk->next;
+      auto ptr = memory_pools_details::alignUp(chunk->begin(), alignment);
+      if (ptr + bytes <= chunk->end()) {
+        _end = chunk->end();
+        return ptr;
+      }
+    }
+    const auto required = sizeof(Chunk) + bytes + alignment;
+    while (_nextChunkSize < required)
+      _nextChunkSize *= 2;
+    auto chunk = static_cast<Chunk*>(memory_pools_details::upstreamAllocate(
+      _upstream, _nextChunkSize, alignof(Chunk)));
+    chunk->next = nullptr;
+    chunk->size = _nextChunkSize;
+    (_tail ? _tail->next : _head) = chunk;
+    _tail = chunk;
+    _capacity += _nextChunkSize;
+    _nextChunkSize *= 2;
+    _end = chunk->end();
+    return memory_pools_details::alignUp(chunk->begin(), alignment);
+  }
+
+  MemResourceBase* _upstream;
+  size_t _nextChunkSize;
+  uintptr_t _buffer{};
+  size_t _bufferSize{};
+  uintptr_t _ptr{};
+  uintptr_t _end{};
+  Chunk* _head{};
+  Chunk* _tail{};
+  // next chunk to use, when current one is exhausted
+  Chunk* _nextChunk{};
+  size_t _capacity{};
+  size_t _allocatedBytes{};
+};
+
+// pool memory resource with free list for each size class (powers of two, up
+// to MaxBlockSize), blocks are carved from chunks allocated from upstream
+// resource, larger (or over-aligned) allocations go directly to upstream.
+// memory is returned to upstream only in release() or destructor.
+// not thread safe.
+class MemResourcePool final : public MemResourceBase
+{
+public:
+  static constexpr size_t MinBlockSize = 8;
+  static constexpr size_t MaxBlockSize = 1024;
+
+  explicit MemResourcePool(MemResourceBase* upstream = nullptr)
+    : _upstream{ upstream }
+  {
+  }
+
+  MemResourcePool(const MemResourcePool&) = delete;
+  MemResourcePool& operator=(const MemResourcePool&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    if (!isPooled(bytes, alignment))
+      return memory_pools_details::upstreamAllocate(
+        _upstream, bytes, alignment, typeId);
+    auto& pool = _pools[sizeClass(bytes)];
+    if (!pool.free)
+      refill(pool, blockSize(sizeClass(bytes)));
+    auto block = pool.free;
+    pool.free = block->next;
+    return block;
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    if (!isPooled(bytes, alignment)) {
+      memory_pools_details::upstreamDeallocate(
+        _upstream, ptr, bytes, alignment, typeId);
+      return;
+    }
+    auto& pool = _pools[sizeClass(bytes)];
+    auto block = static_cast<Block*>(ptr);
+    block->next = pool.free;
+    pool.free = block;
+  }
+
+  // returns all pooled memory to upstream resource, all objects allocated
+  // from pools must be destroyed before calling it
+  void release() noexcept
+  {
+    while (_chunks) {
+      auto chunk = _chunks;
+      _chunks = _chunks->next;
+      memory_pools_details::upstreamDeallocate(
+        _upstream, chunk, chunk->size, alignof(memory_pools_details::Chunk));
+    }
+    for (auto& pool : _pools)
+      pool = Pool{};
+  }
+
+  ~MemResourcePool() noexcept final { release(); }
+
+private:
+  using Chunk = memory_pools_details::Chunk;
+
+  struct Block
+  {
+    Block* next;
+  };
+
+  struct Pool
+  {
+    Block* free{};
+    // number of blocks in next chunk
+    size_t nextChunkBlocks{ 16 };
+  };
+
+  static constexpr size_t SizeClassesCount = 8;
+  static constexpr size_t MaxChunkBlocks = 1024;
+
+  static bool isPooled(size_t bytes, size_t alignment)
+  {
+    return bytes <= MaxBlockSize && alignment <= alignof(std::max_align_t);
+  }
+
+  static size_t sizeClass(size_t bytes)
+  {
+    size_t res = 0;
+    for (size_t size = MinBlockSize; size < bytes; size *= 2)
+      ++res;
+    return res;
+  }
+
+  static size_t blockSize(size_t sizeClass)
+  {
+    return MinBlockSize << sizeClass;
+  }
+
+  void refill(Pool& pool, size_t blockSize)
+  {
+    const auto count = pool.nextChunkBlocks;
+    if (pool.nextChunkBlocks < MaxChunkBlocks)
+      pool.nextChunkBlocks *= 2;
+    const auto size = sizeof(Chunk) + blockSize * count;
+    auto chunk = static_cast<Chunk*>(memory_pools_details::upstreamAllocate(
+      _upstream, size, alignof(Chunk)));
+    chunk->next = _chunks;
+    chunk->size = size;
+    _chunks = chunk;
+    // link blocks in address order, so that they're handed out sequentially
+    auto begin = chunk->begin();
+    for (size_t i = count; i > 0; --i) {
+      auto block = reinterpret_cast<Block*>(begin + (i - 1) * blockSize);
+      block->next = pool.free;
+      pool.free = block;
+    }
+  }
+
+  MemResourceBase* _upstream;
+  Chunk* _chunks{};
+  Pool _pools[SizeClassesCount]{};
+};
+
+// statistics of single type in MemResourceSlab
+struct SlabTypeStats
+{
+  size_t typeId;
+  size_t objectSize;
+  // currently allocated objects
+  size_t liveObjects;
+  // max live objects at once
+  size_t peakObjects;
+  // total number of allocations
+  size_t allocations;
+  // number of slabs and total objects capacity in them
+  size_t slabs;
+  size_t capacity;
+};
+
+// slab memory resource keyed by typeId, that is passed by pointer extensions
+// when creating objects (PolyAllocWithTypeId::newObject).
+// each type has its own pool of fixed size objects, allocated in slabs (chunks)
+// from upstream resource, so freed objects are recycled without going to
+// upstream and objects of the same type are close together in memory.
+// internal allocations (typeId is 0), arrays and over-aligned types go
+// directly to upstream resource.
+// memory is returned to upstream only in release() or destructor.
+// not thread safe.
+class MemResourceSlab final : public MemResourceBase
+{
+public:
+  explicit MemResourceSlab(MemResourceBase* upstream = nullptr)
+    : _upstream{ upstream }
+    , _types{ pointer_utils::StdPolyAlloc<TypeSlab>{ upstream } }
+    , _typeIds{ upstream }
+  {
+  }
+
+  MemResourceSlab(const MemResourceSlab&) = delete;
+  MemResourceSlab& operator=(const MemResourceSlab&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    auto type = typeId ? findOrAddType(typeId, bytes, alignment) : nullptr;
+    if (!type || type->stats.objectSize != bytes)
+      return memory_pools_details::upstreamAllocate(
+        _upstream, bytes, alignment, typeId);
+    if (!type->free)
+      refill(*type);
+    auto block = type->free;
+    type->free = block->next;
+    auto& stats = type->stats;
+    ++stats.allocations;
+    if (++stats.liveObjects > stats.peakObjects)
+      stats.peakObjects = stats.liveObjects;
+    return block;
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    auto type = typeId ? findType(typeId) : nullptr;
+    if (!type || type->stats.objectSize != bytes) {
+      memory_pools_details::upstreamDeallocate(
+        _upstream, ptr, bytes, alignment, typeId);
+      return;
+    }
+    auto block = static_cast<Block*>(ptr);
+    block->next = type->free;
+    type->free = block;
+    --type->stats.liveObjects;
+  }
+
+  // returns nullptr if type was never allocated
+  const SlabTypeStats* stats(size_t typeId) const
+  {
+    auto type = findType(typeId);
+    return type ? &type->stats : nullptr;
+  }
+
+  template<typename Fnc>
+  void forEachStats(Fnc&& fnc) const
+  {
+    for (const auto& type : _types)
+      fnc(type.stats);
+  }
+
+  // returns all slabs to upstream resource, all objects must be destroyed
+  // before calling it
+  void release() noexcept
+  {
+    for (auto& type : _types) {
+      while (type.slabs) {
+        auto slab = type.slabs;
+        type.slabs = slab->next;
+        memory_pools_details::upstreamDeallocate(
+          _upstream, slab, slab->size, alignof(memory_pools_details::Chunk));
+      }
+      type.free = nullptr;
+      type.nextSlabObjects = MinSlabObjects;
+      type.stats.liveObjects = 0;
+      type.stats.slabs = 0;
+      type.stats.capacity = 0;
+    }
+  }
+
+  ~MemResourceSlab() noexcept final { release(); }
+
+private:
+  using Chunk = memory_pools_details::Chunk;
+
+  static constexpr size_t MinSlabObjects = 16;
+  static constexpr size_t MaxSlabObjects = 1024;
+
+  struct Block
+  {
+    Block* next;
+  };
+
+  struct TypeSlab
+  {
+    SlabTypeStats stats;
+    size_t blockSize;
+    size_t nextSlabObjects;
+    Block* free;
+    Chunk* slabs;
+  };
+
+  TypeSlab* findType(size_t typeId) const
+  {
+    auto index = _typeIds.find(typeId);
+    return index ? const_cast<TypeSlab*>(&_types[*index]) : nullptr;
+  }
+
+  TypeSlab* findOrAddType(size_t typeId, size_t bytes, size_t alignment)
+  {
+    if (auto type = findType(typeId))
+      return type;
+    if (alignment > alignof(std::max_align_t))
+      return nullptr;
+    // block must fit free list pointer and keep alignment of next block
+    auto blockSize = bytes < sizeof(Block) ? sizeof(Block) : bytes;
+    blockSize = static_cast<size_t>(memory_pools_details::alignUp(
+      blockSize, alignment < alignof(Block) ? alignof(Block) : alignment));
+    _typeIds.insert(typeId, _types.size());
+    _types.push_back(TypeSlab{ SlabTypeStats{ typeId, bytes, 0, 0, 0, 0, 0 },
+                               blockSize,
+                               MinSlabObjects,
+                               nullptr,
+                               nullptr });
+    return &_types.back();
+  }
+
+  void refill(TypeSlab& type)
+  {
+    const auto count = type.nextSlabObjects;
+    if (type.nextSlabObjects < MaxSlabObjects)
+      type.nextSlabObjects *= 2;
+    const auto size = sizeof(Chunk) + type.blockSize * count;
+    auto slab = static_cast<Chunk*>(memory_pools_details::upstreamAllocate(
+      _upstream, size, alignof(Chunk)));
+    slab->next = type.slabs;
+    slab->size = size;
+    type.slabs = slab;
+    ++type.stats.slabs;
+    type.stats.capacity += count;
+    // link blocks in address order, so that they're handed out sequentially
+    auto begin = slab->begin();
+    for (size_t i = count; i > 0; --i) {
+      auto block = reinterpret_cast<Block*>(begin + (i - 1) * type.blockSize);
+      block->next = type.free;
+      type.free = block;
+    }
+  }
+
+  MemResourceBase* _upstream;
+  eastl::vector<TypeSlab, pointer_utils::StdPolyAlloc<TypeSlab>> _types;
+  details::TypeIdTable _typeIds;
+};
+
+// forwards to thread local instance of TResource (e.g. MemResourcePool or
+// MemResourceMonotonic), so that multiple threads can use same (stateless)
+// resource without synchronization. there is one TResource instance per
+// thread, it is destroyed when thread exits.
+// memory must be deallocated on the same thread that allocated it, and objects
+// must not outlive the thread.
+template<typename TResource = MemResourcePool>
+class MemResourceThreadLocal final : public MemResourceBase
+{
+public:
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    return local().allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    local().deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  // resource of current thread, e.g. to call release() at the end of frame
+  static TResource& local()
+  {
+    static thread_local TResource resource{};
+    return resource;
+  }
+
+  ~MemResourceThreadLocal() noexcept final = default;
+};
+
+}
+}
+
+#endif // BITSERY_EXT_MEMORY_POOLS_H
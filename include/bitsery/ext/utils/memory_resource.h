@@ -23,6 +23,7 @@
 #ifndef BITSERY_EXT_MEMORY_RESOURCE_H
 #define BITSERY_EXT_MEMORY_RESOURCE_H
 
+#include "../../details/allocation_budget.h"
 #include "../../details/serialization_common.h"
 #include <new>
 
@@ -70,16 +71,53 @@ public:
   ~MemResourceNewDelete() noexcept final = default;
 };
 
+// memory resource for allocator aware types, that are default constructed
+// (e.g. containers with MemResourceEastlAllocator).
+// pointer extensions set it to the resource that nested pointers use (pointer
+// resource if it propagates, otherwise context resource), while object is
+// deserialized, so that containers in object subtree are allocated from the
+// same resource. nullptr means MemResourceNewDelete.
+inline MemResourceBase*&
+currentMemResource() noexcept
+{
+  static thread_local MemResourceBase* resource = nullptr;
+  return resource;
+}
+
+// sets current memory resource for the lifetime of the scope
+class MemResourceScope
+{
+public:
+  explicit MemResourceScope(MemResourceBase* resource) noexcept
+    : _prev{ currentMemResource() }
+  {
+    currentMemResource() = resource;
+  }
+
+  MemResourceScope(const MemResourceScope&) = delete;
+  MemResourceScope& operator=(const MemResourceScope&) = delete;
+
+  ~MemResourceScope() noexcept { currentMemResource() = _prev; }
+
+private:
+  MemResourceBase* _prev;
+};
+
 // these classes are used internally by bitsery extensions and and pointer utils
 namespace pointer_utils {
 // this is helper class that stores memory resource and knows how to
 // construct/destroy objects capture this by value for custom deleters, because
-// during deserialization mem resource can be changed
+// during deserialization mem resource can be changed.
+// optional allocation budget is charged for every allocation, if budget is
+// exceeded nothing is allocated and nullptr is returned, so caller must check
+// if budget is exceeded afterwards.
 class PolyAllocWithTypeId final
 {
 public:
-  constexpr PolyAllocWithTypeId(MemResourceBase* memResource = nullptr)
+  constexpr PolyAllocWithTypeId(MemResourceBase* memResource = nullptr,
+                                AllocationBudget* budget = nullptr)
     : _resource{ memResource }
+    , _budget{ budget }
   {
   }
 
@@ -88,6 +126,8 @@ public:
   {
     const auto bytes = sizeof(T) * n;
     constexpr auto alignment = std::alignment_of<T>::value;
+    if (_budget && !_budget->charge(bytes))
+      return nullptr;
     void* ptr =
       _resource
         ? _resource->allocate(bytes, alignment, typeId)
@@ -109,12 +149,15 @@ public:
   T* newObject(size_t typeId) const
   {
     auto ptr = allocate<T>(1, typeId);
-    return ::bitsery::Access::create<T>(ptr);
+    return ptr ? ::bitsery::Access::create<T>(ptr) : nullptr;
   }
 
+  // obj might be nullptr, if it was not created because of budget
   template<typename T>
   void deleteObject(T* obj, size_t typeId) const
   {
+    if (!obj)
+      return;
     obj->~T();
     deallocate(obj, 1, typeId);
   }
@@ -123,6 +166,10 @@ public:
 
   ext::MemResourceBase* getMemResource() const { return _resource; }
 
+  void setBudget(AllocationBudget* budget) { _budget = budget; }
+
+  AllocationBudget* getBudget() const { return _budget; }
+
   bool operator==(const PolyAllocWithTypeId& rhs) const noexcept
   {
     return _resource == rhs._resource;
@@ -135,6 +182,7 @@ public:
 
 private:
   ext::MemResourceBase* _resource;
+  AllocationBudget* _budget;
 };
 
 // this is very similar to c++17 PolymorphicAllocator
@@ -141,16 +141,24 @@ struct PLCInfoDeserializer : PLCInfo
   {
     ownerPtr = ptr;
     assert(ownershipType != PointerOwnershipType::Observer);
+    if (firstObserver) {
+      *firstObserver = ptr;
+      firstObserver = nullptr;
+    }
     for (auto& o : observersList)
       o.get() = ptr;
+    // keep capacity, info might be reused for another owner
     observersList.clear();
-    observersList.shrink_to_fit();
   }
 
   void processObserver(void*(&ptr))
   {
     if (ownerPtr) {
       ptr = ownerPtr;
+    } else if (!firstObserver) {
+      // most pointers have at most one observer before owner is known, so
+      // first observer is stored inline, without allocating list
+      firstObserver = &ptr;
     } else {
       observersList.emplace_back(ptr);
     }
@@ -158,6 +166,7 @@ struct PLCInfoDeserializer : PLCInfo
 
   void* ownerPtr;
   MemResourceBase* memResource;
+  void** firstObserver{};
   eastl::vector<eastl::reference_wrapper<void*>,
               StdPolyAlloc<eastl::reference_wrapper<void*>>>
     observersList;
@@ -227,6 +236,130 @@ private:
     _ptrMap;
 };
 
+// alternative to PointerLinkingContextSerialization, that stores pointer info
+// in flat open-addressing hash table (linear probing) allocated from provided
+// memory resource. clear() is O(1) and keeps capacity, so serializing next
+// message with similar pointers count doesn't allocate.
+// when both contexts are available, pointer extensions prefer this one.
+class PointerLinkingContextSerializationDense
+{
+public:
+  explicit PointerLinkingContextSerializationDense(
+    MemResourceBase* memResource = nullptr)
+    : _currId{ 0 }
+    , _slots{ StdPolyAlloc<Slot>{ memResource } }
+  {
+  }
+
+  PointerLinkingContextSerializationDense(
+    const PointerLinkingContextSerializationDense&) = delete;
+
+  PointerLinkingContextSerializationDense& operator=(
+    const PointerLinkingContextSerializationDense&) = delete;
+
+  PointerLinkingContextSerializationDense(
+    PointerLinkingContextSerializationDense&&) = default;
+
+  PointerLinkingContextSerializationDense& operator=(
+    PointerLinkingContextSerializationDense&&) = default;
+
+  ~PointerLinkingContextSerializationDense() = default;
+
+  const PLCInfoSerializer& getInfoByPtr(const void* ptr,
+                                        PointerOwnershipType ptrType)
+  {
+    // keep load factor at most 1/2
+    if ((_currId + 1) * 2 > _slots.size())
+      grow();
+    auto& slot = findSlot(_slots, ptr);
+    if (slot.generation != _generation) {
+      slot.ptr = ptr;
+      slot.generation = _generation;
+      slot.info = PLCInfoSerializer{ ++_currId, ptrType };
+      return slot.info;
+    }
+    slot.info.update(ptrType);
+    return slot.info;
+  }
+
+  // reserve memory upfront, if number of pointers is known
+  void reserve(size_t pointersCount)
+  {
+    if (pointersCount * 2 > _slots.size())
+      rehash(pointersCount * 2);
+  }
+
+  // resets context for next serialization, but keeps allocated memory
+  void clear()
+  {
+    _currId = 0;
+    // slots from previous generations are treated as empty
+    if (++_generation == 0) {
+      for (auto& slot : _slots)
+        slot.generation = 0;
+      _generation = 1;
+    }
+  }
+
+  // valid, when all pointers have owners.
+  // we cannot serialize pointers, if we haven't serialized objects themselves
+  bool isPointerSerializationValid() const
+  {
+    return eastl::all_of(_slots.begin(), _slots.end(), [this](const Slot& s) {
+      return s.generation != _generation ||
+             s.info.ownershipType == PointerOwnershipType::SharedOwner ||
+             s.info.ownershipType == PointerOwnershipType::Owner;
+    });
+  }
+
+private:
+  struct Slot
+  {
+    const void* ptr{};
+    size_t generation{};
+    PLCInfoSerializer info{ 0, PointerOwnershipType::Observer };
+  };
+
+  using TSlots = eastl::vector<Slot, StdPolyAlloc<Slot>>;
+
+  Slot& findSlot(TSlots& slots, const void* ptr) const
+  {
+    // capacity is always power of two
+    const auto mask = slots.size() - 1;
+    // fibonacci hashing, lower bits of pointer are mostly zeros due to
+    // alignment
+    auto i = static_cast<size_t>(
+      (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) *
+       0x9E3779B97F4A7C15ull) >>
+      32);
+    for (;; ++i) {
+      auto& slot = slots[i & mask];
+      if (slot.generation != _generation || slot.ptr == ptr)
+        return slot;
+    }
+  }
+
+  void grow() { rehash(_slots.empty() ? 64u : _slots.size() * 2); }
+
+  void rehash(size_t minCapacity)
+  {
+    size_t capacity = 64u;
+    while (capacity < minCapacity)
+      capacity *= 2;
+    TSlots slots{ capacity, Slot{}, _slots.get_allocator() };
+    // new slots has generation 0, which is never current generation
+    for (auto& s : _slots) {
+      if (s.generation == _generation)
+        findSlot(slots, s.ptr) = s;
+    }
+    _slots.swap(slots);
+  }
+
+  size_t _currId;
+  size_t _generation{ 1 };
+  TSlots _slots;
+};
+
 class PointerLinkingContextDeserialization
 {
 public:
@@ -296,6 +429,185 @@ private:
                      StdPolyAlloc<eastl::pair<const size_t, PLCInfoDeserializer>>>
     _idMap;
 };
+
+// observers that are waiting for owner are stored in single pool as linked
+// lists, instead of separate vector for each pointer id
+struct PLCObserverNode
+{
+  void** ptr;
+  // index + 1 of next node in pool, 0 means end of list
+  size_t next;
+};
+
+using PLCObserversPool =
+  eastl::vector<PLCObserverNode, StdPolyAlloc<PLCObserverNode>>;
+
+struct PLCInfoDeserializerDense : PLCInfo
+{
+  PLCInfoDeserializerDense(PointerOwnershipType ownershipType_,
+                           MemResourceBase* memResource_)
+    : PLCInfo(ownershipType_)
+    , memResource{ memResource_ } {};
+
+  PLCInfoDeserializerDense(const PLCInfoDeserializerDense&) = delete;
+
+  PLCInfoDeserializerDense(PLCInfoDeserializerDense&&) = default;
+
+  PLCInfoDeserializerDense& operator=(const PLCInfoDeserializerDense&) = delete;
+
+  PLCInfoDeserializerDense& operator=(PLCInfoDeserializerDense&&) = default;
+
+  void processOwner(void* ptr)
+  {
+    ownerPtr = ptr;
+    assert(ownershipType != PointerOwnershipType::Observer);
+    for (auto i = observersHead; i != 0;) {
+      auto& node = (*observersPool)[i - 1];
+      *node.ptr = ptr;
+      i = node.next;
+    }
+    observersHead = 0;
+  }
+
+  void processObserver(void*(&ptr))
+  {
+    if (ownerPtr) {
+      ptr = ownerPtr;
+    } else {
+      observersPool->push_back(PLCObserverNode{ &ptr, observersHead });
+      observersHead = observersPool->size();
+    }
+  }
+
+  void* ownerPtr{};
+  MemResourceBase* memResource;
+  // pool is owned by context, it is updated every time info is accessed
+  PLCObserversPool* observersPool{};
+  size_t observersHead{};
+  eastl::unique_ptr<PointerSharedStateBase, PointerSharedStateDeleter>
+    sharedState{};
+};
+
+// alternative to PointerLinkingContextDeserialization, that stores pointer
+// info in arrays indexed by pointer id.
+// serializer assigns ids sequentially (starting from 1) in the same order as
+// deserializer reads them, so new id is always equal to size + 1, other ids
+// are treated as invalid data.
+// infos are stored in fixed size blocks, that never reallocate, because info
+// is used while nested pointers (that add new infos) are deserialized.
+// when both contexts are available, pointer extensions prefer this one.
+class PointerLinkingContextDeserializationDense
+{
+public:
+  explicit PointerLinkingContextDeserializationDense(
+    MemResourceBase* memResource = nullptr)
+    : _memResource{ memResource }
+    , _blocksResource{ memResource }
+    , _blocks{ StdPolyAlloc<TBlock>{ memResource } }
+    , _observersPool{ StdPolyAlloc<PLCObserverNode>{ memResource } }
+  {
+  }
+
+  PointerLinkingContextDeserializationDense(
+    const PointerLinkingContextDeserializationDense&) = delete;
+
+  PointerLinkingContextDeserializationDense& operator=(
+    const PointerLinkingContextDeserializationDense&) = delete;
+
+  PointerLinkingContextDeserializationDense(
+    PointerLinkingContextDeserializationDense&&) = default;
+
+  PointerLinkingContextDeserializationDense& operator=(
+    PointerLinkingContextDeserializationDense&&) = default;
+
+  ~PointerLinkingContextDeserializationDense() = default;
+
+  // returns nullptr if id is not sequential
+  PLCInfoDeserializerDense* getInfoById(size_t id, PointerOwnershipType ptrType)
+  {
+    if (id - 1 < _size) {
+      auto& ptrInfo = infoAt(id - 1);
+      ptrInfo.update(ptrType);
+      ptrInfo.observersPool = &_observersPool;
+      return &ptrInfo;
+    }
+    if (id != _size + 1)
+      return nullptr;
+    reserve(id);
+    auto& block = _blocks[_size / BlockSize];
+    block.emplace_back(ptrType, _memResource);
+    ++_size;
+    auto& ptrInfo = block.back();
+    ptrInfo.observersPool = &_observersPool;
+    return &ptrInfo;
+  }
+
+  // reserve memory upfront, if number of pointers is known
+  void reserve(size_t pointersCount)
+  {
+    while (_blocks.size() * BlockSize < pointersCount) {
+      _blocks.emplace_back(StdPolyAlloc<PLCInfoDeserializerDense>{
+        _blocksResource });
+      _blocks.back().reserve(BlockSize);
+    }
+  }
+
+  // resets context for next deserialization, but keeps allocated memory.
+  // infos of previous deserialization are destroyed, because they own shared
+  // state, so it is linear in number of pointers, not in capacity.
+  void clear()
+  {
+    for (size_t i = 0; i < _size; i += BlockSize)
+      _blocks[i / BlockSize].clear();
+    _size = 0;
+    _observersPool.clear();
+  }
+
+  void clearSharedState()
+  {
+    for (size_t i = 0; i < _size; ++i)
+      infoAt(i).sharedState.reset();
+  }
+
+  // valid, when all pointers has owners
+  bool isPointerDeserializationValid() const
+  {
+    for (size_t i = 0; i < _size; ++i) {
+      const auto& info = _blocks[i / BlockSize][i % BlockSize];
+      if (info.ownershipType != PointerOwnershipType::SharedOwner &&
+          info.ownershipType != PointerOwnershipType::Owner)
+        return false;
+    }
+    return true;
+  }
+
+  MemResourceBase* getMemResource() noexcept { return _memResource; }
+
+  void setMemResource(MemResourceBase* resource) noexcept
+  {
+    _memResource = resource;
+  }
+
+private:
+  static constexpr size_t BlockSize = 256;
+  using TBlock =
+    eastl::vector<PLCInfoDeserializerDense,
+                  StdPolyAlloc<PLCInfoDeserializerDense>>;
+
+  PLCInfoDeserializerDense& infoAt(size_t index)
+  {
+    return _blocks[index / BlockSize][index % BlockSize];
+  }
+
+  // changed by pointers with resource propagation, used for pointer infos
+  MemResourceBase* _memResource;
+  // blocks are owned by context, so they always use construction resource
+  MemResourceBase* _blocksResource;
+  // every block has capacity of BlockSize, and is filled up to it
+  eastl::vector<TBlock, StdPolyAlloc<TBlock>> _blocks;
+  size_t _size{};
+  PLCObserversPool _observersPool;
+};
 }
 
 // this class is for convenience
@@ -314,12 +626,41 @@ public:
   }
 };
 
+// same as PointerLinkingContext, but uses flat storage for both, serialization
+// and deserialization, that can be reused without reallocations
+class DensePointerLinkingContext
+  : public pointer_utils::PointerLinkingContextSerializationDense
+  , public pointer_utils::PointerLinkingContextDeserializationDense
+{
+public:
+  explicit DensePointerLinkingContext(MemResourceBase* memResource = nullptr)
+    : pointer_utils::PointerLinkingContextSerializationDense(memResource)
+    , pointer_utils::PointerLinkingContextDeserializationDense(memResource){};
+
+  // resets both contexts for next message, but keeps allocated memory
+  void clear()
+  {
+    pointer_utils::PointerLinkingContextSerializationDense::clear();
+    pointer_utils::PointerLinkingContextDeserializationDense::clear();
+  }
+
+  bool isValid() const
+  {
+    return isPointerSerializationValid() && isPointerDeserializationValid();
+  }
+};
+
 namespace pointer_utils {
 
+// when Tracked is false, pointers are not registered in pointer linking
+// context: only presence flag is written and object is serialized inline.
+// this only works for exclusive owners (e.g. raw owning pointer or
+// unique_ptr), and these objects cannot be referenced by observers.
 template<template<typename> class TPtrManager,
          template<typename>
          class TPolymorphicContext,
-         typename RTTI>
+         typename RTTI,
+         bool Tracked = true>
 class PointerObjectExtensionBase
 {
 public:
@@ -348,11 +689,35 @@ public:
   template<typename Ser, typename T, typename Fnc>
   void serialize(Ser& ser, const T& obj, Fnc&& fnc) const
   {
+    serializeObj(ser,
+                 obj,
+                 eastl::forward<Fnc>(fnc),
+                 eastl::integral_constant<bool, Tracked>{});
+  }
 
+  template<typename Des, typename T, typename Fnc>
+  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  {
+    deserializeObj(des,
+                   obj,
+                   eastl::forward<Fnc>(fnc),
+                   eastl::integral_constant<bool, Tracked>{});
+  }
+
+private:
+  template<typename Ser, typename T, typename Fnc>
+  void serializeObj(Ser& ser,
+                    const T& obj,
+                    Fnc&& fnc,
+                    eastl::true_type /*tracked*/) const
+  {
     auto ptr = TPtrManager<T>::getPtr(const_cast<T&>(obj));
     if (ptr) {
-      auto& ctx = ser.template context<
-        pointer_utils::PointerLinkingContextSerialization>();
+      auto& ctx = getSerializationContext(
+        ser,
+        eastl::integral_constant<
+          bool,
+          Ser::template hasContext<PointerLinkingContextSerializationDense>()>{});
       auto& ptrInfo =
         ctx.getInfoByPtr(getBasePtr(ptr), TPtrManager<T>::getOwnership());
       details::writeSize(ser.adapter(), ptrInfo.id);
@@ -366,13 +731,35 @@ public:
     }
   }
 
+  template<typename Ser, typename T, typename Fnc>
+  void serializeObj(Ser& ser,
+                    const T& obj,
+                    Fnc&& fnc,
+                    eastl::false_type /*tracked*/) const
+  {
+    static_assert(TPtrManager<T>::getOwnership() == PointerOwnershipType::Owner,
+                  "untracked pointers must be exclusive owners");
+    auto ptr = TPtrManager<T>::getPtr(const_cast<T&>(obj));
+    bool exists = ptr != nullptr;
+    assert(exists || _ptrType == PointerType::Nullable);
+    ser.boolValue(exists);
+    if (exists)
+      serializeImpl(ser, ptr, eastl::forward<Fnc>(fnc), IsPolymorphic<T>{});
+  }
+
   template<typename Des, typename T, typename Fnc>
-  void deserialize(Des& des, T& obj, Fnc&& fnc) const
+  void deserializeObj(Des& des,
+                      T& obj,
+                      Fnc&& fnc,
+                      eastl::true_type /*tracked*/) const
   {
     size_t id{};
     details::readSize(des.adapter(), id, 0, eastl::false_type{});
-    auto& ctx = des.template context<
-      pointer_utils::PointerLinkingContextDeserialization>();
+    auto& ctx = getDeserializationContext(
+      des,
+      eastl::integral_constant<
+        bool,
+        Des::template hasContext<PointerLinkingContextDeserializationDense>()>{});
     auto prevResource = ctx.getMemResource();
     auto memResource = _resource ? _resource : prevResource;
     // if we have resource and propagate is true, then change current resource
@@ -381,14 +768,24 @@ public:
       ctx.setMemResource(memResource);
     }
     if (id) {
-      auto& ptrInfo = ctx.getInfoById(id, TPtrManager<T>::getOwnership());
-      deserializeImpl(memResource,
-                      ptrInfo,
-                      des,
-                      obj,
-                      eastl::forward<Fnc>(fnc),
-                      IsPolymorphic<T>{},
-                      OwnershipType<TPtrManager<T>::getOwnership()>{});
+      if (auto ptrInfo =
+            getInfoById(ctx, id, TPtrManager<T>::getOwnership())) {
+        // allocation budget is optional, and is charged for every object that
+        // is created by pointer manager
+        PolyAllocWithTypeId alloc{
+          memResource, des.template contextOrNull<AllocationBudget>()
+        };
+        // containers in subtree use the same resource as nested pointers
+        MemResourceScope scope{ subtreeResource(memResource, prevResource) };
+        deserializeImpl(alloc,
+                        *ptrInfo,
+                        des,
+                        obj,
+                        eastl::forward<Fnc>(fnc),
+                        IsPolymorphic<T>{},
+                        OwnershipType<TPtrManager<T>::getOwnership()>{});
+      } else
+        des.adapter().error(ReaderError::InvalidPointer);
     } else {
       if (_ptrType == PointerType::Nullable) {
         if (auto ptr = TPtrManager<T>::getPtr(obj)) {
@@ -402,14 +799,144 @@ public:
     }
   }
 
-private:
+  template<typename Des, typename T, typename Fnc>
+  void deserializeObj(Des& des,
+                      T& obj,
+                      Fnc&& fnc,
+                      eastl::false_type /*tracked*/) const
+  {
+    static_assert(TPtrManager<T>::getOwnership() == PointerOwnershipType::Owner,
+                  "untracked pointers must be exclusive owners");
+    bool exists{};
+    des.boolValue(exists);
+    // linking context is optional, but if it exists, use its memory resource
+    auto prevResource = getContextMemResource(des);
+    auto memResource = _resource ? _resource : prevResource;
+    if (_resource && _resourcePropagate)
+      setContextMemResource(des, memResource);
+    if (exists) {
+      PolyAllocWithTypeId alloc{
+        memResource, des.template contextOrNull<AllocationBudget>()
+      };
+      // containers in subtree use the same resource as nested pointers
+      MemResourceScope scope{ subtreeResource(memResource, prevResource) };
+      deserializeOwner(
+        alloc, des, obj, eastl::forward<Fnc>(fnc), IsPolymorphic<T>{});
+    } else {
+      if (_ptrType == PointerType::Nullable) {
+        if (TPtrManager<T>::getPtr(obj))
+          destroyPtr(memResource, des, obj, IsPolymorphic<T>{});
+      } else
+        des.adapter().error(ReaderError::InvalidPointer);
+    }
+    if (_resource && _resourcePropagate)
+      setContextMemResource(des, prevResource);
+  }
+
+  // resource is propagated to subtree only when resourcePropagate is true,
+  // without resource keep resource of outer scope (if any)
+  MemResourceBase* subtreeResource(MemResourceBase* memResource,
+                                   MemResourceBase* prevResource) const
+  {
+    auto res = _resourcePropagate ? memResource : prevResource;
+    return res ? res : currentMemResource();
+  }
+
+  template<typename Des>
+  static MemResourceBase* getContextMemResource(Des& des)
+  {
+    if (auto ctx = des.template contextOrNull<
+                   PointerLinkingContextDeserializationDense>())
+      return ctx->getMemResource();
+    if (auto ctx =
+          des.template contextOrNull<PointerLinkingContextDeserialization>())
+      return ctx->getMemResource();
+    return nullptr;
+  }
+
+  template<typename Des>
+  static void setContextMemResource(Des& des, MemResourceBase* resource)
+  {
+    if (auto ctx = des.template contextOrNull<
+                   PointerLinkingContextDeserializationDense>())
+      ctx->setMemResource(resource);
+    if (auto ctx =
+          des.template contextOrNull<PointerLinkingContextDeserialization>())
+      ctx->setMemResource(resource);
+  }
+
+  template<typename Ser>
+  static PointerLinkingContextSerializationDense& getSerializationContext(
+    Ser& ser,
+    eastl::true_type /*dense*/)
+  {
+    return ser.template context<PointerLinkingContextSerializationDense>();
+  }
+
+  template<typename Ser>
+  static PointerLinkingContextSerialization& getSerializationContext(
+    Ser& ser,
+    eastl::false_type /*dense*/)
+  {
+    return ser.template context<PointerLinkingContextSerialization>();
+  }
+
+  template<typename Des>
+  static PointerLinkingContextDeserializationDense& getDeserializationContext(
+    Des& des,
+    eastl::true_type /*dense*/)
+  {
+    return des.template context<PointerLinkingContextDeserializationDense>();
+  }
+
+  template<typename Des>
+  static PointerLinkingContextDeserialization& getDeserializationContext(
+    Des& des,
+    eastl::false_type /*dense*/)
+  {
+    return des.template context<PointerLinkingContextDeserialization>();
+  }
+
+  // prefer compile time polymorphic context, then frozen context, if they
+  // exist
+  template<typename S>
+  using TPolymorphicContextFor = typename eastl::conditional<
+    S::template hasContext<StaticPolymorphicContext<RTTI>>(),
+    StaticPolymorphicContext<RTTI>,
+    typename eastl::conditional<
+      S::template hasContext<FrozenPolymorphicContext<RTTI>>(),
+      FrozenPolymorphicContext<RTTI>,
+      TPolymorphicContext<RTTI>>::type>::type;
+
+  template<typename S>
+  static TPolymorphicContextFor<S>& getPolymorphicContext(S& s)
+  {
+    return s.template context<TPolymorphicContextFor<S>>();
+  }
+
+  static PLCInfoDeserializer* getInfoById(
+    PointerLinkingContextDeserialization& ctx,
+    size_t id,
+    PointerOwnershipType ptrType)
+  {
+    return &ctx.getInfoById(id, ptrType);
+  }
+
+  static PLCInfoDeserializerDense* getInfoById(
+    PointerLinkingContextDeserializationDense& ctx,
+    size_t id,
+    PointerOwnershipType ptrType)
+  {
+    return ctx.getInfoById(id, ptrType);
+  }
+
   template<typename Des, typename TObj>
   void destroyPtr(MemResourceBase* memResource,
                   Des& des,
                   TObj& obj,
                   eastl::true_type /*polymorphic*/) const
   {
-    const auto& ctx = des.template context<TPolymorphicContext<RTTI>>();
+    const auto& ctx = getPolymorphicContext(des);
     auto ptr = TPtrManager<TObj>::getPtr(obj);
     TPtrManager<TObj>::destroyPolymorphic(
       obj, memResource, ctx.getPolymorphicHandler(*ptr));
@@ -440,7 +967,7 @@ private:
   template<typename Ser, typename TPtr, typename Fnc>
   void serializeImpl(Ser& ser, TPtr& ptr, Fnc&&, eastl::true_type) const
   {
-    const auto& ctx = ser.template context<TPolymorphicContext<RTTI>>();
+    const auto& ctx = getPolymorphicContext(ser);
     ctx.serialize(ser, *ptr);
   }
 
@@ -450,57 +977,73 @@ private:
     fnc(ser, *ptr);
   }
 
+  // creates (if required) and deserializes object for exclusive owner
   template<typename Des, typename T, typename Fnc>
-  void deserializeImpl(MemResourceBase* memResource,
-                       PLCInfoDeserializer& ptrInfo,
-                       Des& des,
-                       T& obj,
-                       Fnc&&,
-                       eastl::true_type,
-                       OwnershipType<PointerOwnershipType::Owner>) const
+  typename TPtrManager<T>::TElement* deserializeOwner(
+    const PolyAllocWithTypeId& alloc,
+    Des& des,
+    T& obj,
+    Fnc&&,
+    eastl::true_type /*polymorphic*/) const
   {
-    const auto& ctx = des.template context<TPolymorphicContext<RTTI>>();
+    const auto& ctx = getPolymorphicContext(des);
     ctx.deserialize(
       des,
       TPtrManager<T>::getPtr(obj),
-      [&obj,
-       memResource](const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
-        TPtrManager<T>::createPolymorphic(obj, memResource, handler);
+      [&obj, &alloc, &des](
+        const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
+        TPtrManager<T>::createPolymorphic(obj, alloc, handler);
+        checkAllocationBudget(des, alloc);
         return TPtrManager<T>::getPtr(obj);
       },
       [&obj,
-       memResource](const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
-        TPtrManager<T>::destroyPolymorphic(obj, memResource, handler);
+       &alloc](const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
+        TPtrManager<T>::destroyPolymorphic(
+          obj, alloc.getMemResource(), handler);
       });
-    ptrInfo.processOwner(TPtrManager<T>::getPtr(obj));
+    return TPtrManager<T>::getPtr(obj);
   }
 
   template<typename Des, typename T, typename Fnc>
-  void deserializeImpl(MemResourceBase* memResource,
-                       PLCInfoDeserializer& ptrInfo,
-                       Des& des,
-                       T& obj,
-                       Fnc&& fnc,
-                       eastl::false_type,
-                       OwnershipType<PointerOwnershipType::Owner>) const
+  typename TPtrManager<T>::TElement* deserializeOwner(
+    const PolyAllocWithTypeId& alloc,
+    Des& des,
+    T& obj,
+    Fnc&& fnc,
+    eastl::false_type /*polymorphic*/) const
   {
     auto ptr = TPtrManager<T>::getPtr(obj);
-    if (ptr) {
-      fnc(des, *ptr);
-    } else {
+    if (!ptr) {
       TPtrManager<T>::create(
-        obj,
-        memResource,
-        RTTI::template get<typename TPtrManager<T>::TElement>());
+        obj, alloc, RTTI::template get<typename TPtrManager<T>::TElement>());
+      checkAllocationBudget(des, alloc);
       ptr = TPtrManager<T>::getPtr(obj);
-      fnc(des, *ptr);
     }
-    ptrInfo.processOwner(ptr);
+    if (ptr)
+      fnc(des, *ptr);
+    return ptr;
   }
 
-  template<typename Des, typename T, typename Fnc>
-  void deserializeImpl(MemResourceBase* memResource,
-                       PLCInfoDeserializer& ptrInfo,
+  template<typename Des,
+           typename T,
+           typename Fnc,
+           typename isPolymorph,
+           typename TInfo>
+  void deserializeImpl(const PolyAllocWithTypeId& alloc,
+                       TInfo& ptrInfo,
+                       Des& des,
+                       T& obj,
+                       Fnc&& fnc,
+                       isPolymorph polymorph,
+                       OwnershipType<PointerOwnershipType::Owner>) const
+  {
+    ptrInfo.processOwner(
+      deserializeOwner(alloc, des, obj, eastl::forward<Fnc>(fnc), polymorph));
+  }
+
+  template<typename Des, typename T, typename Fnc, typename TInfo>
+  void deserializeImpl(const PolyAllocWithTypeId& alloc,
+                       TInfo& ptrInfo,
                        Des& des,
                        T& obj,
                        Fnc&&,
@@ -508,19 +1051,21 @@ private:
                        OwnershipType<PointerOwnershipType::SharedOwner>) const
   {
     if (!ptrInfo.sharedState) {
-      const auto& ctx = des.template context<TPolymorphicContext<RTTI>>();
+      const auto& ctx = getPolymorphicContext(des);
       ctx.deserialize(
         des,
         TPtrManager<T>::getPtr(obj),
-        [&obj, &ptrInfo, memResource, this](
+        [&obj, &ptrInfo, &alloc, &des, this](
           const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
           TPtrManager<T>::createSharedPolymorphic(
-            createAndGetSharedStateObj<T>(ptrInfo), obj, memResource, handler);
+            createAndGetSharedStateObj<T>(ptrInfo), obj, alloc, handler);
+          checkAllocationBudget(des, alloc);
           return TPtrManager<T>::getPtr(obj);
         },
         [&obj,
-         memResource](const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
-          TPtrManager<T>::destroyPolymorphic(obj, memResource, handler);
+         &alloc](const eastl::shared_ptr<PolymorphicHandlerBase>& handler) {
+          TPtrManager<T>::destroyPolymorphic(
+            obj, alloc.getMemResource(), handler);
         });
       if (!ptrInfo.sharedState)
         TPtrManager<T>::saveToSharedState(
@@ -530,9 +1075,9 @@ private:
     ptrInfo.processOwner(TPtrManager<T>::getPtr(obj));
   }
 
-  template<typename Des, typename T, typename Fnc>
-  void deserializeImpl(MemResourceBase* memResource,
-                       PLCInfoDeserializer& ptrInfo,
+  template<typename Des, typename T, typename Fnc, typename TInfo>
+  void deserializeImpl(const PolyAllocWithTypeId& alloc,
+                       TInfo& ptrInfo,
                        Des& des,
                        T& obj,
                        Fnc&& fnc,
@@ -548,27 +1093,33 @@ private:
         TPtrManager<T>::createShared(
           createAndGetSharedStateObj<T>(ptrInfo),
           obj,
-          memResource,
+          alloc,
           RTTI::template get<typename TPtrManager<T>::TElement>());
+        checkAllocationBudget(des, alloc);
         ptr = TPtrManager<T>::getPtr(obj);
       }
-      fnc(des, *ptr);
+      if (ptr)
+        fnc(des, *ptr);
     }
     TPtrManager<T>::loadFromSharedState(getSharedStateObj<T>(ptrInfo), obj);
     ptrInfo.processOwner(TPtrManager<T>::getPtr(obj));
   }
 
-  template<typename Des, typename T, typename Fnc, typename isPolymorph>
+  template<typename Des,
+           typename T,
+           typename Fnc,
+           typename isPolymorph,
+           typename TInfo>
   void deserializeImpl(
-    MemResourceBase* memResource,
-    PLCInfoDeserializer& ptrInfo,
+    const PolyAllocWithTypeId& alloc,
+    TInfo& ptrInfo,
     Des& des,
     T& obj,
     Fnc&& fnc,
     isPolymorph polymorph,
     OwnershipType<PointerOwnershipType::SharedObserver>) const
   {
-    deserializeImpl(memResource,
+    deserializeImpl(alloc,
                     ptrInfo,
                     des,
                     obj,
@@ -577,9 +1128,13 @@ private:
                     OwnershipType<PointerOwnershipType::SharedOwner>{});
   }
 
-  template<typename Des, typename T, typename Fnc, typename isPolymorphic>
-  void deserializeImpl(MemResourceBase*,
-                       PLCInfoDeserializer& ptrInfo,
+  template<typename Des,
+           typename T,
+           typename Fnc,
+           typename isPolymorphic,
+           typename TInfo>
+  void deserializeImpl(const PolyAllocWithTypeId&,
+                       TInfo& ptrInfo,
                        Des&,
                        T& obj,
                        Fnc&&,
@@ -590,9 +1145,18 @@ private:
       reinterpret_cast<void*&>(TPtrManager<T>::getPtrRef(obj)));
   }
 
-  template<typename T>
+  // when budget is exceeded object is not created, so stop deserialization
+  template<typename Des>
+  static void checkAllocationBudget(Des& des, const PolyAllocWithTypeId& alloc)
+  {
+    auto budget = alloc.getBudget();
+    if (budget && budget->isExceeded())
+      des.adapter().error(ReaderError::InvalidData);
+  }
+
+  template<typename T, typename TInfo>
   typename TPtrManager<T>::TSharedState& createAndGetSharedStateObj(
-    PLCInfoDeserializer& info) const
+    TInfo& info) const
   {
     using TSharedState = typename TPtrManager<T>::TSharedState;
     StdPolyAlloc<TSharedState> alloc{ info.memResource };
@@ -604,9 +1168,9 @@ private:
     return *obj;
   }
 
-  template<typename T>
+  template<typename T, typename TInfo>
   typename TPtrManager<T>::TSharedState& getSharedStateObj(
-    PLCInfoDeserializer& info) const
+    TInfo& info) const
   {
     return static_cast<typename TPtrManager<T>::TSharedState&>(
       *info.sharedState);
@@ -110,6 +110,56 @@ private:
   }
 };
 
+namespace polymorphism_details {
+
+// handler that is only used to destroy object, when serializer type is unknown
+template<typename RTTI, typename TBase, typename TDerived>
+class LifetimeHandler : public PolymorphicHandlerBase
+{
+public:
+  void* create(const pointer_utils::PolyAllocWithTypeId& alloc) const final
+  {
+    return RTTI::template cast<TDerived, TBase>(
+      alloc.newObject<TDerived>(RTTI::template get<TDerived>()));
+  }
+
+  void destroy(const pointer_utils::PolyAllocWithTypeId& alloc,
+               void* ptr) const final
+  {
+    alloc.deleteObject<TDerived>(
+      RTTI::template cast<TBase, TDerived>(static_cast<TBase*>(ptr)),
+      RTTI::template get<TDerived>());
+  }
+
+  // LCOV_EXCL_START
+  void process(void*, void*) const final { assert(false); }
+  // LCOV_EXCL_STOP
+};
+
+template<typename RTTI, typename TSerializer, typename TBase, typename TDerived>
+using StaticHandler =
+  typename eastl::conditional<eastl::is_void<TSerializer>::value,
+                              LifetimeHandler<RTTI, TBase, TDerived>,
+                              PolymorphicHandler<RTTI,
+                                                 TSerializer,
+                                                 TBase,
+                                                 TDerived>>::type;
+
+// handlers are static objects, they are wrapped in shared_ptr without control
+// block, so nothing is allocated and copying handler doesn't modify reference
+// counter.
+template<typename RTTI, typename TSerializer, typename TBase, typename TDerived>
+eastl::shared_ptr<PolymorphicHandlerBase>
+makeStaticHandler()
+{
+  using THandler = StaticHandler<RTTI, TSerializer, TBase, TDerived>;
+  static const THandler handler{};
+  return eastl::shared_ptr<PolymorphicHandlerBase>(
+    eastl::shared_ptr<void>{}, const_cast<THandler*>(&handler));
+}
+
+}
+
 template<typename RTTI>
 class PolymorphicContext
 {
@@ -178,18 +228,12 @@ private:
   template<typename TSerializer, typename TBase, typename TDerived>
   void addToMap(eastl::false_type)
   {
-    using THandler = PolymorphicHandler<RTTI, TSerializer, TBase, TDerived>;
     BaseToDerivedKey key{ RTTI::template get<TBase>(),
                           RTTI::template get<TDerived>() };
-    pointer_utils::StdPolyAlloc<THandler> alloc{ _memResource };
-    auto ptr = alloc.allocate(1);
-    eastl::shared_ptr<THandler> handler(
-      new (ptr) THandler{},
-      [alloc](THandler* data) mutable {
-        data->~THandler();
-        alloc.deallocate(data, 1);
-      },
-      alloc);
+    // handlers are stateless, so static instance is shared by all contexts
+    // instead of allocating one per registered type
+    auto handler = polymorphism_details::
+      makeStaticHandler<RTTI, TSerializer, TBase, TDerived>();
     if (_baseToDerivedMap.emplace(key, eastl::move(handler)).second) {
       auto it = _baseToDerivedArray.find(key.baseHash);
       if (it == _baseToDerivedArray.end()) {
@@ -342,6 +386,9 @@ public:
           destroyFnc(getPolymorphicHandler(*obj));
         }
         obj = createFnc(handler);
+        // nothing is created when allocation budget is exceeded
+        if (!obj)
+          return;
       }
       handler->process(&des, obj);
     } else
@@ -359,6 +406,562 @@ public:
   }
 };
 
+namespace polymorphism_details {
+
+template<typename TList, typename T>
+struct ListContains;
+
+template<typename T>
+struct ListContains<PolymorphicClassesList<>, T> : eastl::false_type
+{
+};
+
+template<typename T, typename T1, typename... Tn>
+struct ListContains<PolymorphicClassesList<T1, Tn...>, T>
+  : eastl::integral_constant<
+      bool,
+      eastl::is_same<T, T1>::value ||
+        ListContains<PolymorphicClassesList<Tn...>, T>::value>
+{
+};
+
+// append T to list, if it is not abstract and is not in list already
+template<typename TList, typename T, bool Append>
+struct ListAppendIf
+{
+  using type = TList;
+};
+
+template<typename... Ts, typename T>
+struct ListAppendIf<PolymorphicClassesList<Ts...>, T, true>
+{
+  using type = PolymorphicClassesList<Ts..., T>;
+};
+
+template<template<typename> class THierarchy,
+         typename TList,
+         typename TDerived>
+struct CollectDerived;
+
+template<template<typename> class THierarchy, typename TList, typename TChilds>
+struct CollectChilds;
+
+template<template<typename> class THierarchy, typename TList>
+struct CollectChilds<THierarchy, TList, PolymorphicClassesList<>>
+{
+  using type = TList;
+};
+
+template<template<typename> class THierarchy,
+         typename TList,
+         typename T1,
+         typename... Tn>
+struct CollectChilds<THierarchy, TList, PolymorphicClassesList<T1, Tn...>>
+{
+  using type = typename CollectChilds<
+    THierarchy,
+    typename CollectDerived<THierarchy, TList, T1>::type,
+    PolymorphicClassesList<Tn...>>::type;
+};
+
+// same order as PolymorphicContext registers classes: TDerived first, then
+// all its childs depth-first, so that derived index is the same for both
+template<template<typename> class THierarchy,
+         typename TList,
+         typename TDerived>
+struct CollectDerived
+{
+  using type = typename CollectChilds<
+    THierarchy,
+    typename ListAppendIf<TList,
+                          TDerived,
+                          !eastl::is_abstract<TDerived>::value &&
+                            !ListContains<TList, TDerived>::value>::type,
+    typename THierarchy<TDerived>::Childs>::type;
+};
+
+template<typename RTTI,
+         typename TSerializer,
+         typename TBase,
+         typename TDerivedList>
+class StaticHandlersTable;
+
+// immutable tables for single base class, created on first use.
+template<typename RTTI,
+         typename TSerializer,
+         typename TBase,
+         typename... TDerived>
+class StaticHandlersTable<RTTI,
+                          TSerializer,
+                          TBase,
+                          PolymorphicClassesList<TDerived...>>
+{
+public:
+  static const StaticHandlersTable& instance()
+  {
+    static const StaticHandlersTable table{};
+    return table;
+  }
+
+  static constexpr size_t size() { return sizeof...(TDerived); }
+
+  const eastl::shared_ptr<PolymorphicHandlerBase>& handler(size_t index) const
+  {
+    return _handlers[index];
+  }
+
+  size_t typeId(size_t index) const { return _typeIds[index]; }
+
+  // returns size() if type is not in the list
+  size_t indexOf(size_t typeId) const
+  {
+    for (auto i = slotIndex(typeId);; i = (i + 1) & (SlotsCount - 1)) {
+      const auto& slot = _slots[i];
+      if (slot.index == 0)
+        return size();
+      if (slot.typeId == typeId)
+        return slot.index - 1;
+    }
+  }
+
+private:
+  static constexpr size_t ArraySize = sizeof...(TDerived) + 1;
+
+  static constexpr size_t slotsCount(size_t n, size_t res = 2)
+  {
+    return res >= n * 2 ? res : slotsCount(n, res * 2);
+  }
+
+  static constexpr size_t SlotsCount = slotsCount(sizeof...(TDerived));
+
+  struct Slot
+  {
+    size_t typeId;
+    // index + 1, 0 means empty slot
+    size_t index;
+  };
+
+  StaticHandlersTable()
+    : _handlers{ makeStaticHandler<RTTI, TSerializer, TBase, TDerived>()...,
+                 {} }
+    , _typeIds{ RTTI::template get<TDerived>()..., 0 }
+    , _slots{}
+  {
+    for (size_t i = 0; i < size(); ++i) {
+      auto slot = slotIndex(_typeIds[i]);
+      while (_slots[slot].index != 0)
+        slot = (slot + 1) & (SlotsCount - 1);
+      _slots[slot] = Slot{ _typeIds[i], i + 1 };
+    }
+  }
+
+  static size_t slotIndex(size_t typeId)
+  {
+    return static_cast<size_t>(
+             (static_cast<uint64_t>(typeId) * 0x9E3779B97F4A7C15ull) >> 32) &
+           (SlotsCount - 1);
+  }
+
+  eastl::shared_ptr<PolymorphicHandlerBase> _handlers[ArraySize];
+  size_t _typeIds[ArraySize];
+  Slot _slots[SlotsCount];
+};
+
+}
+
+// alternative to PolymorphicContext, where class hierarchies are resolved at
+// compile time from PolymorphicBaseClass specializations. it doesn't require
+// registration, doesn't allocate, and lookups are constant time.
+// it writes the same derived indexes as PolymorphicContext, so they are
+// interchangeable.
+// when both contexts are available, pointer extensions use this one.
+template<typename RTTI>
+class StaticPolymorphicContext
+{
+public:
+  template<typename Serializer, typename TBase>
+  void serialize(Serializer& ser, TBase& obj) const
+  {
+    const auto& table = getTable<Serializer, TBase>();
+    auto derivedIndex = table.indexOf(RTTI::template get<TBase>(obj));
+    assert(derivedIndex < table.size());
+    details::writeSize(ser.adapter(), derivedIndex);
+    table.handler(derivedIndex)->process(&ser, &obj);
+  }
+
+  template<typename Deserializer,
+           typename TBase,
+           typename TCreateFnc,
+           typename TDestroyFnc>
+  void deserialize(Deserializer& des,
+                   TBase* obj,
+                   TCreateFnc createFnc,
+                   TDestroyFnc destroyFnc) const
+  {
+    size_t derivedIndex{};
+    details::readSize(des.adapter(), derivedIndex, 0, eastl::false_type{});
+    const auto& table = getTable<Deserializer, TBase>();
+    if (derivedIndex < table.size()) {
+      auto& handler = table.handler(derivedIndex);
+      // if object is null or different type, create new and assign it
+      if (obj == nullptr ||
+          RTTI::template get<TBase>(*obj) != table.typeId(derivedIndex)) {
+        if (obj) {
+          auto prevIndex = table.indexOf(RTTI::template get<TBase>(*obj));
+          assert(prevIndex < table.size());
+          destroyFnc(table.handler(prevIndex));
+        }
+        obj = createFnc(handler);
+        // nothing is created when allocation budget is exceeded
+        if (!obj)
+          return;
+      }
+      handler->process(&des, obj);
+    } else
+      des.adapter().error(ReaderError::InvalidPointer);
+  }
+
+  // returned handler can only be used to create or destroy objects
+  template<typename TBase>
+  const eastl::shared_ptr<PolymorphicHandlerBase>& getPolymorphicHandler(
+    TBase& obj) const
+  {
+    const auto& table = getTable<void, TBase>();
+    auto index = table.indexOf(RTTI::template get<TBase>(obj));
+    assert(index < table.size());
+    return table.handler(index);
+  }
+
+private:
+  template<typename TSerializer, typename TBase>
+  using TTable = polymorphism_details::StaticHandlersTable<
+    RTTI,
+    TSerializer,
+    TBase,
+    typename polymorphism_details::CollectDerived<PolymorphicBaseClass,
+                                                  PolymorphicClassesList<>,
+                                                  TBase>::type>;
+
+  template<typename TSerializer, typename TBase>
+  static const TTable<TSerializer, TBase>& getTable()
+  {
+    return TTable<TSerializer, TBase>::instance();
+  }
+};
+
+// polymorphic context that is built once and then only read.
+// register hierarchies same as in PolymorphicContext and call freeze(), after
+// that it cannot be modified, and single instance can be shared between
+// threads that (de)serialize concurrently, e.g. as a reference in context
+// tuple: eastl::tuple<PointerLinkingContext, FrozenPolymorphicContext<RTTI>&>.
+// lookups are constant time, handlers are static objects (same as in
+// StaticPolymorphicContext) so copying them to smart pointer deleters doesn't
+// modify shared reference counters.
+// it writes the same derived indexes as PolymorphicContext.
+template<typename RTTI>
+class FrozenPolymorphicContext
+{
+public:
+  explicit FrozenPolymorphicContext(MemResourceBase* memResource = nullptr)
+    : _pending{ pointer_utils::StdPolyAlloc<Entry>{ memResource } }
+    , _derived{ pointer_utils::StdPolyAlloc<Derived>{ memResource } }
+    , _bases{ pointer_utils::StdPolyAlloc<BaseSlot>{ memResource } }
+    , _pairs{ pointer_utils::StdPolyAlloc<PairSlot>{ memResource } }
+  {
+  }
+
+  FrozenPolymorphicContext(const FrozenPolymorphicContext&) = delete;
+  FrozenPolymorphicContext& operator=(const FrozenPolymorphicContext&) =
+    delete;
+  FrozenPolymorphicContext(FrozenPolymorphicContext&&) = default;
+  FrozenPolymorphicContext& operator=(FrozenPolymorphicContext&&) = default;
+
+  // same as PolymorphicContext::registerBasesList, only before freeze()
+  template<typename TSerializer,
+           template<typename> class THierarchy = PolymorphicBaseClass,
+           typename T1,
+           typename... Tn>
+  void registerBasesList(PolymorphicClassesList<T1, Tn...>)
+  {
+    assert(!_frozen);
+    add<TSerializer, THierarchy, T1, T1>();
+    registerBasesList<TSerializer, THierarchy>(PolymorphicClassesList<Tn...>{});
+  }
+
+  template<typename TSerializer, template<typename> class THierarchy>
+  void registerBasesList(PolymorphicClassesList<>)
+  {
+  }
+
+  template<typename TSerializer, typename TBase, typename TDerived>
+  void registerSingleBaseBranch()
+  {
+    static_assert(eastl::is_base_of<TBase, TDerived>::value,
+                  "TDerived must be derived from TBase");
+    static_assert(!eastl::is_abstract<TDerived>::value,
+                  "TDerived cannot be abstract");
+    assert(!_frozen);
+    addEntry<TSerializer, TBase, TDerived>(eastl::false_type{});
+  }
+
+  // builds lookup tables, context cannot be modified afterwards.
+  // calling it again does nothing
+  void freeze()
+  {
+    if (_frozen)
+      return;
+    _frozen = true;
+    _pairs.resize(slotsCount(_pending.size()));
+    _bases.resize(_pairs.size());
+    // first occurrence of base->derived pair wins, same as in
+    // PolymorphicContext, derived index is registration order within base
+    for (auto& e : _pending) {
+      auto& pair = findPair(e.baseHash, e.derivedHash);
+      if (pair.pos == 0) {
+        auto& base = findBase(e.baseHash);
+        base.baseHash = e.baseHash;
+        // position is not known yet, only mark slot as used
+        pair = PairSlot{ e.baseHash, e.derivedHash, base.count++, 1 };
+      }
+    }
+    size_t begin = 0;
+    for (auto& base : _bases) {
+      base.begin = begin;
+      begin += base.count;
+    }
+    _derived.resize(begin, Derived{ 0, nullptr });
+    for (auto& e : _pending) {
+      auto& pair = findPair(e.baseHash, e.derivedHash);
+      auto& derived = _derived[findBase(e.baseHash).begin + pair.index];
+      if (derived.handler)
+        continue;
+      derived = Derived{ e.derivedHash, eastl::move(e.handler) };
+      pair.pos = static_cast<size_t>(&derived - _derived.data()) + 1;
+    }
+    _pending.clear();
+    _pending.shrink_to_fit();
+  }
+
+  bool isFrozen() const { return _frozen; }
+
+  template<typename Serializer, typename TBase>
+  void serialize(Serializer& ser, TBase& obj) const
+  {
+    assert(_frozen);
+    const auto& pair =
+      findPair(RTTI::template get<TBase>(), RTTI::template get<TBase>(obj));
+    assert(pair.pos != 0);
+    details::writeSize(ser.adapter(), pair.index);
+    _derived[pair.pos - 1].handler->process(&ser, &obj);
+  }
+
+  template<typename Deserializer,
+           typename TBase,
+           typename TCreateFnc,
+           typename TDestroyFnc>
+  void deserialize(Deserializer& des,
+                   TBase* obj,
+                   TCreateFnc createFnc,
+                   TDestroyFnc destroyFnc) const
+  {
+    // lookup tables are empty until freeze()
+    if (!_frozen) {
+      des.adapter().error(ReaderError::InvalidPointer);
+      return;
+    }
+    size_t derivedIndex{};
+    details::readSize(des.adapter(), derivedIndex, 0, eastl::false_type{});
+    const auto& base = findBase(RTTI::template get<TBase>());
+    if (derivedIndex < base.count) {
+      const auto& derived = _derived[base.begin + derivedIndex];
+      // if object is null or different type, create new and assign it
+      if (obj == nullptr ||
+          RTTI::template get<TBase>(*obj) != derived.typeId) {
+        if (obj) {
+          destroyFnc(getPolymorphicHandler(*obj));
+        }
+        obj = createFnc(derived.handler);
+        // nothing is created when allocation budget is exceeded
+        if (!obj)
+          return;
+      }
+      derived.handler->process(&des, obj);
+    } else
+      des.adapter().error(ReaderError::InvalidPointer);
+  }
+
+  template<typename TBase>
+  const eastl::shared_ptr<PolymorphicHandlerBase>& getPolymorphicHandler(
+    TBase& obj) const
+  {
+    assert(_frozen);
+    const auto& pair =
+      findPair(RTTI::template get<TBase>(), RTTI::template get<TBase>(obj));
+    assert(pair.pos != 0);
+    return _derived[pair.pos - 1].handler;
+  }
+
+private:
+  struct Entry
+  {
+    size_t baseHash;
+    size_t derivedHash;
+    eastl::shared_ptr<PolymorphicHandlerBase> handler;
+  };
+
+  struct Derived
+  {
+    size_t typeId;
+    eastl::shared_ptr<PolymorphicHandlerBase> handler;
+  };
+
+  // count == 0 means empty slot
+  struct BaseSlot
+  {
+    size_t baseHash;
+    size_t begin;
+    size_t count;
+  };
+
+  // pos is position in _derived + 1, 0 means empty slot
+  struct PairSlot
+  {
+    size_t baseHash;
+    size_t derivedHash;
+    size_t index;
+    size_t pos;
+  };
+
+  template<typename TSerializer,
+           template<typename>
+           class THierarchy,
+           typename TBase,
+           typename TDerived>
+  void add()
+  {
+    addEntry<TSerializer, TBase, TDerived>(eastl::is_abstract<TDerived>{});
+    addChilds<TSerializer, THierarchy, TBase, TDerived>(
+      typename THierarchy<TDerived>::Childs{});
+  }
+
+  template<typename TSerializer,
+           template<typename>
+           class THierarchy,
+           typename TBase,
+           typename TDerived,
+           typename T1,
+           typename... Tn>
+  void addChilds(PolymorphicClassesList<T1, Tn...>)
+  {
+    static_assert(eastl::is_base_of<TDerived, T1>::value,
+                  "PolymorphicBaseClass<TBase> must derive a list of derived "
+                  "classes from TBase.");
+    add<TSerializer, THierarchy, TBase, T1>();
+    addChilds<TSerializer, THierarchy, TBase, TDerived>(
+      PolymorphicClassesList<Tn...>{});
+    add<TSerializer, THierarchy, T1, T1>();
+  }
+
+  template<typename TSerializer,
+           template<typename>
+           class THierarchy,
+           typename TBase,
+           typename TDerived>
+  void addChilds(PolymorphicClassesList<>)
+  {
+  }
+
+  template<typename TSerializer, typename TBase, typename TDerived>
+  void addEntry(eastl::false_type)
+  {
+    _pending.push_back(Entry{
+      RTTI::template get<TBase>(),
+      RTTI::template get<TDerived>(),
+      polymorphism_details::
+        makeStaticHandler<RTTI, TSerializer, TBase, TDerived>() });
+  }
+
+  template<typename TSerializer, typename TBase, typename TDerived>
+  void addEntry(eastl::true_type)
+  {
+    // cannot add abstract class
+  }
+
+  static size_t slotsCount(size_t n)
+  {
+    size_t res = 2;
+    while (res < n * 2)
+      res *= 2;
+    return res;
+  }
+
+  size_t slotIndex(uint64_t hash) const
+  {
+    return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) &
+           (_bases.size() - 1);
+  }
+
+  // returns empty slot if not found
+  template<typename TSlots>
+  static auto findBaseImpl(TSlots& slots, size_t slot, size_t baseHash)
+    -> decltype(slots[0])
+  {
+    for (;; slot = (slot + 1) & (slots.size() - 1)) {
+      auto& s = slots[slot];
+      if (s.count == 0 || s.baseHash == baseHash)
+        return s;
+    }
+  }
+
+  template<typename TSlots>
+  static auto findPairImpl(TSlots& slots,
+                           size_t slot,
+                           size_t baseHash,
+                           size_t derivedHash) -> decltype(slots[0])
+  {
+    for (;; slot = (slot + 1) & (slots.size() - 1)) {
+      auto& s = slots[slot];
+      if (s.pos == 0 ||
+          (s.baseHash == baseHash && s.derivedHash == derivedHash))
+        return s;
+    }
+  }
+
+  const BaseSlot& findBase(size_t baseHash) const
+  {
+    return findBaseImpl(_bases, slotIndex(baseHash), baseHash);
+  }
+
+  BaseSlot& findBase(size_t baseHash)
+  {
+    return findBaseImpl(_bases, slotIndex(baseHash), baseHash);
+  }
+
+  size_t pairSlotIndex(size_t baseHash, size_t derivedHash) const
+  {
+    return slotIndex(static_cast<uint64_t>(derivedHash) ^
+                     (static_cast<uint64_t>(baseHash) << 1));
+  }
+
+  const PairSlot& findPair(size_t baseHash, size_t derivedHash) const
+  {
+    return findPairImpl(
+      _pairs, pairSlotIndex(baseHash, derivedHash), baseHash, derivedHash);
+  }
+
+  PairSlot& findPair(size_t baseHash, size_t derivedHash)
+  {
+    return findPairImpl(
+      _pairs, pairSlotIndex(baseHash, derivedHash), baseHash, derivedHash);
+  }
+
+  bool _frozen{ false };
+  eastl::vector<Entry, pointer_utils::StdPolyAlloc<Entry>> _pending;
+  eastl::vector<Derived, pointer_utils::StdPolyAlloc<Derived>> _derived;
+  eastl::vector<BaseSlot, pointer_utils::StdPolyAlloc<BaseSlot>> _bases;
+  eastl::vector<PairSlot, pointer_utils::StdPolyAlloc<PairSlot>> _pairs;
+};
+
 }
 
 }
@@ -0,0 +1,623 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_RECORD_LOG_H
+#define BITSERY_EXT_RECORD_LOG_H
+
+#include "crc32.h"
+#include "mapped_file.h"
+#include "serialize_exact.h"
+
+// record log uses POSIX file api (write, fdatasync, mmap)
+#if BITSERY_HAS_MMAP
+
+#include "../../adapter/buffer.h"
+#include "../../deserializer.h"
+#include "../../serializer.h"
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <mutex>
+#include <thread>
+
+namespace bitsery {
+namespace ext {
+
+// record log is a directory of segment files named by index
+// (00000000000000000000.log, 00000000000000000001.log, ...), each segment is
+// a sequence of records: payload size, crc32c of payload (4 bytes each) and
+// payload. records never span segments, new segment is started when record
+// doesn't fit into current one (or it is bigger than segment size).
+
+namespace record_log_details {
+
+constexpr size_t RecordHeaderSize = 8;
+constexpr size_t DefaultSegmentSize = 64 * 1024 * 1024;
+constexpr uint64_t NoSegment = ~uint64_t{};
+constexpr uint64_t NoSequence = ~uint64_t{};
+constexpr size_t MaxRecordSize = 0xFFFFFFFFu;
+
+inline eastl::string
+segmentPath(const eastl::string& directory, uint64_t index)
+{
+  char name[32];
+  std::snprintf(
+    name, sizeof(name), "/%020llu.log", static_cast<unsigned long long>(index));
+  return directory + name;
+}
+
+// returns lowest or highest segment index in directory, or NoSegment
+inline uint64_t
+findSegment(const eastl::string& directory, bool lowest)
+{
+  auto result = NoSegment;
+  auto dir = ::opendir(directory.c_str());
+  if (!dir)
+    return result;
+  while (auto entry = ::readdir(dir)) {
+    const char* name = entry->d_name;
+    char* end{};
+    const auto index = std::strtoull(name, &end, 10);
+    if (end != name + 20 || std::strcmp(end, ".log") != 0)
+      continue;
+    if (result == NoSegment || (lowest ? index < result : index > result))
+      result = index;
+  }
+  ::closedir(dir);
+  return result;
+}
+
+inline bool
+fileExists(const eastl::string& path)
+{
+  struct stat info;
+  return ::stat(path.c_str(), &info) == 0;
+}
+
+inline bool
+syncFile(int fd)
+{
+#if defined(__APPLE__)
+  return ::fsync(fd) == 0;
+#else
+  return ::fdatasync(fd) == 0;
+#endif
+}
+
+// makes new segment file entry durable
+inline bool
+syncDirectory(const eastl::string& directory)
+{
+  const int fd = ::open(directory.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  const bool res = ::fsync(fd) == 0;
+  ::close(fd);
+  return res;
+}
+
+inline bool
+writeAll(int fd, const uint8_t* data, size_t size)
+{
+  while (size > 0) {
+    const auto written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+template<typename Config>
+struct RecordHeader
+{
+  uint32_t size;
+  uint32_t checksum;
+
+  void write(uint8_t* data) const
+  {
+    UncheckedBufferView<uint8_t> view{ data, RecordHeaderSize };
+    Serializer<OutputBufferAdapter<UncheckedBufferView<uint8_t>, Config>> ser{
+      view
+    };
+    ser.value4b(size);
+    ser.value4b(checksum);
+  }
+
+  static RecordHeader read(const uint8_t* data)
+  {
+    RecordHeader res{};
+    Deserializer<InputBufferAdapter<UncheckedBufferView<uint8_t>, Config>> des{
+      data, RecordHeaderSize
+    };
+    des.value4b(res.size);
+    des.value4b(res.checksum);
+    return res;
+  }
+};
+
+// returns size of valid records prefix, used to drop torn write at the end of
+// the last segment
+template<typename Config>
+size_t
+validRecordsSize(const uint8_t* data, size_t size)
+{
+  size_t offset = 0;
+  while (size - offset >= RecordHeaderSize) {
+    const auto header = RecordHeader<Config>::read(data + offset);
+    if (size - offset - RecordHeaderSize < header.size ||
+        crc32c(data + offset + RecordHeaderSize, header.size) !=
+          header.checksum)
+      break;
+    offset += RecordHeaderSize + header.size;
+  }
+  return offset;
+}
+
+}
+
+// appends records to segmented log.
+// append only copies record to pending buffer, background thread writes
+// pending records and syncs them with single fdatasync (group commit), so
+// records appended while previous batch is being synced are committed
+// together.
+// appending is thread safe, records get sequence numbers in append order
+// (starting from 0 for each writer).
+// when directory already contains log, torn record at the end of the last
+// segment is truncated and appending continues in that segment.
+template<typename Config = DefaultConfig>
+class RecordLogWriter
+{
+public:
+  explicit RecordLogWriter(
+    const char* directory,
+    size_t segmentSize = record_log_details::DefaultSegmentSize)
+    : _directory{ directory }
+    , _segmentSize{ segmentSize }
+  {
+    if (openLastSegment())
+      _flusher = std::thread{ [this]() { flushLoop(); } };
+  }
+
+  RecordLogWriter(const RecordLogWriter&) = delete;
+  RecordLogWriter& operator=(const RecordLogWriter&) = delete;
+
+  // false if log cannot be opened, or writing has failed
+  bool isOpen() const
+  {
+    std::lock_guard<std::mutex> lock{ _mutex };
+    return _fd >= 0 && !_isFailed;
+  }
+
+  template<typename T>
+  uint64_t append(const T& value)
+  {
+    auto& record = scratch();
+    serializeExact<Config>(record, value);
+    return appendRecord(record.data(), record.size());
+  }
+
+  // same as serializeExact, each pass needs context in the same initial state
+  template<typename Context, typename T>
+  uint64_t append(Context& measureCtx, Context& ctx, const T& value)
+  {
+    auto& record = scratch();
+    serializeExact<Config>(measureCtx, ctx, record, value);
+    return appendRecord(record.data(), record.size());
+  }
+
+  // appends already serialized record, returns its sequence number, or
+  // NoSequence if record is bigger than 4 bytes size prefix can represent
+  uint64_t appendRecord(const uint8_t* data, size_t size)
+  {
+    if (size > record_log_details::MaxRecordSize)
+      return record_log_details::NoSequence;
+    uint8_t header[record_log_details::RecordHeaderSize];
+    record_log_details::RecordHeader<Config>{ static_cast<uint32_t>(size),
+                                              crc32c(data, size) }
+      .write(header);
+    const auto recordSize = sizeof(header) + size;
+    uint64_t sequence{};
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      assert(!_isStopped);
+      sequence = _appended++;
+      // record will never be durable, so don't keep it
+      if (_fd < 0 || _isFailed)
+        return sequence;
+      if (_segmentBytes > 0 && _segmentBytes + recordSize > _segmentSize) {
+        _pendingRolls.push_back(_pending.size());
+        _segmentBytes = 0;
+      }
+      _pending.insert(_pending.end(), header, header + sizeof(header));
+      _pending.insert(_pending.end(), data, data + size);
+      _segmentBytes += recordSize;
+    }
+    _hasPending.notify_one();
+    return sequence;
+  }
+
+  // blocks until record is written and synced, returns false if writing failed
+  bool waitDurable(uint64_t sequence)
+  {
+    std::unique_lock<std::mutex> lock{ _mutex };
+    _hasDurable.wait(lock, [this, sequence]() {
+      return _durable > sequence || _isFailed || _fd < 0;
+    });
+    return _durable > sequence;
+  }
+
+  // number of records (from the start of this writer) that are durable
+  uint64_t durableCount() const
+  {
+    std::lock_guard<std::mutex> lock{ _mutex };
+    return _durable;
+  }
+
+  // index of segment that is currently written
+  uint64_t segmentIndex() const
+  {
+    std::lock_guard<std::mutex> lock{ _mutex };
+    return _segment;
+  }
+
+  // writes and syncs all pending records and stops background thread
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      _isStopped = true;
+    }
+    _hasPending.notify_one();
+    if (_flusher.joinable())
+      _flusher.join();
+    std::lock_guard<std::mutex> lock{ _mutex };
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+    _hasDurable.notify_all();
+  }
+
+  ~RecordLogWriter() noexcept { close(); }
+
+private:
+  static eastl::vector<uint8_t>& scratch()
+  {
+    static thread_local eastl::vector<uint8_t> buffer{};
+    return buffer;
+  }
+
+  bool openLastSegment()
+  {
+    ::mkdir(_directory.c_str(), 0755);
+    auto index = record_log_details::findSegment(_directory, false);
+    if (index == record_log_details::NoSegment) {
+      _fd = openSegment(0);
+      _segment = 0;
+      return _fd >= 0;
+    }
+    const auto path = record_log_details::segmentPath(_directory, index);
+    size_t validSize{};
+    {
+      MappedFile file{ path.c_str() };
+      if (!file.isOpen())
+        return false;
+      validSize = record_log_details::validRecordsSize<Config>(file.data(),
+                                                               file.size());
+    }
+    _fd = openSegment(index);
+    if (_fd < 0)
+      return false;
+    _segment = index;
+    if (::ftruncate(_fd, static_cast<off_t>(validSize)) != 0 ||
+        ::lseek(_fd, 0, SEEK_END) < 0) {
+      ::close(_fd);
+      _fd = -1;
+      return false;
+    }
+    _segmentBytes = validSize;
+    return true;
+  }
+
+  // returns file descriptor, or -1 if segment cannot be created
+  int openSegment(uint64_t index) const
+  {
+    const auto path = record_log_details::segmentPath(_directory, index);
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd >= 0 && !record_log_details::syncDirectory(_directory)) {
+      ::close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  // fd and segment are changed only by flusher thread, so slow file
+  // operations are done without the lock, and it is taken only to publish new
+  // segment
+  bool rollSegment()
+  {
+    if (!record_log_details::syncFile(_fd))
+      return false;
+    const int fd = openSegment(_segment + 1);
+    if (fd < 0)
+      return false;
+    const int prevFd = _fd;
+    {
+      std::lock_guard<std::mutex> lock{ _mutex };
+      _fd = fd;
+      ++_segment;
+    }
+    ::close(prevFd);
+    return true;
+  }
+
+  // called from flusher thread only
+  bool writeBatch()
+  {
+    size_t begin = 0;
+    for (auto roll : _writingRolls) {
+      if (!record_log_details::writeAll(_fd, _writing.data() + begin,
+                                        roll - begin) ||
+          !rollSegment())
+        return false;
+      begin = roll;
+    }
+    return record_log_details::writeAll(
+             _fd, _writing.data() + begin, _writing.size() - begin) &&
+           record_log_details::syncFile(_fd);
+  }
+
+  void flushLoop()
+  {
+    for (;;) {
+      uint64_t appended{};
+      {
+        std::unique_lock<std::mutex> lock{ _mutex };
+        _hasPending.wait(
+          lock, [this]() { return _isStopped || !_pending.empty(); });
+        if (_pending.empty())
+          return;
+        eastl::swap(_pending, _writing);
+        eastl::swap(_pendingRolls, _writingRolls);
+        appended = _appended;
+      }
+      const bool isWritten = writeBatch();
+      _writing.clear();
+      _writingRolls.clear();
+      {
+        std::lock_guard<std::mutex> lock{ _mutex };
+        if (isWritten)
+          _durable = appended;
+        else
+          _isFailed = true;
+      }
+      _hasDurable.notify_all();
+      if (!isWritten)
+        return;
+    }
+  }
+
+  eastl::string _directory;
+  size_t _segmentSize;
+  mutable std::mutex _mutex{};
+  std::condition_variable _hasPending{};
+  std::condition_variable _hasDurable{};
+  // records appended, but not yet taken by flusher, and offsets in it where
+  // new segment starts
+  eastl::vector<uint8_t> _pending{};
+  eastl::vector<size_t> _pendingRolls{};
+  // records that flusher is writing
+  eastl::vector<uint8_t> _writing{};
+  eastl::vector<size_t> _writingRolls{};
+  size_t _segmentBytes{};
+  uint64_t _appended{};
+  uint64_t _durable{};
+  uint64_t _segment{};
+  int _fd{ -1 };
+  bool _isStopped{};
+  bool _isFailed{};
+  std::thread _flusher{};
+};
+
+// zero-copy view of record payload, valid until next call to
+// RecordLogReader::next
+struct RecordView
+{
+  const uint8_t* data;
+  size_t size;
+};
+
+// iterates records over memory mapped segments, starting from the lowest
+// segment in directory. when there is no complete record yet, `next` returns
+// false and can be called again later, so the same reader can tail a log that
+// is being written.
+// segments are mapped with at least segment size length, so appended records
+// are visible without remapping.
+template<typename Config = DefaultConfig>
+class RecordLogReader
+{
+public:
+  explicit RecordLogReader(
+    const char* directory,
+    size_t segmentSize = record_log_details::DefaultSegmentSize)
+    : _directory{ directory }
+    , _segmentSize{ segmentSize }
+  {
+  }
+
+  RecordLogReader(const RecordLogReader&) = delete;
+  RecordLogReader& operator=(const RecordLogReader&) = delete;
+
+  // returns false if there is no complete record available (yet) or record
+  // is corrupted, then error is set to InvalidData
+  bool next(RecordView& record)
+  {
+    if (_error != ReaderError::NoError)
+      return false;
+    if (_segment == record_log_details::NoSegment) {
+      _segment = record_log_details::findSegment(_directory, true);
+      if (_segment == record_log_details::NoSegment)
+        return false;
+    }
+    if (_fd < 0 && !openSegment())
+      return false;
+    for (;;) {
+      if (readRecord(record))
+        return true;
+      if (_error != ReaderError::NoError)
+        return false;
+      // writer starts next segment only after current one is fully written
+      const auto nextPath =
+        record_log_details::segmentPath(_directory, _segment + 1);
+      if (!record_log_details::fileExists(nextPath))
+        return false;
+      if (readRecord(record))
+        return true;
+      if (_offset != _available) {
+        setError(ReaderError::InvalidData);
+        return false;
+      }
+      closeSegment();
+      ++_segment;
+      if (!openSegment())
+        return false;
+    }
+  }
+
+  template<typename T>
+  static eastl::pair<ReaderError, bool> deserialize(const RecordView& record,
+                                                    T& value)
+  {
+    return quickDeserialization(
+      InputBufferAdapter<UncheckedBufferView<uint8_t>, Config>{ record.data,
+                                                                record.size },
+      value);
+  }
+
+  ReaderError error() const { return _error; }
+
+  // index of segment that is currently read, NoSegment until first segment is
+  // found
+  uint64_t segmentIndex() const { return _segment; }
+
+  ~RecordLogReader() noexcept { closeSegment(); }
+
+private:
+  bool openSegment()
+  {
+    const auto path = record_log_details::segmentPath(_directory, _segment);
+    _fd = ::open(path.c_str(), O_RDONLY);
+    return _fd >= 0 && refresh();
+  }
+
+  void closeSegment()
+  {
+    if (_mapped > 0)
+      ::munmap(const_cast<uint8_t*>(_data), _mapped);
+    if (_fd >= 0)
+      ::close(_fd);
+    _fd = -1;
+    _data = nullptr;
+    _mapped = 0;
+    _offset = 0;
+    _available = 0;
+  }
+
+  // updates available size, remaps only when segment is bigger than mapping
+  bool refresh()
+  {
+    struct stat info;
+    if (::fstat(_fd, &info) != 0)
+      return false;
+    _available = static_cast<size_t>(info.st_size);
+    if (_available <= _mapped)
+      return true;
+    if (_mapped > 0)
+      ::munmap(const_cast<uint8_t*>(_data), _mapped);
+    const auto length = _available > _segmentSize ? _available : _segmentSize;
+    auto ptr = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, _fd, 0);
+    if (ptr == MAP_FAILED) {
+      _data = nullptr;
+      _mapped = 0;
+      _available = 0;
+      return false;
+    }
+    _data = static_cast<const uint8_t*>(ptr);
+    _mapped = length;
+    return true;
+  }
+
+  bool hasBytes(size_t size)
+  {
+    if (_available - _offset >= size)
+      return true;
+    return refresh() && _available - _offset >= size;
+  }
+
+  bool readRecord(RecordView& record)
+  {
+    if (!hasBytes(record_log_details::RecordHeaderSize))
+      return false;
+    const auto header =
+      record_log_details::RecordHeader<Config>::read(_data + _offset);
+    if (!hasBytes(record_log_details::RecordHeaderSize + header.size))
+      return false;
+    const auto payload = _data + _offset + record_log_details::RecordHeaderSize;
+    if (crc32c(payload, header.size) != header.checksum) {
+      setError(ReaderError::InvalidData);
+      return false;
+    }
+    record = RecordView{ payload, header.size };
+    _offset += record_log_details::RecordHeaderSize + header.size;
+    return true;
+  }
+
+  void setError(ReaderError error) { _error = error; }
+
+  eastl::string _directory;
+  size_t _segmentSize;
+  uint64_t _segment{ record_log_details::NoSegment };
+  int _fd{ -1 };
+  const uint8_t* _data{};
+  size_t _mapped{};
+  size_t _offset{};
+  size_t _available{};
+  ReaderError _error{ ReaderError::NoError };
+};
+
+}
+}
+
+#endif
+
+#endif // BITSERY_EXT_RECORD_LOG_H
@@ -24,12 +24,52 @@
 #define BITSERY_RTTI_UTILS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <EASTL/type_traits.h>
 #include <typeinfo>
 
+#ifndef BITSERY_HAS_RTTI
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+#define BITSERY_HAS_RTTI 1
+#else
+#define BITSERY_HAS_RTTI 0
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BITSERY_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+#define BITSERY_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+// add this to base class of polymorphic hierarchy, when using StaticRTTI
+#define BITSERY_STATIC_RTTI_BASE(Type)                                         \
+  virtual size_t bitseryTypeId() const noexcept                                \
+  {                                                                            \
+    return ::bitsery::ext::StaticRTTI::get<Type>();                            \
+  }                                                                            \
+  virtual const void* bitseryMostDerived() const noexcept                      \
+  {                                                                            \
+    return this;                                                               \
+  }
+
+// add this to every derived class, it overrides functions declared by
+// BITSERY_STATIC_RTTI_BASE
+#define BITSERY_STATIC_RTTI(Type)                                              \
+  size_t bitseryTypeId() const noexcept override                               \
+  {                                                                            \
+    return ::bitsery::ext::StaticRTTI::get<Type>();                            \
+  }                                                                            \
+  const void* bitseryMostDerived() const noexcept override                     \
+  {                                                                            \
+    return this;                                                               \
+  }
+
 namespace bitsery {
 namespace ext {
 
+#if BITSERY_HAS_RTTI
+
 struct StandardRTTI
 {
 
@@ -59,6 +99,168 @@ struct StandardRTTI
   }
 };
 
+#endif
+
+namespace rtti_details {
+
+constexpr uint64_t
+fnv1aStep(uint64_t hash, char c)
+{
+  return (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+}
+
+// c++11 constexpr, process 8 chars per call to keep recursion depth low
+constexpr uint64_t
+fnv1a(const char* str, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+  return size >= 8
+           ? fnv1a(str + 8,
+                   size - 8,
+                   fnv1aStep(
+                     fnv1aStep(
+                       fnv1aStep(
+                         fnv1aStep(
+                           fnv1aStep(
+                             fnv1aStep(fnv1aStep(fnv1aStep(hash, str[0]),
+                                                 str[1]),
+                                       str[2]),
+                             str[3]),
+                           str[4]),
+                         str[5]),
+                       str[6]),
+                     str[7]))
+         : size > 0 ? fnv1a(str + 1, size - 1, fnv1aStep(hash, str[0]))
+                    : hash;
+}
+
+// function signature contains type name, so it is unique for each type.
+// ids are stable for the same compiler, but are not written to buffer, so they
+// don't need to be the same across platforms.
+template<typename T>
+constexpr size_t
+typeId()
+{
+  return static_cast<size_t>(fnv1a(BITSERY_FUNCTION_SIGNATURE,
+                                   sizeof(BITSERY_FUNCTION_SIGNATURE) - 1));
+}
+
+template<typename T, typename = void>
+struct HasTypeIdHook : eastl::false_type
+{
+};
+
+template<typename T>
+struct HasTypeIdHook<
+  T,
+  decltype(static_cast<size_t>(eastl::declval<const T&>().bitseryTypeId()),
+           static_cast<const void*>(
+             eastl::declval<const T&>().bitseryMostDerived()),
+           void())> : eastl::true_type
+{
+};
+
+template<typename TFrom, typename TTo, typename = void>
+struct CanStaticCast : eastl::false_type
+{
+};
+
+template<typename TFrom, typename TTo>
+struct CanStaticCast<TFrom,
+                     TTo,
+                     decltype(static_cast<TTo*>(eastl::declval<TFrom*>()),
+                              void())> : eastl::true_type
+{
+};
+
+}
+
+// RTTI that doesn't use typeid and dynamic_cast, so it works with -fno-rtti.
+// type ids are computed at compile time, and polymorphic types must provide
+// runtime type id via virtual methods, use BITSERY_STATIC_RTTI(Type) macro for
+// every class in hierarchy.
+// downcasts use static_cast, except for virtual base classes, in this case
+// object can only be casted to its most derived type.
+struct StaticRTTI
+{
+  template<typename TBase>
+  static size_t get(TBase& obj)
+  {
+    return getRuntime(obj, eastl::is_polymorphic<TBase>{});
+  }
+
+  template<typename TBase>
+  static constexpr size_t get()
+  {
+    return rtti_details::typeId<typename eastl::remove_cv<TBase>::type>();
+  }
+
+  template<typename TBase, typename TDerived>
+  static TDerived* cast(TBase* obj)
+  {
+    static_assert(!eastl::is_pointer<TDerived>::value, "");
+    return castImpl<TBase, TDerived>(
+      obj,
+      eastl::integral_constant<bool,
+                               eastl::is_base_of<TDerived, TBase>::value>{},
+      rtti_details::CanStaticCast<TBase, TDerived>{});
+  }
+
+  template<typename TBase>
+  static constexpr bool isPolymorphic()
+  {
+    return eastl::is_polymorphic<TBase>::value;
+  }
+
+private:
+  template<typename TBase>
+  static size_t getRuntime(TBase& obj, eastl::true_type)
+  {
+    static_assert(rtti_details::HasTypeIdHook<TBase>::value,
+                  "\nPlease add BITSERY_STATIC_RTTI(Type) to every class in "
+                  "polymorphic hierarchy, when using StaticRTTI\n");
+    return obj.bitseryTypeId();
+  }
+
+  template<typename TBase>
+  static constexpr size_t getRuntime(TBase&, eastl::false_type)
+  {
+    return get<TBase>();
+  }
+
+  // upcast
+  template<typename TBase, typename TDerived, typename TCanStaticCast>
+  static TDerived* castImpl(TBase* obj, eastl::true_type, TCanStaticCast)
+  {
+    return obj;
+  }
+
+  // downcast, non virtual inheritance
+  template<typename TBase, typename TDerived>
+  static TDerived* castImpl(TBase* obj, eastl::false_type, eastl::true_type)
+  {
+    return static_cast<TDerived*>(obj);
+  }
+
+  // downcast from virtual base
+  template<typename TBase, typename TDerived>
+  static TDerived* castImpl(TBase* obj, eastl::false_type, eastl::false_type)
+  {
+    static_assert(rtti_details::HasTypeIdHook<TBase>::value,
+                  "\nPlease add BITSERY_STATIC_RTTI(Type) to every class in "
+                  "polymorphic hierarchy, when using StaticRTTI\n");
+    if (obj == nullptr || obj->bitseryTypeId() != get<TDerived>())
+      return nullptr;
+    return static_cast<TDerived*>(const_cast<void*>(obj->bitseryMostDerived()));
+  }
+};
+
+// RTTI used by default in pointer extensions
+#if BITSERY_HAS_RTTI
+using DefaultRTTI = StandardRTTI;
+#else
+using DefaultRTTI = StaticRTTI;
+#endif
+
 }
 }
 
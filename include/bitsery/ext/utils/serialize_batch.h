@@ -0,0 +1,225 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef BITSERY_EXT_SERIALIZE_BATCH_H
+#define BITSERY_EXT_SERIALIZE_BATCH_H
+
+#include "../../deserializer.h"
+#include "executor.h"
+#include "serialize_exact.h"
+#include <EASTL/vector.h>
+#include <cassert>
+#include <cstdint>
+
+namespace bitsery {
+
+namespace ext {
+
+// batch layout: messages count, then offset of each message and end of the
+// last one (count + 1 values, relative to the first message), then messages.
+// index values are 8 bytes each, so any message can be found without parsing
+// previous ones.
+// messages are serialized independently, so they cannot use context.
+
+namespace serialize_batch_details {
+
+inline size_t
+headerSize(size_t count)
+{
+  return (count + 2) * sizeof(uint64_t);
+}
+
+}
+
+// measures all messages in parallel, resizes buffer once (old content is not
+// preserved) and serializes each message directly to its place in the buffer.
+// `messages` is random access container, e.g. eastl::vector<T>.
+// returns serialized bytes count, which is also the new buffer size.
+template<typename Config = DefaultConfig, typename Buffer, typename Messages>
+size_t
+serializeBatch(ParallelExecutor& executor,
+               Buffer& buffer,
+               const Messages& messages)
+{
+  static_assert(traits::ContainerTraits<Buffer>::isResizable,
+                "serializeBatch requires resizable buffer");
+  using TValue = typename traits::ContainerTraits<Buffer>::TValue;
+  const auto count = traits::ContainerTraits<Messages>::size(messages);
+  eastl::vector<uint64_t> offsets(count + 1);
+  auto measure = [&offsets, &messages](size_t i) {
+    offsets[i + 1] = serialize_exact_details::measure<Config>(messages[i]);
+  };
+  executor.parallelFor(count, measure);
+  for (size_t i = 0; i < count; ++i)
+    offsets[i + 1] += offsets[i];
+
+  const auto header = serialize_batch_details::headerSize(count);
+  const auto total = header + static_cast<size_t>(offsets[count]);
+  details::resizeForOverwrite(buffer, total);
+  TValue* data = buffer.data();
+  {
+    UncheckedBufferView<TValue> view{ data, header };
+    Serializer<OutputBufferAdapter<UncheckedBufferView<TValue>, Config>> ser{
+      view
+    };
+    ser.value8b(static_cast<uint64_t>(count));
+    for (auto offset : offsets)
+      ser.value8b(offset);
+  }
+  TValue* messagesData = data + header;
+  auto write = [&offsets, &messages, messagesData](size_t i) {
+    const auto size = static_cast<size_t>(offsets[i + 1] - offsets[i]);
+    const auto written = serialize_exact_details::write<Config>(
+      messagesData + offsets[i], size, messages[i]);
+    assert(written == size);
+    (void)written;
+  };
+  executor.parallelFor(count, write);
+  return total;
+}
+
+// read-only view of serialized batch, index is validated when view is created,
+// then messages can be deserialized in any order, from multiple threads.
+// data after the end of the last message is ignored.
+template<typename Config = DefaultConfig, typename TValue = uint8_t>
+class BatchView
+{
+public:
+  BatchView(const TValue* data, size_t size)
+    : _data{ data }
+    , _size{ size }
+  {
+    static_assert(sizeof(TValue) == 1, "batch underlying type must be 1byte.");
+    validate();
+  }
+
+  // error found in the index, messages cannot be read if it is set
+  ReaderError error() const { return _error; }
+
+  // messages count
+  size_t size() const { return _count; }
+
+  // batch size in bytes, including index
+  size_t bytesCount() const
+  {
+    return _error == ReaderError::NoError ? _header + readOffset(_count) : 0;
+  }
+
+  const TValue* messageData(size_t index) const
+  {
+    assert(index < _count);
+    return _data + _header + readOffset(index);
+  }
+
+  size_t messageSize(size_t index) const
+  {
+    assert(index < _count);
+    return readOffset(index + 1) - readOffset(index);
+  }
+
+  template<typename T>
+  eastl::pair<ReaderError, bool> deserialize(size_t index, T& value) const
+  {
+    if (_error != ReaderError::NoError)
+      return { _error, false };
+    return quickDeserialization(
+      Reader{ messageData(index), messageSize(index) }, value);
+  }
+
+  // resizes container to messages count and deserializes all messages in
+  // parallel, returns result of the first message that failed.
+  template<typename Container>
+  eastl::pair<ReaderError, bool> deserializeAll(ParallelExecutor& executor,
+                                                Container& values) const
+  {
+    if (_error != ReaderError::NoError)
+      return { _error, false };
+    traits::ContainerTraits<Container>::resize(values, _count);
+    eastl::vector<eastl::pair<ReaderError, bool>> results(_count);
+    auto read = [this, &values, &results](size_t i) {
+      results[i] = deserialize(i, values[i]);
+    };
+    executor.parallelFor(_count, read);
+    for (auto& res : results) {
+      if (res.first != ReaderError::NoError || !res.second)
+        return res;
+    }
+    return { ReaderError::NoError, true };
+  }
+
+private:
+  using Reader = InputBufferAdapter<UncheckedBufferView<TValue>, Config>;
+
+  uint64_t readValue(size_t pos) const
+  {
+    Reader reader{ _data + pos, sizeof(uint64_t) };
+    uint64_t value{};
+    reader.template readBytes<8>(value);
+    return value;
+  }
+
+  size_t readOffset(size_t index) const
+  {
+    return static_cast<size_t>(readValue((index + 1) * sizeof(uint64_t)));
+  }
+
+  void validate()
+  {
+    if (_size < serialize_batch_details::headerSize(0))
+      return setError(ReaderError::DataOverflow);
+    const auto count = readValue(0);
+    const auto maxCount = _size / sizeof(uint64_t) - 2;
+    if (count > maxCount)
+      return setError(ReaderError::DataOverflow);
+    _count = static_cast<size_t>(count);
+    _header = serialize_batch_details::headerSize(_count);
+    const auto available = _size - _header;
+    uint64_t prev = readValue(sizeof(uint64_t));
+    if (prev != 0)
+      return setError(ReaderError::InvalidData);
+    for (size_t i = 1; i <= _count; ++i) {
+      const auto offset = readValue((i + 1) * sizeof(uint64_t));
+      if (offset < prev)
+        return setError(ReaderError::InvalidData);
+      if (offset > available)
+        return setError(ReaderError::DataOverflow);
+      prev = offset;
+    }
+  }
+
+  void setError(ReaderError error)
+  {
+    _error = error;
+    _count = 0;
+  }
+
+  const TValue* _data;
+  size_t _size;
+  size_t _count{};
+  size_t _header{};
+  ReaderError _error{ ReaderError::NoError };
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_SERIALIZE_BATCH_H
@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_SERIALIZE_EXACT_H
+#define BITSERY_EXT_SERIALIZE_EXACT_H
+
+#include "../../adapter/buffer.h"
+#include "../../adapter/measure_size.h"
+#include "../../serializer.h"
+#include <cassert>
+#include <cstddef>
+
+namespace bitsery {
+
+namespace ext {
+
+// fixed size view of memory, OutputBufferAdapter doesn't check bounds when
+// writing to it (only asserts), so size must be known before serialization
+template<typename T>
+struct UncheckedBufferView
+{
+  T* data;
+  size_t size;
+
+  T* begin() const { return data; }
+  T* end() const { return data + size; }
+};
+
+}
+
+namespace traits {
+
+template<typename T>
+struct ContainerTraits<ext::UncheckedBufferView<T>>
+{
+  using TValue = T;
+  static constexpr bool isResizable = false;
+  static constexpr bool isContiguous = true;
+  static size_t size(const ext::UncheckedBufferView<T>& view)
+  {
+    return view.size;
+  }
+};
+
+template<typename T>
+struct BufferAdapterTraits<ext::UncheckedBufferView<T>>
+{
+  using TIterator = T*;
+  using TConstIterator = const T*;
+  using TValue = T;
+};
+
+}
+
+namespace ext {
+
+namespace serialize_exact_details {
+
+template<typename Config, typename T>
+size_t
+measure(const T& value)
+{
+  return quickSerialization(BasicMeasureSize<Config>{}, value);
+}
+
+template<typename Config, typename Context, typename T>
+size_t
+measure(Context& ctx, const T& value)
+{
+  return quickSerialization(ctx, BasicMeasureSize<Config>{}, value);
+}
+
+template<typename Config, typename TValue, typename T>
+size_t
+write(TValue* data, size_t size, const T& value)
+{
+  using Adapter = OutputBufferAdapter<UncheckedBufferView<TValue>, Config>;
+  UncheckedBufferView<TValue> view{ data, size };
+  return quickSerialization(Adapter{ view }, value);
+}
+
+template<typename Config, typename Context, typename TValue, typename T>
+size_t
+write(Context& ctx, TValue* data, size_t size, const T& value)
+{
+  using Adapter = OutputBufferAdapter<UncheckedBufferView<TValue>, Config>;
+  UncheckedBufferView<TValue> view{ data, size };
+  return quickSerialization(ctx, Adapter{ view }, value);
+}
+
+}
+
+// measures exact size with BasicMeasureSize first, resizes buffer once (old
+// content is not preserved) and then serializes without bounds checks.
+// returns serialized bytes count, which is also the new buffer size.
+template<typename Config = DefaultConfig, typename Buffer, typename T>
+size_t
+serializeExact(Buffer& buffer, const T& value)
+{
+  static_assert(traits::ContainerTraits<Buffer>::isResizable,
+                "use serializeExact(data, capacity, value) for fixed buffers");
+  const auto size = serialize_exact_details::measure<Config>(value);
+  details::resizeForOverwrite(buffer, size);
+  const auto written = serialize_exact_details::write<Config>(
+    buffer.data(), size, value);
+  assert(written == size);
+  return written;
+}
+
+// serialization runs twice, so each pass needs context in the same initial
+// state, e.g. pointer linking context remembers pointers that were already
+// serialized
+template<typename Config = DefaultConfig,
+         typename Context,
+         typename Buffer,
+         typename T>
+size_t
+serializeExact(Context& measureCtx,
+               Context& ctx,
+               Buffer& buffer,
+               const T& value)
+{
+  static_assert(traits::ContainerTraits<Buffer>::isResizable,
+                "use serializeExact(data, capacity, value) for fixed buffers");
+  const auto size = serialize_exact_details::measure<Config>(measureCtx, value);
+  details::resizeForOverwrite(buffer, size);
+  const auto written = serialize_exact_details::write<Config>(
+    ctx, buffer.data(), size, value);
+  assert(written == size);
+  return written;
+}
+
+// serializes to caller supplied memory only if it is big enough.
+// returns required size and whether data was written.
+template<typename Config = DefaultConfig, typename TValue, typename T>
+eastl::pair<size_t, bool>
+serializeExact(TValue* data, size_t capacity, const T& value)
+{
+  static_assert(sizeof(TValue) == 1, "buffer underlying type must be 1byte.");
+  const auto size = serialize_exact_details::measure<Config>(value);
+  if (size > capacity)
+    return { size, false };
+  const auto written =
+    serialize_exact_details::write<Config>(data, size, value);
+  assert(written == size);
+  return { written, true };
+}
+
+}
+
+}
+
+#endif // BITSERY_EXT_SERIALIZE_EXACT_H
@@ -0,0 +1,285 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_SIZE_PREDICTOR_H
+#define BITSERY_EXT_SIZE_PREDICTOR_H
+
+#include "../../adapter/buffer.h"
+#include "../../serializer.h"
+#include "memory_resource.h"
+#include "rtti_utils.h"
+#include "type_id_table.h"
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace bitsery {
+namespace ext {
+
+// predicts max of last N written sizes
+template<size_t N = 8>
+class SizeEstimateMaxOfLast
+{
+public:
+  static_assert(N > 0, "");
+
+  void add(size_t size)
+  {
+    _sizes[_next] = size;
+    _next = (_next + 1) % N;
+  }
+
+  size_t predict() const
+  {
+    size_t res{};
+    for (auto size : _sizes)
+      res = size > res ? size : res;
+    return res;
+  }
+
+private:
+  size_t _sizes[N]{};
+  size_t _next{};
+};
+
+// predicts exponentially weighted moving average of written sizes, newest size
+// has weight 1/2^WeightShift, and adds 1/2^HeadroomShift of average on top, so
+// that messages slightly bigger than average still fit
+template<size_t WeightShift = 3, size_t HeadroomShift = 2>
+class SizeEstimateEwma
+{
+public:
+  void add(size_t size)
+  {
+    _average = _isEmpty ? size
+                        : _average - (_average >> WeightShift) +
+                            (size >> WeightShift);
+    _isEmpty = false;
+  }
+
+  size_t predict() const { return _average + (_average >> HeadroomShift); }
+
+private:
+  size_t _average{};
+  bool _isEmpty{ true };
+};
+
+// statistics of single message type in BufferSizePredictor
+struct SizePredictorStats
+{
+  size_t typeId;
+  // size that will be reserved for next message
+  size_t predictedSize;
+  // messages that fit in predicted size
+  size_t hits;
+  // messages that were bigger than predicted size (including first message)
+  size_t misses;
+  // number of times buffer was grown while serializing
+  size_t resizes;
+};
+
+namespace size_predictor_details {
+
+// counts calls to growth policy on current thread, OutputBufferAdapter calls it
+// only when buffer is full
+template<typename Growth>
+struct CountingGrowth
+{
+  static size_t& count()
+  {
+    static thread_local size_t value{};
+    return value;
+  }
+
+  static size_t newSize(size_t size, size_t minSize)
+  {
+    ++count();
+    return Growth::newSize(size, minSize);
+  }
+};
+
+template<typename Buffer>
+void
+growBuffer(Buffer& buffer, size_t size, eastl::true_type)
+{
+  if (traits::ContainerTraits<Buffer>::size(buffer) < size)
+    traits::BufferAdapterTraits<Buffer>::growBuffer(buffer, size);
+}
+
+template<typename Buffer>
+void
+growBuffer(Buffer&, size_t, eastl::false_type)
+{
+}
+
+}
+
+// opt-in registry, that tracks written sizes for each message type and grows
+// output buffer to predicted size before serialization, so that serializing
+// into fresh buffer doesn't go through several resize steps.
+// buffers are only grown, if their BufferAdapterTraits defines growBuffer.
+// not thread safe, use one instance per thread.
+template<typename Estimate = SizeEstimateMaxOfLast<>>
+class BufferSizePredictor
+{
+public:
+  explicit BufferSizePredictor(MemResourceBase* memResource = nullptr)
+    : _types{ pointer_utils::StdPolyAlloc<Type>{ memResource } }
+    , _typeIds{ memResource }
+  {
+  }
+
+  // same as quickSerialization, but buffer is grown to predicted size first
+  template<typename Config = DefaultConfig,
+           typename Growth = GrowthGeometric,
+           typename Buffer,
+           typename T>
+  size_t serialize(Buffer& buffer, const T& value)
+  {
+    using Adapter = OutputBufferAdapter<
+      Buffer,
+      Config,
+      size_predictor_details::CountingGrowth<Growth>>;
+    return serializeImpl<T, Growth>(buffer, [&value](Buffer& buf) {
+      return quickSerialization(Adapter{ buf }, value);
+    });
+  }
+
+  template<typename Config = DefaultConfig,
+           typename Growth = GrowthGeometric,
+           typename Context,
+           typename Buffer,
+           typename T>
+  size_t serialize(Context& ctx, Buffer& buffer, const T& value)
+  {
+    using Adapter = OutputBufferAdapter<
+      Buffer,
+      Config,
+      size_predictor_details::CountingGrowth<Growth>>;
+    return serializeImpl<T, Growth>(buffer, [&ctx, &value](Buffer& buf) {
+      return quickSerialization(ctx, Adapter{ buf }, value);
+    });
+  }
+
+  // grows buffer to predicted size of T and returns predicted size,
+  // use it with record, when serializing manually
+  template<typename T, typename Buffer>
+  size_t prepare(Buffer& buffer) const
+  {
+    const auto predicted = predict<T>();
+    size_predictor_details::growBuffer(
+      buffer,
+      predicted,
+      typename details::HasGrowBufferHelper<Buffer>::type{});
+    return predicted;
+  }
+
+  template<typename T>
+  void record(size_t predicted, size_t written, size_t resizes = 0)
+  {
+    auto& type = findOrAddType(StaticRTTI::get<T>());
+    auto& stats = type.stats;
+    if (written > predicted)
+      ++stats.misses;
+    else
+      ++stats.hits;
+    stats.resizes += resizes;
+    type.estimate.add(written);
+    stats.predictedSize = type.estimate.predict();
+  }
+
+  // returns 0 if type was never recorded
+  template<typename T>
+  size_t predict() const
+  {
+    auto type = findType(StaticRTTI::get<T>());
+    return type ? type->stats.predictedSize : 0;
+  }
+
+  // returns nullptr if type was never recorded
+  template<typename T>
+  const SizePredictorStats* stats() const
+  {
+    auto type = findType(StaticRTTI::get<T>());
+    return type ? &type->stats : nullptr;
+  }
+
+  template<typename Fnc>
+  void forEachStats(Fnc&& fnc) const
+  {
+    for (const auto& type : _types)
+      fnc(type.stats);
+  }
+
+  // sum of all types statistics, typeId and predictedSize are 0
+  SizePredictorStats totalStats() const
+  {
+    SizePredictorStats res{ 0, 0, 0, 0, 0 };
+    for (const auto& type : _types) {
+      res.hits += type.stats.hits;
+      res.misses += type.stats.misses;
+      res.resizes += type.stats.resizes;
+    }
+    return res;
+  }
+
+private:
+  struct Type
+  {
+    SizePredictorStats stats;
+    Estimate estimate;
+  };
+
+  template<typename T, typename Growth, typename Buffer, typename Fnc>
+  size_t serializeImpl(Buffer& buffer, Fnc&& fnc)
+  {
+    using Counting = size_predictor_details::CountingGrowth<Growth>;
+    const auto predicted = prepare<T>(buffer);
+    const auto resizes = Counting::count();
+    const auto written = fnc(buffer);
+    record<T>(predicted, written, Counting::count() - resizes);
+    return written;
+  }
+
+  const Type* findType(size_t typeId) const
+  {
+    auto index = _typeIds.find(typeId);
+    return index ? &_types[*index] : nullptr;
+  }
+
+  Type& findOrAddType(size_t typeId)
+  {
+    if (auto type = findType(typeId))
+      return const_cast<Type&>(*type);
+    _typeIds.insert(typeId, _types.size());
+    _types.push_back(Type{ SizePredictorStats{ typeId, 0, 0, 0, 0 }, {} });
+    return _types.back();
+  }
+
+  eastl::vector<Type, pointer_utils::StdPolyAlloc<Type>> _types;
+  details::TypeIdTable _typeIds;
+};
+
+}
+}
+
+#endif // BITSERY_EXT_SIZE_PREDICTOR_H
@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef BITSERY_EXT_TYPE_ID_TABLE_H
+#define BITSERY_EXT_TYPE_ID_TABLE_H
+
+#include "memory_resource.h"
+#include <EASTL/vector.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace bitsery {
+
+namespace details {
+
+// open addressing hash table, that maps type id to index, for registries that
+// store per type data in vector (e.g. MemResourceSlab, BufferSizePredictor).
+// entries are only added, table grows when it is half full.
+class TypeIdTable
+{
+public:
+  explicit TypeIdTable(ext::MemResourceBase* memResource = nullptr)
+    : _slots{ ext::pointer_utils::StdPolyAlloc<Slot>{ memResource } }
+  {
+  }
+
+  // returns nullptr if type id is not added
+  const size_t* find(size_t typeId) const
+  {
+    if (_slots.empty())
+      return nullptr;
+    for (auto i = slotIndex(typeId);; i = (i + 1) & (_slots.size() - 1)) {
+      const auto& slot = _slots[i];
+      if (!slot.used)
+        return nullptr;
+      if (slot.typeId == typeId)
+        return &slot.index;
+    }
+  }
+
+  // type id must not be added already
+  void insert(size_t typeId, size_t index)
+  {
+    if ((_size + 1) * 2 > _slots.size())
+      rehash(_slots.empty() ? 16 : _slots.size() * 2);
+    insertSlot(Slot{ typeId, index, true });
+    ++_size;
+  }
+
+  size_t size() const { return _size; }
+
+private:
+  struct Slot
+  {
+    size_t typeId;
+    size_t index;
+    bool used;
+  };
+
+  void rehash(size_t slotsCount)
+  {
+    decltype(_slots) old{ slotsCount,
+                          Slot{ 0, 0, false },
+                          _slots.get_allocator() };
+    old.swap(_slots);
+    for (const auto& slot : old)
+      if (slot.used)
+        insertSlot(slot);
+  }
+
+  void insertSlot(const Slot& value)
+  {
+    auto i = slotIndex(value.typeId);
+    while (_slots[i].used)
+      i = (i + 1) & (_slots.size() - 1);
+    _slots[i] = value;
+  }
+
+  size_t slotIndex(size_t typeId) const
+  {
+    return static_cast<size_t>(
+             (static_cast<uint64_t>(typeId) * 0x9E3779B97F4A7C15ull) >> 32) &
+           (_slots.size() - 1);
+  }
+
+  eastl::vector<Slot, ext::pointer_utils::StdPolyAlloc<Slot>> _slots;
+  size_t _size{};
+};
+
+}
+
+}
+
+#endif // BITSERY_EXT_TYPE_ID_TABLE_H
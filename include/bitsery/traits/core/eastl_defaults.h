@@ -23,6 +23,7 @@
 #ifndef BITSERY_TRAITS_CORE_EASTL_DEFAULTS_H
 #define BITSERY_TRAITS_CORE_EASTL_DEFAULTS_H
 
+#include "../../adapter/growth_policy.h"
 #include "../../bitsery.h"
 #include "../../details/serialization_common.h"
 #include "traits.h"
@@ -100,12 +101,13 @@ struct EastlContainerForBufferAdapter<T, true>
     // since we're writing to buffer use different resize strategy than default
     // implementation when small size grow faster, to avoid thouse 2/4/8/16...
     // byte allocations
-    auto newSize =
-      static_cast<size_t>(static_cast<double>(container.size()) * 1.5) + 128;
-    // make data cache friendly
-    newSize -= newSize % 64; // 64 is cache line size //TODO: This should be std::hardware_destructive_interference_size
-    auto resize =
-      (eastl::max)(newSize > minSize ? newSize : minSize, container.capacity());
+    growBuffer(container, GrowthGeometric::newSize(container.size(), minSize));
+  }
+
+  static void growBuffer(T& container, size_t newSize)
+  {
+    // already allocated memory is free to use
+    auto resize = (eastl::max)(newSize, container.capacity());
     BITSERY_ASSUME(resize >= container.size());
     BITSERY_ASSUME(resize >= container.capacity());
     container.resize(resize);
@@ -71,6 +71,9 @@ struct ContainerTraits
                   "Define ContainerTraits or include from <bitsery/traits/...> "
                   "to use as container");
   }
+  // optional: static void resizeForOverwrite(T&, size_t)
+  // called instead of resize for contiguous containers, when all elements will
+  // be overwritten by bulk read, so it doesn't need to initialize them.
   // get container size
   static size_t size(const T&)
   {
@@ -174,6 +177,12 @@ struct BufferAdapterTraits
                   "Define BufferAdapterTraits or include from "
                   "<bitsery/traits/...> to use as buffer adapter container");
   }
+
+  // optional, if defined, Writer calls it instead of increaseBufferSize with
+  // size calculated by its growth policy:
+  // static void growBuffer(T&, size_t newSize);
+  // it must resize buffer to at least newSize, keeping existing data,
+  // new elements doesn't need to be initialized.
 };
 
 // specialization for c-style buffer
@@ -37,6 +37,18 @@ template<typename CharT, typename Allocator>
 struct ContainerTraits<eastl::basic_string<CharT, Allocator>>
   : public EastlContainer<eastl::basic_string<CharT, Allocator>, true, true>
 {
+  // characters are overwritten by bulk read, so grow without filling them
+  static void resizeForOverwrite(eastl::basic_string<CharT, Allocator>& str,
+                                 size_t size)
+  {
+    if (size > str.capacity()) {
+      // old content is not needed, so don't copy it to new buffer
+      str.clear();
+      str.reserve(size);
+    }
+    str.force_size(size);
+    str.data()[size] = CharT{};
+  }
 };
 
 template<typename CharT, typename Allocator>
@@ -72,6 +84,16 @@ struct BufferAdapterTraits<eastl::basic_string<CharT, Allocator>>
   : public EastlContainerForBufferAdapter<
       eastl::basic_string<CharT, Allocator>>
 {
+  // grow without filling new characters, writer will overwrite them anyway
+  static void growBuffer(eastl::basic_string<CharT, Allocator>& buffer,
+                         size_t newSize)
+  {
+    if (newSize < buffer.capacity())
+      newSize = buffer.capacity();
+    buffer.reserve(newSize);
+    buffer.force_size(newSize);
+    buffer.data()[newSize] = CharT{};
+  }
 };
 
 }
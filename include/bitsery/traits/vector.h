@@ -33,6 +33,47 @@ template<typename T, typename Allocator>
 struct ContainerTraits<eastl::vector<T, Allocator>>
   : public EastlContainer<eastl::vector<T, Allocator>, true, true>
 {
+  // elements are overwritten by bulk read, so trivially copyable elements are
+  // not initialized, and when vector needs to reallocate, old elements are not
+  // copied
+  static void resizeForOverwrite(eastl::vector<T, Allocator>& container,
+                                 size_t size)
+  {
+    if (size > container.capacity()) {
+      container.clear();
+      container.reserve(size);
+    }
+    resizeForOverwriteImpl(
+      container, size, eastl::is_trivially_copyable<T>{});
+  }
+
+private:
+  // eastl::vector has no public way to change size without constructing
+  // elements, so access protected end pointer (declared in eastl::VectorBase)
+  struct EndAccess : eastl::vector<T, Allocator>
+  {
+    static T*& end(eastl::vector<T, Allocator>& container)
+    {
+      return container.*(&EndAccess::mpEnd);
+    }
+  };
+
+  static void resizeForOverwriteImpl(eastl::vector<T, Allocator>& container,
+                                     size_t size,
+                                     eastl::true_type)
+  {
+    if (size > container.size())
+      EndAccess::end(container) = container.data() + size;
+    else
+      container.resize(size);
+  }
+
+  static void resizeForOverwriteImpl(eastl::vector<T, Allocator>& container,
+                                     size_t size,
+                                     eastl::false_type)
+  {
+    container.resize(size);
+  }
 };
 
 // bool vector is not contiguous, do not copy it directly to buffer
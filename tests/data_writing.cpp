@@ -22,6 +22,7 @@
 
 #include <bitsery/details/serialization_common.h>
 #include <bitsery/traits/array.h>
+#include <bitsery/traits/string.h>
 
 #include "serialization_test_utils.h"
 #include <gmock/gmock.h>
@@ -137,3 +138,60 @@ TEST(DataWritingNonFixedBufferContainer, ContainerIsAlwaysResizedToCapacity)
     EXPECT_TRUE(buf.size() == buf.capacity());
   }
 }
+
+TEST(DataWritingGrowthPolicy, NewSizeIsAtLeastMinSize)
+{
+  EXPECT_THAT(bitsery::GrowthGeometric::newSize(0, 4), Eq(128u));
+  EXPECT_THAT(bitsery::GrowthGeometric::newSize(1000, 1001), Eq(1600u));
+  EXPECT_THAT(bitsery::GrowthGeometric::newSize(1000, 5000), Eq(5000u));
+
+  EXPECT_THAT(bitsery::GrowthPowerOfTwo::newSize(0, 4), Eq(64u));
+  EXPECT_THAT(bitsery::GrowthPowerOfTwo::newSize(64, 65), Eq(128u));
+  EXPECT_THAT(bitsery::GrowthPowerOfTwo::newSize(100, 5000), Eq(8192u));
+
+  EXPECT_THAT(bitsery::GrowthPageAligned::newSize(0, 4), Eq(4096u));
+  EXPECT_THAT(bitsery::GrowthPageAligned::newSize(4096, 4097), Eq(8192u));
+
+  using HugePage = bitsery::GrowthHugePageAligned<1024 * 1024>;
+  constexpr size_t MB2 = 2 * 1024 * 1024;
+  EXPECT_THAT(HugePage::newSize(1000, 1001), Eq(1600u));
+  EXPECT_THAT(HugePage::newSize(1024 * 1024, 1024 * 1024 + 1), Eq(MB2));
+  EXPECT_THAT(HugePage::newSize(MB2, MB2 + 1), Eq(2 * MB2));
+}
+
+TEST(DataWritingGrowthPolicy, WriterUsesGrowthPolicy)
+{
+  NonFixedContainer buf{};
+  bitsery::OutputBufferAdapter<NonFixedContainer,
+                               bitsery::DefaultConfig,
+                               bitsery::GrowthPowerOfTwo>
+    bw{ buf };
+  uint8_t data[100]{};
+  bw.writeBuffer<1>(data, 100);
+  EXPECT_THAT(buf.size(), Eq(128u));
+  for (auto i = 0; i < 3; ++i)
+    bw.writeBuffer<1>(data, 100);
+  EXPECT_THAT(buf.size(), Eq(512u));
+  EXPECT_THAT(bw.writtenBytesCount(), Eq(400u));
+}
+
+TEST(DataWritingGrowthPolicy, StringBufferKeepsWrittenDataWhenGrowing)
+{
+  eastl::string buf{};
+  bitsery::OutputBufferAdapter<eastl::string,
+                               bitsery::DefaultConfig,
+                               bitsery::GrowthPageAligned>
+    bw{ buf };
+  for (uint32_t i = 0; i < 5000; ++i)
+    bw.writeBytes<4>(i);
+  EXPECT_THAT(buf.size() % 4096, Eq(0u));
+  EXPECT_THAT(buf.size(), ::testing::Ge(20000u));
+
+  bitsery::InputBufferAdapter<eastl::string> br{ buf.begin(), 20000 };
+  for (uint32_t i = 0; i < 5000; ++i) {
+    uint32_t res{};
+    br.readBytes<4>(res);
+    EXPECT_THAT(res, Eq(i));
+  }
+  EXPECT_TRUE(br.isCompletedSuccessfully());
+}
@@ -0,0 +1,230 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/eastl_map.h>
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/ext/pointer.h>
+#include <bitsery/traits/string.h>
+#include <EASTL/map.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::AllocationBudget;
+using bitsery::ReaderError;
+using bitsery::ext::EastlMap;
+using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::PointerOwner;
+using bitsery::ext::EastlSmartPtr;
+
+using testing::Eq;
+
+using BudgetContext = BasicSerializationContext<AllocationBudget>;
+
+TEST(AllocationBudget, ChargeSucceedsUntilLimitIsReached)
+{
+  AllocationBudget budget{ 10 };
+  EXPECT_TRUE(budget.charge(4));
+  EXPECT_TRUE(budget.charge<uint16_t>(3));
+  EXPECT_THAT(budget.usedBytes(), Eq(10u));
+  EXPECT_FALSE(budget.charge(1));
+  EXPECT_TRUE(budget.isExceeded());
+  // once exceeded, budget stays exceeded until reset
+  EXPECT_FALSE(budget.charge(0));
+  budget.reset();
+  EXPECT_THAT(budget.usedBytes(), Eq(0u));
+  EXPECT_TRUE(budget.charge(10));
+}
+
+TEST(AllocationBudget, ChargeForElementsDoesntOverflow)
+{
+  AllocationBudget budget{ 100 };
+  EXPECT_FALSE(budget.charge<uint64_t>(eastl::numeric_limits<size_t>::max()));
+  EXPECT_TRUE(budget.isExceeded());
+}
+
+TEST(AllocationBudget, LoweringLimitBelowUsedBytesExceedsBudget)
+{
+  AllocationBudget budget{ 10 };
+  EXPECT_TRUE(budget.charge(8));
+  budget.maxBytes(4);
+  EXPECT_TRUE(budget.isExceeded());
+  EXPECT_THAT(budget.remainingBytes(), Eq(0u));
+  EXPECT_FALSE(budget.charge(1));
+  budget.reset();
+  EXPECT_TRUE(budget.charge(4));
+  EXPECT_FALSE(budget.charge(1));
+}
+
+TEST(AllocationBudget, ContainerWithinBudgetIsDeserialized)
+{
+  AllocationBudget budget{ 40 };
+  eastl::vector<int32_t> data{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  eastl::vector<int32_t> res{};
+  BudgetContext ctx;
+  ctx.createSerializer(budget).container4b(data, 100);
+  ctx.createDeserializer(budget).container4b(res, 100);
+
+  EXPECT_THAT(ctx.des->adapter().error(), Eq(ReaderError::NoError));
+  EXPECT_THAT(res, Eq(data));
+  EXPECT_THAT(budget.usedBytes(), Eq(40u));
+}
+
+TEST(AllocationBudget, WhenContainerExceedsBudgetThenInvalidDataError)
+{
+  AllocationBudget budget{ 39 };
+  eastl::vector<int32_t> data{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  eastl::vector<int32_t> res{};
+  BudgetContext ctx;
+  ctx.createSerializer(budget).container4b(data, 100);
+  ctx.createDeserializer(budget).container4b(res, 100);
+
+  EXPECT_THAT(ctx.des->adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_TRUE(res.empty());
+  EXPECT_TRUE(budget.isExceeded());
+}
+
+TEST(AllocationBudget, WhenTextExceedsBudgetThenInvalidDataError)
+{
+  AllocationBudget budget{ 5 };
+  eastl::string data{ "hello world" };
+  eastl::string res{};
+  BudgetContext ctx;
+  ctx.createSerializer(budget).text1b(data, 100);
+  ctx.createDeserializer(budget).text1b(res, 100);
+
+  EXPECT_THAT(ctx.des->adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_TRUE(res.empty());
+}
+
+TEST(AllocationBudget, BudgetIsChargedForAllNestedContainers)
+{
+  AllocationBudget budget{ 10 };
+  eastl::vector<eastl::string> data{ "abcd", "efgh", "ijkl" };
+  eastl::vector<eastl::string> res{};
+  BudgetContext ctx;
+  auto& ser = ctx.createSerializer(budget);
+  ser.container(data, 10, [](decltype(ser)& s, eastl::string& str) {
+    s.text1b(str, 100);
+  });
+  auto& des = ctx.createDeserializer(budget);
+  des.container(res, 10, [](decltype(des)& d, eastl::string& str) {
+    d.text1b(str, 100);
+  });
+
+  EXPECT_THAT(des.adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_TRUE(budget.isExceeded());
+}
+
+TEST(AllocationBudget, WhenMapExceedsBudgetThenInvalidDataError)
+{
+  using TMap = eastl::map<int32_t, int32_t>;
+  AllocationBudget budget{ sizeof(TMap::value_type) * 2 };
+  TMap data{ { 1, 2 }, { 3, 4 }, { 5, 6 } };
+  TMap res{};
+  BudgetContext ctx;
+  auto& ser = ctx.createSerializer(budget);
+  ser.ext(data, EastlMap{ 10 }, [](decltype(ser)& s, int32_t& k, int32_t& v) {
+    s.value4b(k);
+    s.value4b(v);
+  });
+  auto& des = ctx.createDeserializer(budget);
+  des.ext(res, EastlMap{ 10 }, [](decltype(des)& d, int32_t& k, int32_t& v) {
+    d.value4b(k);
+    d.value4b(v);
+  });
+
+  EXPECT_THAT(des.adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_TRUE(res.empty());
+}
+
+TEST(AllocationBudget, WhenPointerOwnerExceedsBudgetThenInvalidDataError)
+{
+  using TContext = eastl::tuple<PointerLinkingContext, AllocationBudget>;
+  TContext serCtx{ PointerLinkingContext{}, AllocationBudget{ 0 } };
+  // enough for container and first object only
+  TContext desCtx{
+    PointerLinkingContext{},
+    AllocationBudget{ sizeof(MyStruct1*) * 2 + sizeof(MyStruct1) }
+  };
+  MyStruct1 d1{ 1, 2 };
+  MyStruct1 d2{ 3, 4 };
+  eastl::vector<MyStruct1*> data{ &d1, &d2 };
+  eastl::vector<MyStruct1*> res{};
+  BasicSerializationContext<TContext> ctx;
+  auto& ser = ctx.createSerializer(serCtx);
+  ser.container(data, 10, [](decltype(ser)& s, MyStruct1*& p) {
+    s.ext(p, PointerOwner{});
+  });
+  auto& des = ctx.createDeserializer(desCtx);
+  des.container(res, 10, [](decltype(des)& d, MyStruct1*& p) {
+    d.ext(p, PointerOwner{});
+  });
+
+  EXPECT_THAT(des.adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_TRUE(eastl::get<1>(desCtx).isExceeded());
+  ASSERT_THAT(res.size(), Eq(2u));
+  EXPECT_THAT(*res[0], Eq(d1));
+  // second object is not allocated at all
+  EXPECT_THAT(res[1], Eq(nullptr));
+  for (auto p : res)
+    delete p;
+}
+
+TEST(AllocationBudget, WhenSharedPtrExceedsBudgetThenObjectIsNotCreated)
+{
+  using TContext = eastl::tuple<PointerLinkingContext, AllocationBudget>;
+  TContext serCtx{ PointerLinkingContext{}, AllocationBudget{ 0 } };
+  TContext desCtx{ PointerLinkingContext{},
+                   AllocationBudget{ sizeof(MyStruct1) - 1 } };
+  auto data = eastl::make_shared<MyStruct1>(MyStruct1{ 1, 2 });
+  eastl::shared_ptr<MyStruct1> res{};
+  BasicSerializationContext<TContext> ctx;
+  ctx.createSerializer(serCtx).ext(data, EastlSmartPtr{});
+  auto& des = ctx.createDeserializer(desCtx);
+  des.ext(res, EastlSmartPtr{});
+
+  EXPECT_THAT(des.adapter().error(), Eq(ReaderError::InvalidData));
+  EXPECT_THAT(res.get(), Eq(nullptr));
+}
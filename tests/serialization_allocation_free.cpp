@@ -0,0 +1,450 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/ext/pointer.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <cstdlib>
+#include <gmock/gmock.h>
+#include <new>
+
+// every allocation in this test binary goes through here, so we can check
+// that serialization steady state doesn't touch the heap
+static size_t globalAllocations = 0;
+
+// gcc sees free() of memory from inlined replacement operator new
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(size_t size)
+{
+  ++globalAllocations;
+  if (auto ptr = std::malloc(size ? size : 1u))
+    return ptr;
+  throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::BaseClass;
+using bitsery::ext::DensePointerLinkingContext;
+using bitsery::ext::InheritanceContext;
+using bitsery::ext::MemResourceBase;
+using bitsery::ext::MemResourceNewDelete;
+using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::PointerObserver;
+using bitsery::ext::PointerOwner;
+using bitsery::ext::PolymorphicContext;
+using bitsery::ext::StandardRTTI;
+using bitsery::ext::VirtualBaseClass;
+
+using testing::Eq;
+
+struct CountingResource final : MemResourceBase
+{
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    ++allocs;
+    return MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  size_t allocs{};
+};
+
+/*
+ * virtual inheritance
+ */
+struct Base
+{
+  uint8_t x{};
+  virtual ~Base() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Base& o)
+{
+  s.value1b(o.x);
+}
+
+struct Left : virtual Base
+{
+  uint8_t l{};
+};
+
+template<typename S>
+void
+serialize(S& s, Left& o)
+{
+  s.ext(o, VirtualBaseClass<Base>{});
+  s.value1b(o.l);
+}
+
+struct Right : virtual Base
+{
+  uint8_t r{};
+};
+
+template<typename S>
+void
+serialize(S& s, Right& o)
+{
+  s.ext(o, VirtualBaseClass<Base>{});
+  s.value1b(o.r);
+}
+
+struct Diamond
+  : Left
+  , Right
+{
+  uint8_t d{};
+};
+
+template<typename S>
+void
+serialize(S& s, Diamond& o)
+{
+  s.ext(o, BaseClass<Left>{});
+  s.ext(o, BaseClass<Right>{});
+  s.value1b(o.d);
+}
+
+// more virtual bases than InheritanceContext stores inline
+template<int I>
+struct Part
+{
+  uint8_t v{};
+};
+
+template<typename S, int I>
+void
+serialize(S& s, Part<I>& o)
+{
+  s.value1b(o.v);
+}
+
+struct Wide
+  : virtual Part<0>
+  , virtual Part<1>
+  , virtual Part<2>
+  , virtual Part<3>
+  , virtual Part<4>
+  , virtual Part<5>
+  , virtual Part<6>
+  , virtual Part<7>
+  , virtual Part<8>
+  , virtual Part<9>
+{
+};
+
+template<typename S>
+void
+serialize(S& s, Wide& o)
+{
+  s.ext(o, VirtualBaseClass<Part<0>>{});
+  s.ext(o, VirtualBaseClass<Part<1>>{});
+  s.ext(o, VirtualBaseClass<Part<2>>{});
+  s.ext(o, VirtualBaseClass<Part<3>>{});
+  s.ext(o, VirtualBaseClass<Part<4>>{});
+  s.ext(o, VirtualBaseClass<Part<5>>{});
+  s.ext(o, VirtualBaseClass<Part<6>>{});
+  s.ext(o, VirtualBaseClass<Part<7>>{});
+  s.ext(o, VirtualBaseClass<Part<8>>{});
+  s.ext(o, VirtualBaseClass<Part<9>>{});
+  // serializing same virtual base again is no-op
+  s.ext(o, VirtualBaseClass<Part<9>>{});
+}
+
+struct WideList
+{
+  eastl::vector<Wide> items{};
+};
+
+template<typename S>
+void
+serialize(S& s, WideList& o)
+{
+  s.container(o.items, 10);
+}
+
+/*
+ * polymorphic pointers
+ */
+struct Shape
+{
+  int32_t id{};
+  virtual ~Shape() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Shape& o)
+{
+  s.value4b(o.id);
+}
+
+struct Circle : Shape
+{
+  float radius{};
+};
+
+template<typename S>
+void
+serialize(S& s, Circle& o)
+{
+  s.ext(o, BaseClass<Shape>{});
+  s.value4b(o.radius);
+}
+
+struct Square : Shape
+{
+  int32_t side{};
+};
+
+template<typename S>
+void
+serialize(S& s, Square& o)
+{
+  s.ext(o, BaseClass<Shape>{});
+  s.value4b(o.side);
+}
+
+namespace bitsery {
+namespace ext {
+
+template<>
+struct PolymorphicBaseClass<Shape> : PolymorphicDerivedClasses<Circle, Square>
+{
+};
+
+}
+}
+
+struct Message
+{
+  Message() = default;
+  Message(const Message&) = delete;
+  Message& operator=(const Message&) = delete;
+  ~Message()
+  {
+    for (auto p : shapes)
+      delete p;
+  }
+
+  // observer is serialized before its owner
+  Shape* observer{};
+  eastl::vector<Shape*> shapes{};
+  Diamond diamond{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.ext(o.observer, PointerObserver{});
+  s.container(o.shapes, 10, [](S& s, Shape*& shape) {
+    s.ext(shape, PointerOwner{});
+  });
+  s.object(o.diamond);
+}
+
+using TContext = eastl::tuple<DensePointerLinkingContext,
+                              InheritanceContext,
+                              PolymorphicContext<StandardRTTI>>;
+using TSerializer = bitsery::Serializer<Writer, TContext>;
+using TDeserializer = bitsery::Deserializer<Reader, TContext>;
+
+class SerializeAllocationFree : public testing::Test
+{
+public:
+  CountingResource memRes{};
+  TContext serCtx{ DensePointerLinkingContext{ &memRes },
+                   InheritanceContext{ &memRes },
+                   PolymorphicContext<StandardRTTI>{ &memRes } };
+  TContext desCtx{ DensePointerLinkingContext{ &memRes },
+                   InheritanceContext{ &memRes },
+                   PolymorphicContext<StandardRTTI>{ &memRes } };
+  Buffer buf{};
+
+  void SetUp() override
+  {
+    // polymorphic classes are registered once, before steady state
+    eastl::get<2>(serCtx).registerBasesList<TSerializer>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    eastl::get<2>(desCtx).registerBasesList<TDeserializer>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+  }
+
+  // returns number of allocations, including global operator new
+  template<typename T>
+  size_t roundTrip(T& data, T& res)
+  {
+    const auto globalBefore = globalAllocations;
+    const auto resourceBefore = memRes.allocs;
+
+    eastl::get<0>(serCtx).clear();
+    TSerializer ser{ serCtx, buf };
+    ser.object(data);
+    ser.adapter().flush();
+
+    eastl::get<0>(desCtx).clear();
+    TDeserializer des{ desCtx, buf.begin(), ser.adapter().writtenBytesCount() };
+    des.object(res);
+    valid = des.adapter().error() == bitsery::ReaderError::NoError &&
+            des.adapter().isCompletedSuccessfully() &&
+            eastl::get<0>(serCtx).isValid() && eastl::get<0>(desCtx).isValid();
+
+    return globalAllocations - globalBefore + memRes.allocs - resourceBefore;
+  }
+
+  bool valid{};
+};
+
+TEST_F(SerializeAllocationFree, SecondRoundWithSameShapeDoesNotAllocate)
+{
+  Message data{};
+  data.shapes.push_back(new Circle{});
+  data.shapes.push_back(new Square{});
+  data.shapes.push_back(new Circle{});
+  data.observer = data.shapes[1];
+  data.diamond.x = 1;
+  data.diamond.l = 2;
+  data.diamond.r = 3;
+  data.diamond.d = 4;
+  Message res{};
+
+  EXPECT_THAT(roundTrip(data, res), ::testing::Gt(0u));
+  EXPECT_TRUE(valid);
+
+  // change values, but keep the shape
+  data.shapes[0]->id = 5;
+  data.shapes[1]->id = 6;
+  data.diamond.x = 7;
+  EXPECT_THAT(roundTrip(data, res), Eq(0u));
+  EXPECT_TRUE(valid);
+
+  ASSERT_THAT(res.shapes.size(), Eq(3u));
+  EXPECT_THAT(res.shapes[0]->id, Eq(5));
+  EXPECT_THAT(res.observer, Eq(res.shapes[1]));
+  EXPECT_THAT(res.observer->id, Eq(6));
+  EXPECT_THAT(dynamic_cast<Square*>(res.observer), ::testing::NotNull());
+  EXPECT_THAT(res.diamond.x, Eq(7));
+  EXPECT_THAT(res.diamond.l, Eq(2));
+  EXPECT_THAT(res.diamond.r, Eq(3));
+  EXPECT_THAT(res.diamond.d, Eq(4));
+}
+
+TEST_F(SerializeAllocationFree, ManyVirtualBasesReuseInheritanceContextStorage)
+{
+  WideList data{};
+  data.items.resize(3);
+  for (size_t i = 0; i < data.items.size(); ++i) {
+    static_cast<Part<0>&>(data.items[i]).v = static_cast<uint8_t>(i);
+    static_cast<Part<9>&>(data.items[i]).v = static_cast<uint8_t>(i + 10);
+  }
+  WideList res{};
+  roundTrip(data, res);
+  EXPECT_TRUE(valid);
+  EXPECT_THAT(roundTrip(data, res), Eq(0u));
+  EXPECT_TRUE(valid);
+  ASSERT_THAT(res.items.size(), Eq(3u));
+  for (size_t i = 0; i < res.items.size(); ++i) {
+    EXPECT_THAT(static_cast<Part<0>&>(res.items[i]).v, Eq(i));
+    EXPECT_THAT(static_cast<Part<9>&>(res.items[i]).v, Eq(i + 10));
+  }
+}
+
+TEST(SerializeAllocationFreeObservers, ManyObserversBeforeOwnerAreUpdated)
+{
+  BasicSerializationContext<PointerLinkingContext> sctx{};
+  PointerLinkingContext plctx{};
+  int32_t* owner = new int32_t{ 3 };
+  int32_t* observers[3]{ owner, owner, owner };
+  auto& ser = sctx.createSerializer(plctx);
+  for (auto& o : observers)
+    ser.ext4b(o, PointerObserver{});
+  ser.ext4b(owner, PointerOwner{});
+
+  int32_t* resOwner = nullptr;
+  int32_t* resObservers[3]{};
+  auto& des = sctx.createDeserializer(plctx);
+  for (auto& o : resObservers)
+    des.ext4b(o, PointerObserver{});
+  des.ext4b(resOwner, PointerOwner{});
+
+  ASSERT_THAT(resOwner, ::testing::NotNull());
+  EXPECT_THAT(*resOwner, Eq(3));
+  for (auto o : resObservers)
+    EXPECT_THAT(o, Eq(resOwner));
+  EXPECT_TRUE(plctx.isValid());
+  delete owner;
+  delete resOwner;
+}
@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/utils/buffer_pool.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::BufferLease;
+using bitsery::ext::BufferPool;
+using bitsery::ext::MemResourceHugePages;
+
+using testing::Eq;
+using testing::Ge;
+
+using Bytes = eastl::vector<uint8_t>;
+
+struct Message
+{
+  uint32_t id{};
+  eastl::vector<uint8_t> payload{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.value4b(o.id);
+  s.container1b(o.payload, 1000000);
+}
+
+Message
+deserializeMessage(const BufferLease<Bytes>& lease)
+{
+  Message res{};
+  auto state = bitsery::quickDeserialization(
+    bitsery::InputBufferAdapter<Bytes>{ lease.buffer().begin(), lease.size() },
+    res);
+  EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(state.second);
+  return res;
+}
+
+TEST(BufferPool, RecyclesBuffersWithoutReallocation)
+{
+  BufferPool<Bytes> pool{ 1024 * 1024, 4, 256 };
+  Message msg{ 3, Bytes(1000, 7) };
+  const uint8_t* data{};
+  {
+    auto lease = bitsery::ext::quickSerializationPooled(pool, msg);
+    EXPECT_THAT(lease.size(), Eq(1006u));
+    EXPECT_THAT(deserializeMessage(lease).payload, Eq(msg.payload));
+    data = lease.data();
+  }
+  EXPECT_THAT(pool.freeBuffers(), Eq(1u));
+  EXPECT_THAT(pool.retainedBytes(), Ge(1006u));
+  for (uint32_t i = 0; i < 10; ++i) {
+    msg.id = i;
+    auto lease = bitsery::ext::quickSerializationPooled(pool, msg);
+    EXPECT_THAT(lease.data(), Eq(data));
+    EXPECT_THAT(deserializeMessage(lease).id, Eq(i));
+  }
+  EXPECT_THAT(pool.createdCount(), Eq(1u));
+  EXPECT_THAT(pool.reusedCount(), Eq(10u));
+}
+
+TEST(BufferPool, RetainedMemoryIsBounded)
+{
+  BufferPool<Bytes> pool{ 10000, 2, 1000 };
+  {
+    auto l1 = pool.acquire();
+    auto l2 = pool.acquire();
+    auto l3 = pool.acquire();
+    EXPECT_THAT(pool.createdCount(), Eq(3u));
+  }
+  EXPECT_THAT(pool.freeBuffers(), Eq(2u));
+  EXPECT_THAT(pool.droppedCount(), Eq(1u));
+
+  // too big to keep
+  {
+    auto lease = pool.acquire();
+    lease.buffer().resize(20000);
+  }
+  EXPECT_THAT(pool.freeBuffers(), Eq(1u));
+  EXPECT_THAT(pool.droppedCount(), Eq(2u));
+
+  pool.limits(10000, 0);
+  EXPECT_THAT(pool.freeBuffers(), Eq(0u));
+  EXPECT_THAT(pool.retainedBytes(), Eq(0u));
+}
+
+TEST(BufferPool, ReleasedBufferIsNotRecycled)
+{
+  BufferPool<Bytes> pool{};
+  auto lease = pool.acquire();
+  auto moved = eastl::move(lease);
+  EXPECT_FALSE(lease.isValid());
+  EXPECT_TRUE(moved.isValid());
+  Bytes buf = moved.release();
+  EXPECT_THAT(buf.size(), Eq(4096u));
+  EXPECT_FALSE(moved.isValid());
+  EXPECT_THAT(pool.freeBuffers(), Eq(0u));
+}
+
+TEST(BufferPool, EachThreadHasItsOwnPool)
+{
+  Message msg{ 1, Bytes(10, 1) };
+  auto* mainPool = &BufferPool<Bytes>::local();
+  {
+    auto lease = bitsery::ext::quickSerializationPooled(msg);
+    EXPECT_THAT(deserializeMessage(lease).id, Eq(1u));
+  }
+  EXPECT_THAT(mainPool->freeBuffers(), Eq(1u));
+  std::thread th{ [&msg, mainPool]() {
+    EXPECT_NE(&BufferPool<Bytes>::local(), mainPool);
+    auto lease = bitsery::ext::quickSerializationPooled(msg);
+    EXPECT_THAT(deserializeMessage(lease).id, Eq(1u));
+  } };
+  th.join();
+  EXPECT_THAT(mainPool->createdCount(), Eq(1u));
+}
+
+TEST(MemResourceHugePages, SmallAndBigAllocations)
+{
+  MemResourceHugePages res{ 64 * 1024 };
+  auto small = static_cast<uint8_t*>(res.allocate(100, 8, 0));
+  auto big = static_cast<uint8_t*>(res.allocate(3 * 1024 * 1024, 64, 0));
+  small[99] = 1;
+  big[0] = 1;
+  big[3 * 1024 * 1024 - 1] = 2;
+  EXPECT_THAT(reinterpret_cast<uintptr_t>(big) % 64, Eq(0u));
+  res.deallocate(small, 100, 8, 0);
+  res.deallocate(big, 3 * 1024 * 1024, 64, 0);
+}
@@ -0,0 +1,326 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <bitsery/adapter/stream.h>
+#include <bitsery/ext/utils/chunked_archive.h>
+#include <bitsery/ext/utils/mapped_file.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <cstdio>
+#include <fstream>
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::ArchiveReader;
+using bitsery::ext::ArchiveWriter;
+using bitsery::ext::archiveKey;
+using bitsery::ext::crc32c;
+
+using testing::Eq;
+
+using Bytes = eastl::vector<uint8_t>;
+using BytesWriter = bitsery::OutputBufferAdapter<Bytes>;
+
+struct Physics
+{
+  eastl::vector<float> positions{};
+  uint32_t frame{};
+
+  bool operator==(const Physics& other) const
+  {
+    return positions == other.positions && frame == other.frame;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Physics& o)
+{
+  s.container4b(o.positions, 100000);
+  s.value4b(o.frame);
+}
+
+struct Inventory
+{
+  eastl::vector<uint16_t> items{};
+
+  bool operator==(const Inventory& other) const { return items == other.items; }
+};
+
+template<typename S>
+void
+serialize(S& s, Inventory& o)
+{
+  s.container2b(o.items, 1000);
+}
+
+// compresses runs of equal bytes as (count, byte) pairs
+struct RunLengthCodec : public bitsery::ext::ChunkCodec
+{
+  bool compress(const uint8_t* data, size_t size, Bytes& out) override
+  {
+    out.clear();
+    for (size_t i = 0; i < size;) {
+      size_t run = 1;
+      while (i + run < size && run < 255 && data[i + run] == data[i])
+        ++run;
+      out.push_back(static_cast<uint8_t>(run));
+      out.push_back(data[i]);
+      i += run;
+    }
+    return true;
+  }
+
+  bool decompress(const uint8_t* data,
+                  size_t size,
+                  uint8_t* out,
+                  size_t outSize) const override
+  {
+    size_t written = 0;
+    for (size_t i = 0; i + 1 < size; i += 2) {
+      if (written + data[i] > outSize)
+        return false;
+      for (size_t j = 0; j < data[i]; ++j)
+        out[written++] = data[i + 1];
+    }
+    return written == outSize;
+  }
+};
+
+static Physics
+createPhysics()
+{
+  Physics res{ eastl::vector<float>(1000, 0.0f), 42 };
+  res.positions[10] = 3.0f;
+  return res;
+}
+
+static Bytes
+createArchive(bitsery::ext::ChunkCodec* codec = nullptr)
+{
+  Bytes buf{};
+  ArchiveWriter<BytesWriter> writer{ BytesWriter{ buf }, codec };
+  writer.write(archiveKey("physics"), createPhysics());
+  writer.write(archiveKey("inventory"), Inventory{ { 1, 2, 3, 4, 5 } });
+  writer.write(7, Inventory{ { 7 } });
+  buf.resize(writer.finish());
+  return buf;
+}
+
+TEST(Crc32c, KnownValueAndContinuation)
+{
+  const char data[] = "123456789";
+  EXPECT_THAT(crc32c(data, 9), Eq(0xE3069283u));
+  EXPECT_THAT(crc32c(data + 4, 5, crc32c(data, 4)), Eq(0xE3069283u));
+  EXPECT_THAT(crc32c(data, 0), Eq(0u));
+}
+
+TEST(ChunkedArchive, LoadsOnlyRequestedChunks)
+{
+  auto buf = createArchive();
+  ArchiveReader<> reader{ buf.data(), buf.size() };
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(reader.entries().size(), Eq(3u));
+  EXPECT_TRUE(reader.contains(archiveKey("physics")));
+  EXPECT_FALSE(reader.contains(archiveKey("ai")));
+
+  Inventory inventory{};
+  auto res = reader.load(archiveKey("inventory"), inventory);
+  EXPECT_THAT(res.first, Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(res.second);
+  EXPECT_THAT(inventory, Eq(Inventory{ { 1, 2, 3, 4, 5 } }));
+
+  Physics physics{};
+  EXPECT_TRUE(reader.load(archiveKey("physics"), physics).second);
+  EXPECT_THAT(physics, Eq(createPhysics()));
+
+  EXPECT_THAT(reader.load(archiveKey("ai"), inventory).first,
+              Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(ChunkedArchive, CompressedChunks)
+{
+  RunLengthCodec codec{};
+  auto compressed = createArchive(&codec);
+  auto plain = createArchive();
+  EXPECT_LT(compressed.size(), plain.size());
+
+  ArchiveReader<> reader{ compressed.data(), compressed.size(), &codec };
+  auto physicsEntry = reader.find(archiveKey("physics"));
+  ASSERT_TRUE(physicsEntry != nullptr);
+  EXPECT_TRUE(physicsEntry->isCompressed());
+  EXPECT_LT(physicsEntry->size, physicsEntry->rawSize);
+  // doesn't get smaller, so it is stored uncompressed
+  EXPECT_FALSE(reader.find(archiveKey("inventory"))->isCompressed());
+
+  Physics physics{};
+  EXPECT_TRUE(reader.load(archiveKey("physics"), physics).second);
+  EXPECT_THAT(physics, Eq(createPhysics()));
+
+  ArchiveReader<> withoutCodec{ compressed.data(), compressed.size() };
+  EXPECT_THAT(withoutCodec.load(archiveKey("physics"), physics).first,
+              Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(ChunkedArchive, ParallelLoads)
+{
+  auto buf = createArchive();
+  ArchiveReader<> reader{ buf.data(), buf.size() };
+  bitsery::ext::ThreadPoolExecutor pool{ 3 };
+  Physics physics{};
+  Inventory inventory{};
+  Inventory other{};
+  ArchiveReader<>::LoadRequest requests[] = {
+    reader.request(archiveKey("physics"), physics),
+    reader.request(archiveKey("inventory"), inventory),
+    reader.request(7, other),
+  };
+  auto res = reader.loadParallel(pool, requests, 3);
+  EXPECT_THAT(res.first, Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(res.second);
+  EXPECT_THAT(physics, Eq(createPhysics()));
+  EXPECT_THAT(inventory, Eq(Inventory{ { 1, 2, 3, 4, 5 } }));
+  EXPECT_THAT(other, Eq(Inventory{ { 7 } }));
+}
+
+TEST(ChunkedArchive, WriteToStreamAndReadFromMappedFile)
+{
+  const char* path = "bitsery_chunked_archive_test.bin";
+  {
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    ArchiveWriter<bitsery::OutputBufferedStreamAdapter> writer{
+      bitsery::OutputBufferedStreamAdapter{ file }
+    };
+    writer.write(1, createPhysics());
+    writer.write(2, Inventory{ { 9, 8 } });
+    writer.finish();
+  }
+  {
+    bitsery::ext::MappedFile file{ path };
+    ASSERT_TRUE(file.isOpen());
+    ArchiveReader<> reader{ file.data(), file.size() };
+    Inventory inventory{};
+    EXPECT_TRUE(reader.load(2, inventory).second);
+    EXPECT_THAT(inventory, Eq(Inventory{ { 9, 8 } }));
+  }
+  std::remove(path);
+  EXPECT_FALSE(bitsery::ext::MappedFile{ path }.isOpen());
+}
+
+TEST(ChunkedArchive, CorruptedDataIsDetected)
+{
+  auto buf = createArchive();
+  ArchiveReader<> reader{ buf.data(), buf.size() };
+  auto entry = *reader.find(7);
+
+  // corrupted chunk fails checksum, other chunks still load
+  auto corrupted = buf;
+  corrupted[static_cast<size_t>(entry.offset)] ^= 1;
+  ArchiveReader<> corruptedChunk{ corrupted.data(), corrupted.size() };
+  Inventory inventory{};
+  EXPECT_THAT(corruptedChunk.load(7, inventory).first,
+              Eq(bitsery::ReaderError::InvalidData));
+  EXPECT_TRUE(corruptedChunk.load(archiveKey("inventory"), inventory).second);
+
+  // table of contents is right before 16 bytes trailer
+  corrupted = buf;
+  corrupted[corrupted.size() - 20] ^= 1;
+  ArchiveReader<> corruptedToc{ corrupted.data(), corrupted.size() };
+  EXPECT_THAT(corruptedToc.error(), Eq(bitsery::ReaderError::InvalidData));
+  EXPECT_TRUE(corruptedToc.entries().empty());
+  EXPECT_THAT(corruptedToc.load(7, inventory).first,
+              Eq(bitsery::ReaderError::InvalidData));
+
+  ArchiveReader<> truncated{ buf.data(), buf.size() - 1 };
+  EXPECT_THAT(truncated.error(), Eq(bitsery::ReaderError::InvalidData));
+  ArchiveReader<> tooSmall{ buf.data(), 20 };
+  EXPECT_THAT(tooSmall.error(), Eq(bitsery::ReaderError::DataOverflow));
+}
+
+TEST(ChunkedArchive, CompressedChunkLargerThanMaxChunkSizeIsNotLoaded)
+{
+  RunLengthCodec codec{};
+  auto buf = createArchive(&codec);
+  Physics physics{};
+  ArchiveReader<> limited{ buf.data(), buf.size(), &codec, 100 };
+  EXPECT_THAT(limited.load(archiveKey("physics"), physics).first,
+              Eq(bitsery::ReaderError::InvalidData));
+  // uncompressed chunks are bounded by archive size
+  Inventory inventory{};
+  EXPECT_TRUE(limited.load(archiveKey("inventory"), inventory).second);
+
+  ArchiveReader<> reader{ buf.data(), buf.size(), &codec };
+  auto rawSize = static_cast<size_t>(
+    reader.find(archiveKey("physics"))->rawSize);
+  ArchiveReader<> exact{ buf.data(), buf.size(), &codec, rawSize };
+  EXPECT_TRUE(exact.load(archiveKey("physics"), physics).second);
+  EXPECT_THAT(physics, Eq(createPhysics()));
+}
+
+#ifndef NDEBUG
+
+TEST(ChunkedArchive, WhenKeyIsDuplicatedThenAssert)
+{
+  Bytes buf{};
+  ArchiveWriter<BytesWriter> writer{ BytesWriter{ buf } };
+  EXPECT_TRUE(writer.write(7, Inventory{ { 7 } }));
+  EXPECT_DEATH(writer.write(7, Inventory{ { 8 } }), "");
+}
+
+#else
+
+TEST(ChunkedArchive, WhenKeyIsDuplicatedThenChunkIsNotWritten)
+{
+  Bytes buf{};
+  ArchiveWriter<BytesWriter> writer{ BytesWriter{ buf } };
+  EXPECT_TRUE(writer.write(7, Inventory{ { 7 } }));
+  EXPECT_FALSE(writer.write(7, Inventory{ { 8 } }));
+  buf.resize(writer.finish());
+  ArchiveReader<> reader{ buf.data(), buf.size() };
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+  Inventory inventory{};
+  EXPECT_TRUE(reader.load(7, inventory).second);
+  EXPECT_THAT(inventory, Eq(Inventory{ { 7 } }));
+}
+
+#endif
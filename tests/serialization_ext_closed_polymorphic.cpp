@@ -0,0 +1,263 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/closed_polymorphic.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::ClosedPolymorphic;
+using bitsery::ext::PointerType;
+
+using testing::Eq;
+
+using SerializationContext = BasicSerializationContext<void>;
+using BPSer = SerializationContext::TSerializerBPEnabled;
+using BPDes = SerializationContext::TDeserializerBPEnabled;
+
+struct Component
+{
+  uint8_t entity{};
+
+  virtual ~Component() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Component& o)
+{
+  s.value1b(o.entity);
+}
+
+struct Position : Component
+{
+  int16_t x{};
+  int16_t y{};
+};
+
+template<typename S>
+void
+serialize(S& s, Position& o)
+{
+  s.object(static_cast<Component&>(o));
+  s.value2b(o.x);
+  s.value2b(o.y);
+}
+
+struct Health : Component
+{
+  uint16_t hp{};
+};
+
+template<typename S>
+void
+serialize(S& s, Health& o)
+{
+  s.object(static_cast<Component&>(o));
+  s.value2b(o.hp);
+}
+
+struct Tag : Component
+{};
+
+template<typename S>
+void
+serialize(S& s, Tag& o)
+{
+  s.object(static_cast<Component&>(o));
+}
+
+using ComponentExt = ClosedPolymorphic<Component, Position, Health, Tag>;
+
+eastl::vector<eastl::unique_ptr<Component>>
+createComponents()
+{
+  eastl::vector<eastl::unique_ptr<Component>> res{};
+  auto pos = new Position{};
+  pos->entity = 1;
+  pos->x = -5;
+  pos->y = 300;
+  res.emplace_back(pos);
+  res.emplace_back(nullptr);
+  auto health = new Health{};
+  health->entity = 2;
+  health->hp = 1000;
+  res.emplace_back(health);
+  auto tag = new Tag{};
+  tag->entity = 3;
+  res.emplace_back(tag);
+  return res;
+}
+
+template<typename S>
+void
+serializeComponents(S& s, eastl::vector<eastl::unique_ptr<Component>>& v)
+{
+  s.container(v, 10, [](S& s, eastl::unique_ptr<Component>& c) {
+    s.ext(c, ComponentExt{});
+  });
+}
+
+void
+expectComponents(const eastl::vector<eastl::unique_ptr<Component>>& res)
+{
+  EXPECT_THAT(res.size(), Eq(4u));
+  auto pos = dynamic_cast<Position*>(res[0].get());
+  EXPECT_THAT(pos, ::testing::NotNull());
+  EXPECT_THAT(pos->entity, Eq(1));
+  EXPECT_THAT(pos->x, Eq(-5));
+  EXPECT_THAT(pos->y, Eq(300));
+  EXPECT_THAT(res[1], ::testing::IsNull());
+  auto health = dynamic_cast<Health*>(res[2].get());
+  EXPECT_THAT(health, ::testing::NotNull());
+  EXPECT_THAT(health->hp, Eq(1000));
+  auto tag = dynamic_cast<Tag*>(res[3].get());
+  EXPECT_THAT(tag, ::testing::NotNull());
+  EXPECT_THAT(tag->entity, Eq(3));
+}
+
+TEST(SerializeExtensionClosedPolymorphic, VectorOfUniquePtrs)
+{
+  auto data = createComponents();
+  eastl::vector<eastl::unique_ptr<Component>> res{};
+  SerializationContext ctx;
+  serializeComponents(ctx.createSerializer(), data);
+  serializeComponents(ctx.createDeserializer(), res);
+
+  // size + 4 indexes + objects, doesn't require any context
+  EXPECT_THAT(ctx.getBufferSize(), Eq(1u + 4u + 5u + 3u + 1u));
+  expectComponents(res);
+}
+
+TEST(SerializeExtensionClosedPolymorphic, IndexIsBitPackedWhenEnabled)
+{
+  auto data = createComponents();
+  eastl::vector<eastl::unique_ptr<Component>> res{};
+  SerializationContext ctx;
+  ctx.createSerializer().enableBitPacking(
+    [&data](BPSer& ser) { serializeComponents(ser, data); });
+  ctx.createDeserializer().enableBitPacking(
+    [&res](BPDes& des) { serializeComponents(des, res); });
+
+  // 2 bits for each index
+  const size_t bits = 4u * 2u + (5u + 3u + 1u) * 8u;
+  EXPECT_THAT(ctx.getBufferSize(), Eq(1u + (bits + 7u) / 8u));
+  expectComponents(res);
+}
+
+TEST(SerializeExtensionClosedPolymorphic,
+     ReusesObjectOfSameTypeAndRecreatesOther)
+{
+  auto data = createComponents();
+  eastl::vector<eastl::unique_ptr<Component>> res{};
+  res.emplace_back(new Position{});
+  res.emplace_back(new Health{});
+  res.emplace_back(new Tag{});
+  auto prevPos = res[0].get();
+  SerializationContext ctx;
+  serializeComponents(ctx.createSerializer(), data);
+  serializeComponents(ctx.createDeserializer(), res);
+
+  EXPECT_THAT(res[0].get(), Eq(prevPos));
+  expectComponents(res);
+}
+
+TEST(SerializeExtensionClosedPolymorphic, RawPointer)
+{
+  Component* data = new Health{};
+  static_cast<Health*>(data)->hp = 7;
+  Component* res = new Position{};
+  SerializationContext ctx;
+  ctx.createSerializer().ext(data, ComponentExt{});
+  ctx.createDeserializer().ext(res, ComponentExt{});
+
+  auto health = dynamic_cast<Health*>(res);
+  EXPECT_THAT(health, ::testing::NotNull());
+  EXPECT_THAT(health->hp, Eq(7));
+  delete data;
+  delete res;
+}
+
+TEST(SerializeExtensionClosedPolymorphic,
+     WhenIndexIsOutOfRangeThenInvalidData)
+{
+  Component* res = nullptr;
+  SerializationContext ctx;
+  ctx.createSerializer().value1b(uint8_t{ 4 });
+  auto& des = ctx.createDeserializer();
+  des.ext(res, ComponentExt{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+  EXPECT_THAT(res, ::testing::IsNull());
+}
+
+struct Unlisted : Component
+{};
+
+TEST(SerializeExtensionClosedPolymorphic,
+     WhenExistingObjectTypeIsNotListedThenInvalidData)
+{
+  Component* data = new Health{};
+  Component* res = new Unlisted{};
+  SerializationContext ctx;
+  ctx.createSerializer().ext(data, ComponentExt{});
+  auto& des = ctx.createDeserializer();
+  des.ext(res, ComponentExt{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+  // object is left as is, so it can still be destroyed by owner
+  EXPECT_THAT(dynamic_cast<Unlisted*>(res), ::testing::NotNull());
+  delete data;
+  delete res;
+}
+
+TEST(SerializeExtensionClosedPolymorphic,
+     WhenNotNullAndReadsNullThenInvalidPointer)
+{
+  Component* data = nullptr;
+  Component* res = nullptr;
+  SerializationContext ctx;
+  ctx.createSerializer().ext(data, ComponentExt{});
+  auto& des = ctx.createDeserializer();
+  des.ext(res, ComponentExt{ PointerType::NotNull });
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+}
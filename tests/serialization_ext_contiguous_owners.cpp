@@ -0,0 +1,295 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/contiguous_owners.h>
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::AllocationBudget;
+using bitsery::ext::ContiguousPointerOwners;
+using bitsery::ext::ContiguousUniquePtr;
+using bitsery::ext::MemResourceBase;
+using bitsery::ext::MemResourceNewDelete;
+using bitsery::ext::UntrackedEastlSmartPtr;
+
+using testing::Eq;
+
+using TSerializer = BasicSerializationContext<void>::TSerializer;
+using TDeserializer = BasicSerializationContext<void>::TDeserializer;
+
+struct CountingResource final : MemResourceBase
+{
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    ++allocs;
+    return MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    ++deallocs;
+    MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  size_t allocs{};
+  size_t deallocs{};
+};
+
+struct Particle
+{
+  static int alive;
+
+  Particle() { ++alive; }
+  Particle(float x_, float y_)
+    : x{ x_ }
+    , y{ y_ }
+  {
+    ++alive;
+  }
+  Particle(const Particle& other)
+    : x{ other.x }
+    , y{ other.y }
+  {
+    ++alive;
+  }
+  ~Particle() { --alive; }
+
+  float x{};
+  float y{};
+};
+
+int Particle::alive = 0;
+
+template<typename S>
+void
+serialize(S& s, Particle& o)
+{
+  s.value4b(o.x);
+  s.value4b(o.y);
+}
+
+using Particles = eastl::vector<ContiguousUniquePtr<Particle>>;
+
+Particles
+createParticles(size_t count, bool withNulls)
+{
+  Particles res{};
+  for (size_t i = 0; i < count; ++i) {
+    if (withNulls && i % 3 == 1)
+      res.emplace_back();
+    else
+      res.emplace_back(new Particle{ static_cast<float>(i), 1.0f });
+  }
+  return res;
+}
+
+class SerializeExtensionContiguousPointerOwners : public testing::Test
+{
+public:
+  CountingResource resource{};
+  BasicSerializationContext<void> sctx{};
+
+  void TearDown() override { EXPECT_THAT(Particle::alive, Eq(0)); }
+};
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       AllocatesAllObjectsAsSingleBlock)
+{
+  auto data = createParticles(10, false);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+  Particles res{};
+  sctx.createDeserializer().ext(res,
+                                ContiguousPointerOwners{ 100, &resource });
+
+  EXPECT_TRUE(sctx.des->adapter().isCompletedSuccessfully());
+  ASSERT_THAT(res.size(), Eq(10u));
+  for (size_t i = 0; i < res.size(); ++i) {
+    EXPECT_THAT(res[i]->x, Eq(data[i]->x));
+    EXPECT_THAT(res[i].get(), Eq(res[0].get() + i));
+  }
+  EXPECT_THAT(resource.allocs, Eq(1u));
+  res.clear();
+  EXPECT_THAT(resource.deallocs, Eq(1u));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       BlockIsFreedWhenLastObjectIsDestroyed)
+{
+  auto data = createParticles(10, true);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+  Particles res{};
+  sctx.createDeserializer().ext(res,
+                                ContiguousPointerOwners{ 100, &resource });
+  EXPECT_THAT(res[1], ::testing::IsNull());
+  EXPECT_THAT(res[2]->x, Eq(2.0f));
+  EXPECT_THAT(Particle::alive, Eq(14));
+
+  auto last = eastl::move(res[9]);
+  res.clear();
+  EXPECT_THAT(Particle::alive, Eq(8));
+  EXPECT_THAT(resource.deallocs, Eq(0u));
+  EXPECT_THAT(last->x, Eq(9.0f));
+  last.reset();
+  EXPECT_THAT(resource.deallocs, Eq(1u));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       WhenAllElementsAreNullThenBlockIsFreedImmediately)
+{
+  Particles data{};
+  data.resize(5);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+  Particles res = createParticles(3, false);
+  sctx.createDeserializer().ext(res,
+                                ContiguousPointerOwners{ 100, &resource });
+  EXPECT_THAT(res.size(), Eq(5u));
+  EXPECT_THAT(res[4], ::testing::IsNull());
+  EXPECT_THAT(resource.allocs, Eq(1u));
+  EXPECT_THAT(resource.deallocs, Eq(1u));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       WritesSameDataAsContainerOfUntrackedPointers)
+{
+  auto data = createParticles(10, true);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+
+  eastl::vector<eastl::unique_ptr<Particle>> res{};
+  sctx.createDeserializer().container(
+    res, 100, [](TDeserializer& des, eastl::unique_ptr<Particle>& ptr) {
+      des.ext(ptr, UntrackedEastlSmartPtr{});
+    });
+  EXPECT_TRUE(sctx.des->adapter().isCompletedSuccessfully());
+  ASSERT_THAT(res.size(), Eq(10u));
+  EXPECT_THAT(res[1], ::testing::IsNull());
+  EXPECT_THAT(res[9]->x, Eq(9.0f));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       UsesCurrentMemoryResourceByDefault)
+{
+  auto data = createParticles(3, false);
+  sctx.createSerializer().ext(
+    data, ContiguousPointerOwners{ 10 }, [](TSerializer& ser, Particle& p) {
+      ser.value4b(p.x);
+    });
+  Particles res{};
+  {
+    bitsery::ext::MemResourceScope scope{ &resource };
+    sctx.createDeserializer().ext(
+      res, ContiguousPointerOwners{ 10 }, [](TDeserializer& des, Particle& p) {
+        des.value4b(p.x);
+      });
+  }
+  EXPECT_THAT(res[2]->x, Eq(2.0f));
+  EXPECT_THAT(res[2]->y, Eq(0.0f));
+  EXPECT_THAT(resource.allocs, Eq(1u));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       WhenSizeIsGreaterThanMaxThenInvalidDataError)
+{
+  auto data = createParticles(10, false);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+  Particles res{};
+  sctx.createDeserializer().ext(res, ContiguousPointerOwners{ 5, &resource });
+  EXPECT_THAT(sctx.des->adapter().error(),
+              Eq(bitsery::ReaderError::InvalidData));
+  EXPECT_THAT(res.size(), Eq(0u));
+  EXPECT_THAT(resource.allocs, Eq(0u));
+}
+
+TEST(SerializeExtensionContiguousPointerOwnersWithBudget,
+     WhenBudgetIsExceededThenInvalidDataError)
+{
+  auto data = createParticles(10, false);
+  AllocationBudget budget{ sizeof(Particle) * 5 };
+  BasicSerializationContext<AllocationBudget> sctx{};
+  sctx.createSerializer(budget).ext(data, ContiguousPointerOwners{ 100 });
+  Particles res{};
+  sctx.createDeserializer(budget).ext(res, ContiguousPointerOwners{ 100 });
+  EXPECT_THAT(sctx.des->adapter().error(),
+              Eq(bitsery::ReaderError::InvalidData));
+  EXPECT_THAT(res.size(), Eq(0u));
+  data.clear();
+  EXPECT_THAT(Particle::alive, Eq(0));
+}
+
+TEST(ContiguousDeleter, DefaultConstructedDeletesObject)
+{
+  ContiguousUniquePtr<Particle> ptr{ new Particle{} };
+  EXPECT_THAT(Particle::alive, Eq(1));
+  ptr.reset();
+  EXPECT_THAT(Particle::alive, Eq(0));
+}
+
+TEST_F(SerializeExtensionContiguousPointerOwners,
+       ResetToUserObjectReleasesBlockOnlyOnce)
+{
+  auto data = createParticles(3, false);
+  sctx.createSerializer().ext(data, ContiguousPointerOwners{ 100 });
+  Particles res{};
+  sctx.createDeserializer().ext(res,
+                                ContiguousPointerOwners{ 100, &resource });
+
+  res[0].reset(new Particle{ 7.0f, 7.0f });
+  auto moved = eastl::move(res[1]);
+  res[1].reset(new Particle{ 8.0f, 8.0f });
+  EXPECT_THAT(Particle::alive, Eq(7));
+  EXPECT_THAT(resource.deallocs, Eq(0u));
+  moved.reset();
+  res[2].reset(new Particle{ 9.0f, 9.0f });
+  EXPECT_THAT(resource.deallocs, Eq(1u));
+  EXPECT_THAT(res[0]->x, Eq(7.0f));
+  EXPECT_THAT(res[1]->x, Eq(8.0f));
+  res.clear();
+  data.clear();
+  EXPECT_THAT(resource.deallocs, Eq(1u));
+}
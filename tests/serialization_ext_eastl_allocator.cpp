@@ -0,0 +1,299 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/pointer.h>
+#include <bitsery/ext/utils/eastl_allocator.h>
+#include <bitsery/ext/utils/memory_pools.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::MemResourceBase;
+using bitsery::ext::MemResourceEastlAllocator;
+using bitsery::ext::MemResourceMonotonic;
+using bitsery::ext::MemResourceNewDelete;
+using bitsery::ext::MemResourceScope;
+using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::PointerOwner;
+
+using testing::Eq;
+
+using Alloc = MemResourceEastlAllocator;
+using Text = eastl::basic_string<char, Alloc>;
+using Ids = eastl::vector<uint32_t, Alloc>;
+
+template<typename T>
+MemResourceBase*
+resourceOf(const T& container)
+{
+  return container.get_allocator().getMemResource();
+}
+
+struct CountingResource final : MemResourceBase
+{
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    ++allocs;
+    return MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    ++deallocs;
+    MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  size_t allocs{};
+  size_t deallocs{};
+};
+
+struct Document
+{
+  Text name{};
+  Ids ids{};
+  eastl::vector<Text, Alloc> tags{};
+};
+
+template<typename S>
+void
+serialize(S& s, Document& o)
+{
+  s.text1b(o.name, 100);
+  s.container4b(o.ids, 100);
+  s.container(o.tags, 100, [](S& s, Text& tag) { s.text1b(tag, 100); });
+}
+
+struct Message
+{
+  Document* doc{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.ext(o.doc, PointerOwner{});
+}
+
+Document
+createDocument()
+{
+  Document res{};
+  res.name = "some longer name, that doesn't fit into small string buffer";
+  res.ids.push_back(1);
+  res.ids.push_back(2);
+  res.ids.push_back(3);
+  res.tags.push_back(Text{ "first tag, that doesn't fit small string buffer" });
+  res.tags.push_back(Text{ "second tag, that doesn't fit small string" });
+  return res;
+}
+
+TEST(MemResourceEastlAllocator, ForwardsToMemoryResource)
+{
+  CountingResource resource{};
+  Alloc alloc{ &resource };
+  auto ptr = alloc.allocate(100);
+  alloc.deallocate(ptr, 100);
+  ptr = alloc.allocate(100, 8, 0);
+  alloc.deallocate(ptr, 100);
+  EXPECT_THAT(resource.allocs, Eq(2u));
+  EXPECT_THAT(resource.deallocs, Eq(2u));
+
+  EXPECT_TRUE(alloc == Alloc{ &resource });
+  EXPECT_TRUE(alloc != Alloc{});
+  Alloc named{ alloc, "named" };
+  EXPECT_THAT(named.getMemResource(), Eq(&resource));
+  EXPECT_THAT(named.get_name(), ::testing::StrEq("named"));
+}
+
+TEST(MemResourceEastlAllocator, DefaultConstructedUsesCurrentResource)
+{
+  CountingResource resource{};
+  EXPECT_THAT(Alloc{}.getMemResource(), ::testing::IsNull());
+  {
+    MemResourceScope scope{ &resource };
+    EXPECT_THAT(Alloc{}.getMemResource(), Eq(&resource));
+    {
+      MemResourceScope inner{ nullptr };
+      EXPECT_THAT(Alloc{ "name" }.getMemResource(), ::testing::IsNull());
+    }
+    Ids ids{};
+    ids.resize(100);
+    EXPECT_THAT(resourceOf(ids), Eq(&resource));
+  }
+  EXPECT_THAT(Alloc{}.getMemResource(), ::testing::IsNull());
+  EXPECT_THAT(resource.allocs, ::testing::Gt(0u));
+  EXPECT_THAT(resource.deallocs, Eq(resource.allocs));
+}
+
+TEST(MemResourceEastlAllocator, ContainersInPointerSubtreeUseObjectResource)
+{
+  auto data = createDocument();
+  Message msg{ &data };
+  MemResourceMonotonic arena{};
+  PointerLinkingContext plctx{ &arena };
+  BasicSerializationContext<PointerLinkingContext> sctx{};
+  sctx.createSerializer(plctx).object(msg);
+  Message res{};
+  sctx.createDeserializer(plctx).object(res);
+
+  ASSERT_THAT(res.doc, ::testing::NotNull());
+  EXPECT_THAT(res.doc->name, Eq(data.name));
+  EXPECT_THAT(res.doc->ids, Eq(data.ids));
+  EXPECT_THAT(res.doc->tags[1], Eq(data.tags[1]));
+  EXPECT_THAT(resourceOf(res.doc->name), Eq(&arena));
+  EXPECT_THAT(resourceOf(res.doc->ids), Eq(&arena));
+  EXPECT_THAT(resourceOf(res.doc->tags), Eq(&arena));
+  EXPECT_THAT(resourceOf(res.doc->tags[0]), Eq(&arena));
+  // scope is restored after deserialization
+  EXPECT_THAT(bitsery::ext::currentMemResource(), ::testing::IsNull());
+  const auto bytes = arena.allocatedBytes();
+  EXPECT_THAT(bytes,
+              ::testing::Gt(sizeof(Document) + data.name.size() +
+                            data.tags[0].size() + data.tags[1].size()));
+  // destructors doesn't free anything, whole tree is released at once
+  res.doc->~Document();
+  EXPECT_THAT(arena.allocatedBytes(), Eq(bytes));
+  arena.release();
+}
+
+TEST(MemResourceEastlAllocator, PointerWithoutResourceKeepsOuterScope)
+{
+  auto data = createDocument();
+  Message msg{ &data };
+  PointerLinkingContext plctx{};
+  BasicSerializationContext<PointerLinkingContext> sctx{};
+  sctx.createSerializer(plctx).object(msg);
+
+  MemResourceMonotonic arena{};
+  Message res{};
+  {
+    MemResourceScope scope{ &arena };
+    sctx.createDeserializer(plctx).object(res);
+    EXPECT_THAT(bitsery::ext::currentMemResource(), Eq(&arena));
+  }
+  ASSERT_THAT(res.doc, ::testing::NotNull());
+  EXPECT_THAT(res.doc->tags[1], Eq(data.tags[1]));
+  // object itself is allocated with new, but its containers use outer scope
+  EXPECT_THAT(resourceOf(res.doc->name), Eq(&arena));
+  EXPECT_THAT(resourceOf(res.doc->ids), Eq(&arena));
+  EXPECT_THAT(resourceOf(res.doc->tags[0]), Eq(&arena));
+  delete res.doc;
+  arena.release();
+}
+
+template<bool Propagate>
+struct PropagatingMessage
+{
+  Document* doc{};
+  MemResourceBase* resource{};
+};
+
+template<typename S, bool Propagate>
+void
+serialize(S& s, PropagatingMessage<Propagate>& o)
+{
+  s.ext(o.doc,
+        PointerOwner{ bitsery::ext::PointerType::Nullable,
+                      o.resource,
+                      Propagate });
+}
+
+TEST(MemResourceEastlAllocator, PointerResourceIsUsedInSubtreeOnlyIfPropagated)
+{
+  auto data = createDocument();
+  PointerLinkingContext plctx{};
+  BasicSerializationContext<PointerLinkingContext> sctx{};
+  PropagatingMessage<false> msg{ &data };
+  sctx.createSerializer(plctx).object(msg);
+
+  CountingResource resource{};
+  PropagatingMessage<false> res{ nullptr, &resource };
+  sctx.createDeserializer(plctx).object(res);
+  ASSERT_THAT(res.doc, ::testing::NotNull());
+  // object is allocated from pointer resource, containers keep current scope
+  EXPECT_THAT(resource.allocs, Eq(1u));
+  EXPECT_THAT(resourceOf(res.doc->name), ::testing::IsNull());
+  EXPECT_THAT(resourceOf(res.doc->tags[0]), ::testing::IsNull());
+  res.doc->~Document();
+  resource.deallocate(res.doc, sizeof(Document), alignof(Document), 0);
+
+  PropagatingMessage<true> propagated{ nullptr, &resource };
+  PointerLinkingContext plctx2{};
+  sctx.createDeserializer(plctx2).object(propagated);
+  ASSERT_THAT(propagated.doc, ::testing::NotNull());
+  EXPECT_THAT(resourceOf(propagated.doc->name), Eq(&resource));
+  EXPECT_THAT(resourceOf(propagated.doc->tags[0]), Eq(&resource));
+  propagated.doc->~Document();
+  resource.deallocate(
+    propagated.doc, sizeof(Document), alignof(Document), 0);
+  EXPECT_THAT(resource.deallocs, Eq(resource.allocs));
+}
+
+TEST(MemResourceEastlAllocator, ScopeCanBeUsedForTopLevelObjects)
+{
+  eastl::vector<Document, Alloc> data{};
+  data.push_back(createDocument());
+  data.push_back(createDocument());
+
+  BasicSerializationContext<void> sctx{};
+  sctx.createSerializer().container(data, 10);
+
+  MemResourceMonotonic arena{};
+  {
+    MemResourceScope scope{ &arena };
+    eastl::vector<Document, Alloc> res{};
+    sctx.createDeserializer().container(res, 10);
+    ASSERT_THAT(res.size(), Eq(2u));
+    EXPECT_THAT(res[1].tags[1], Eq(data[1].tags[1]));
+    EXPECT_THAT(resourceOf(res), Eq(&arena));
+    EXPECT_THAT(resourceOf(res[1].tags[1]), Eq(&arena));
+  }
+  arena.release();
+}
@@ -171,3 +171,167 @@ TYPED_TEST(SerializeExtensionEastlMap, SerializeAndDeserializeEquals)
   ctx1.createDeserializer().object(this->res);
   EXPECT_THAT(this->res, Eq(this->src));
 }
+
+template<typename S>
+void
+serializeIntMap(S& s, int32_t& key, eastl::string& value)
+{
+  s.value4b(key);
+  s.text1b(value, 100);
+}
+
+TEST(SerializeExtensionEastlMapReuse, UpdatesExistingEntriesOfOrderedMapInPlace)
+{
+  eastl::map<int32_t, eastl::string> src{ { 2, "two" },
+                                          { 3, "three" },
+                                          { 5, "five" } };
+  eastl::map<int32_t, eastl::string> res{ { 1, "x" },
+                                          { 2, "y" },
+                                          { 3, "z" },
+                                          { 4, "w" } };
+  auto* two = &res[2];
+  auto* three = &res[3];
+
+  SerializationContext ctx;
+  ctx.createSerializer().ext(
+    src, EastlMap{ 10 }, serializeIntMap<SerializationContext::TSerializer>);
+  ctx.createDeserializer().ext(
+    res,
+    EastlMap{ 10, true },
+    serializeIntMap<SerializationContext::TDeserializer>);
+
+  EXPECT_THAT(res, Eq(src));
+  EXPECT_THAT(&res[2], Eq(two));
+  EXPECT_THAT(&res[3], Eq(three));
+}
+
+TEST(SerializeExtensionEastlMapReuse, UpdatesExistingEntriesOfUnorderedMapInPlace)
+{
+  eastl::unordered_map<int32_t, eastl::string> src{ { 2, "two" },
+                                                    { 3, "three" },
+                                                    { 5, "five" } };
+  eastl::unordered_map<int32_t, eastl::string> res{ { 1, "x" },
+                                                    { 2, "y" },
+                                                    { 3, "z" },
+                                                    { 4, "w" } };
+  auto* two = &res[2];
+  auto* three = &res[3];
+
+  SerializationContext ctx;
+  ctx.createSerializer().ext(
+    src, EastlMap{ 10 }, serializeIntMap<SerializationContext::TSerializer>);
+  ctx.createDeserializer().ext(
+    res,
+    EastlMap{ 10, true },
+    serializeIntMap<SerializationContext::TDeserializer>);
+
+  EXPECT_THAT(res, Eq(src));
+  EXPECT_THAT(&res[2], Eq(two));
+  EXPECT_THAT(&res[3], Eq(three));
+}
+
+TEST(SerializeExtensionEastlMapReuse, UnorderedMapWithDuplicateKeysInData)
+{
+  eastl::unordered_map<int32_t, eastl::string> res{ { 1, "x" }, { 2, "y" } };
+
+  SerializationContext ctx;
+  auto& ser = ctx.createSerializer();
+  bitsery::details::writeSize(ser.adapter(), 2u);
+  for (auto value : { "a", "b" }) {
+    int32_t key = 1;
+    eastl::string str{ value };
+    serializeIntMap(ser, key, str);
+  }
+  ctx.createDeserializer().ext(
+    res,
+    EastlMap{ 10, true },
+    serializeIntMap<SerializationContext::TDeserializer>);
+
+  // same as deserializing without reuse
+  EXPECT_THAT(res.size(), Eq(1u));
+  EXPECT_THAT(res[1], Eq("b"));
+}
+
+TEST(SerializeExtensionEastlMapReuse, NestedUnorderedMaps)
+{
+  using TInner = eastl::unordered_map<int32_t, eastl::string>;
+  eastl::unordered_map<int32_t, TInner> src{};
+  for (int32_t i = 0; i < 5; ++i)
+    for (int32_t j = 0; j <= i; ++j)
+      src[i][j] = "v";
+  eastl::unordered_map<int32_t, TInner> res{ { 0, { { 7, "x" } } },
+                                             { 9, { { 1, "y" } } } };
+
+  SerializationContext ctx;
+  ctx.createSerializer().ext(
+    src,
+    EastlMap{ 10 },
+    [](SerializationContext::TSerializer& s, int32_t& key, TInner& value) {
+      s.value4b(key);
+      s.ext(value,
+            EastlMap{ 10 },
+            serializeIntMap<SerializationContext::TSerializer>);
+    });
+  ctx.createDeserializer().ext(
+    res,
+    EastlMap{ 10, true },
+    [](SerializationContext::TDeserializer& s, int32_t& key, TInner& value) {
+      s.value4b(key);
+      s.ext(value,
+            EastlMap{ 10, true },
+            serializeIntMap<SerializationContext::TDeserializer>);
+    });
+
+  EXPECT_THAT(res, Eq(src));
+}
+
+TEST(SerializeExtensionEastlMapReuse, OrderedMapAcceptsUnsortedData)
+{
+  eastl::unordered_map<int32_t, eastl::string> src{};
+  for (int32_t i = 0; i < 20; ++i)
+    src.emplace(i * 7 % 20, "v");
+  eastl::map<int32_t, eastl::string> res{ { 3, "x" }, { 30, "y" } };
+
+  SerializationContext ctx;
+  ctx.createSerializer().ext(
+    src, EastlMap{ 100 }, serializeIntMap<SerializationContext::TSerializer>);
+  ctx.createDeserializer().ext(
+    res,
+    EastlMap{ 100, true },
+    serializeIntMap<SerializationContext::TDeserializer>);
+
+  EXPECT_THAT(res.size(), Eq(src.size()));
+  for (auto& v : src)
+    EXPECT_THAT(res[v.first], Eq(v.second));
+}
+
+TEST(SerializeExtensionEastlMapReuse, MultimapsKeepAllEqualKeys)
+{
+  eastl::multimap<int32_t, eastl::string> src{
+    { 1, "a" }, { 1, "b" }, { 1, "c" }, { 4, "d" }
+  };
+  eastl::multimap<int32_t, eastl::string> res{ { 1, "x" }, { 2, "y" } };
+  eastl::unordered_multimap<int32_t, eastl::string> srcHash{ src.begin(),
+                                                             src.end() };
+  eastl::unordered_multimap<int32_t, eastl::string> resHash{ { 1, "x" },
+                                                             { 1, "y" } };
+
+  SerializationContext ctx;
+  auto& ser = ctx.createSerializer();
+  ser.ext(
+    src, EastlMap{ 10 }, serializeIntMap<SerializationContext::TSerializer>);
+  ser.ext(srcHash,
+          EastlMap{ 10 },
+          serializeIntMap<SerializationContext::TSerializer>);
+  auto& des = ctx.createDeserializer();
+  des.ext(res,
+          EastlMap{ 10, true },
+          serializeIntMap<SerializationContext::TDeserializer>);
+  des.ext(resHash,
+          EastlMap{ 10, true },
+          serializeIntMap<SerializationContext::TDeserializer>);
+
+  EXPECT_THAT(res, Eq(src));
+  EXPECT_THAT(resHash.size(), Eq(srcHash.size()));
+  EXPECT_THAT(resHash.count(1), Eq(3u));
+}
@@ -77,6 +77,35 @@ TYPED_TEST(SerializeExtensionEastlSet, ValuesSyntaxDifferentSetTypes)
   EXPECT_THAT(this->res, Eq(this->src));
 }
 
+TYPED_TEST(SerializeExtensionEastlSet, ReuseEntriesDifferentSetTypes)
+{
+  SerializationContext ctx1;
+  ctx1.createSerializer().ext4b(this->src, EastlSet{ 10 });
+  ctx1.createDeserializer().ext4b(this->res, EastlSet{ 10, true });
+  EXPECT_THAT(this->res, Eq(this->src));
+}
+
+TEST(SerializeExtensionEastlSet, ReuseEntriesKeepsExistingNodes)
+{
+  SerializationContext ctx1;
+  eastl::set<int32_t> t1{ 1, 5, 8, 9 };
+  eastl::set<int32_t> r1{ 0, 5, 7, 8, 10 };
+  eastl::unordered_set<int32_t> t2{ t1.begin(), t1.end() };
+  eastl::unordered_set<int32_t> r2{ r1.begin(), r1.end() };
+  auto five = &*r1.find(5);
+  auto eight = &*r2.find(8);
+  auto& ser = ctx1.createSerializer();
+  ser.ext4b(t1, EastlSet{ 10 });
+  ser.ext4b(t2, EastlSet{ 10 });
+  auto& des = ctx1.createDeserializer();
+  des.ext4b(r1, EastlSet{ 10, true });
+  des.ext4b(r2, EastlSet{ 10, true });
+  EXPECT_THAT(r1, Eq(t1));
+  EXPECT_THAT(r2, Eq(t2));
+  EXPECT_THAT(&*r1.find(5), Eq(five));
+  EXPECT_THAT(&*r2.find(8), Eq(eight));
+}
+
 TEST(SerializeExtensionEastlSet, ObjectSyntax)
 {
   SerializationContext ctx1;
@@ -60,6 +60,7 @@ using bitsery::ext::StandardRTTI;
 
 using bitsery::ext::PointerObserver;
 using bitsery::ext::EastlSmartPtr;
+using bitsery::ext::UntrackedEastlSmartPtr;
 
 using testing::Eq;
 using testing::Ne;
@@ -239,8 +240,15 @@ using TestingWithNonPolymorphicTypes =
 TYPED_TEST_SUITE(SerializeExtensionEastlSmartPtrNonPolymorphicType,
                  TestingWithNonPolymorphicTypes, );
 
+struct UntrackedUniquePtrTest
+{
+  template<typename T>
+  using TData = eastl::unique_ptr<T>;
+  using TExt = UntrackedEastlSmartPtr;
+};
+
 using TestingWithPolymorphicTypes =
-  ::testing::Types<UniquePtrTest, SharedPtrTest>;
+  ::testing::Types<UniquePtrTest, SharedPtrTest, UntrackedUniquePtrTest>;
 
 TYPED_TEST_SUITE(SerializeExtensionEastlSmartPtrPolymorphicType,
                  TestingWithPolymorphicTypes, );
@@ -813,3 +821,102 @@ TEST_F(SerializeExtensionEastlSmartUniquePtr, WithCustomDeleter)
   EXPECT_THAT(resPtr->x, Eq(dataPtr->x));
   EXPECT_THAT(dynamic_cast<Derived*>(resPtr.get()), ::testing::NotNull());
 }
+
+struct UniqueTreeNode
+{
+  uint8_t value{};
+  eastl::unique_ptr<UniqueTreeNode> left{};
+  eastl::unique_ptr<UniqueTreeNode> right{};
+};
+
+template<typename S>
+void
+serialize(S& s, UniqueTreeNode& o)
+{
+  s.value1b(o.value);
+  s.ext(o.left, UntrackedEastlSmartPtr{});
+  s.ext(o.right, UntrackedEastlSmartPtr{});
+}
+
+TEST(SerializeExtensionEastlSmartUntrackedUniquePtr,
+     SerializesTreeWithoutPointerLinkingContext)
+{
+  eastl::unique_ptr<UniqueTreeNode> data{ new UniqueTreeNode{} };
+  data->value = 1;
+  data->left.reset(new UniqueTreeNode{});
+  data->left->value = 2;
+  data->left->right.reset(new UniqueTreeNode{});
+  data->left->right->value = 3;
+  eastl::unique_ptr<UniqueTreeNode> res{ new UniqueTreeNode{} };
+  res->right.reset(new UniqueTreeNode{});
+
+  BasicSerializationContext<void> sctx;
+  sctx.createSerializer().ext(data, UntrackedEastlSmartPtr{});
+  auto& des = sctx.createDeserializer();
+  des.ext(res, UntrackedEastlSmartPtr{});
+
+  // presence flag is 1 byte per pointer, no pointer ids are written
+  EXPECT_THAT(sctx.getBufferSize(), Eq(1u + 3u * 3u));
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(res->value, Eq(1));
+  EXPECT_THAT(res->right, ::testing::IsNull());
+  EXPECT_THAT(res->left->value, Eq(2));
+  EXPECT_THAT(res->left->left, ::testing::IsNull());
+  EXPECT_THAT(res->left->right->value, Eq(3));
+}
+
+TEST(SerializeExtensionEastlSmartPtrWithStaticPolymorphicContext,
+     SharedPtrDeleterCanOutliveDeserialization)
+{
+  using TContext =
+    eastl::tuple<PointerLinkingContext,
+                 InheritanceContext,
+                 bitsery::ext::StaticPolymorphicContext<StandardRTTI>>;
+  eastl::shared_ptr<Base> data{ new MoreDerived{ 1, 2, 3 } };
+  eastl::shared_ptr<Base> res{};
+  {
+    TContext ctx{};
+    BasicSerializationContext<TContext> sctx;
+    sctx.createSerializer(ctx).ext(data, EastlSmartPtr{});
+    sctx.createDeserializer(ctx).ext(res, EastlSmartPtr{});
+    eastl::get<0>(ctx).clearSharedState();
+  }
+  auto* moreDerived = dynamic_cast<MoreDerived*>(res.get());
+  EXPECT_THAT(moreDerived, ::testing::NotNull());
+  EXPECT_THAT(moreDerived->z, Eq(3));
+  EXPECT_THAT(res.use_count(), Eq(1));
+  res.reset();
+}
+
+TEST(SerializeExtensionEastlSmartPtrWithFrozenPolymorphicContext,
+     SharedPtrDeleterCanOutliveContext)
+{
+  using TContext =
+    eastl::tuple<PointerLinkingContext,
+                 InheritanceContext,
+                 bitsery::ext::FrozenPolymorphicContext<StandardRTTI>&>;
+  using SerContext = BasicSerializationContext<TContext>;
+  eastl::shared_ptr<Base> data{ new MoreDerived{ 1, 2, 3 } };
+  eastl::shared_ptr<Base> res{};
+  {
+    bitsery::ext::FrozenPolymorphicContext<StandardRTTI> serPc{};
+    serPc.registerBasesList<SerContext::TSerializer>(
+      bitsery::ext::PolymorphicClassesList<Base>{});
+    serPc.freeze();
+    bitsery::ext::FrozenPolymorphicContext<StandardRTTI> desPc{};
+    desPc.registerBasesList<SerContext::TDeserializer>(
+      bitsery::ext::PolymorphicClassesList<Base>{});
+    desPc.freeze();
+    TContext serCtx{ PointerLinkingContext{}, InheritanceContext{}, serPc };
+    TContext desCtx{ PointerLinkingContext{}, InheritanceContext{}, desPc };
+    SerContext sctx;
+    sctx.createSerializer(serCtx).ext(data, EastlSmartPtr{});
+    sctx.createDeserializer(desCtx).ext(res, EastlSmartPtr{});
+    eastl::get<0>(desCtx).clearSharedState();
+  }
+  auto* moreDerived = dynamic_cast<MoreDerived*>(res.get());
+  EXPECT_THAT(moreDerived, ::testing::NotNull());
+  EXPECT_THAT(moreDerived->z, Eq(3));
+  EXPECT_THAT(res.use_count(), Eq(1));
+  res.reset();
+}
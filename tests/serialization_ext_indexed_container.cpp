@@ -0,0 +1,236 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <bitsery/ext/indexed_container.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::IndexedContainer;
+using bitsery::ext::LazyContainerView;
+
+using testing::Eq;
+
+struct Item
+{
+  uint32_t id{};
+  eastl::vector<uint16_t> values{};
+
+  bool operator==(const Item& other) const
+  {
+    return id == other.id && values == other.values;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Item& o)
+{
+  s.value4b(o.id);
+  s.container2b(o.values, 1000);
+}
+
+// the same data, deserialized either fully or as a view
+template<typename TItems>
+struct Table
+{
+  uint32_t before{};
+  TItems items{};
+  uint32_t after{};
+};
+
+template<typename S, typename TItems>
+void
+serialize(S& s, Table<TItems>& o)
+{
+  s.value4b(o.before);
+  s.ext(o.items, IndexedContainer{ 1000 });
+  s.value4b(o.after);
+}
+
+static eastl::vector<Item>
+createItems(size_t count)
+{
+  eastl::vector<Item> res{};
+  for (size_t i = 0; i < count; ++i)
+    res.push_back(Item{ static_cast<uint32_t>(i),
+                        eastl::vector<uint16_t>(i % 7, 3) });
+  return res;
+}
+
+TEST(SerializeExtensionIndexedContainer, RoundTrip)
+{
+  SerializationContext ctx{};
+  Table<eastl::vector<Item>> data{ 1, createItems(100), 2 };
+  ctx.createSerializer().object(data);
+  // items: size, offsets table and elements
+  size_t itemsSize = 1 + 100 * 4;
+  for (auto& item : data.items)
+    itemsSize += 4 + 1 + item.values.size() * 2;
+  EXPECT_THAT(ctx.getBufferSize(), Eq(4 + itemsSize + 4));
+
+  Table<eastl::vector<Item>> res{};
+  ctx.createDeserializer().object(res);
+  EXPECT_THAT(res.before, Eq(1u));
+  EXPECT_THAT(res.items, Eq(data.items));
+  EXPECT_THAT(res.after, Eq(2u));
+  EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionIndexedContainer, LazyViewDeserializesRequestedElements)
+{
+  SerializationContext ctx{};
+  Table<eastl::vector<Item>> data{ 1, createItems(100), 2 };
+  ctx.createSerializer().object(data);
+
+  Table<LazyContainerView<Item>> view{};
+  ctx.createDeserializer().object(view);
+  EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+  EXPECT_THAT(view.before, Eq(1u));
+  EXPECT_THAT(view.after, Eq(2u));
+  EXPECT_THAT(view.items.size(), Eq(100u));
+  for (size_t i : { 99u, 0u, 50u, 13u }) {
+    Item item{};
+    auto res = view.items.get(i, item);
+    EXPECT_THAT(res.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(res.second);
+    EXPECT_THAT(item, Eq(data.items[i]));
+    EXPECT_THAT(view.items.elementSize(i),
+                Eq(bitsery::quickSerialization(bitsery::MeasureSize{}, item)));
+  }
+}
+
+TEST(SerializeExtensionIndexedContainer, ValueAndLambdaOverloads)
+{
+  SerializationContext ctx{};
+  eastl::vector<uint32_t> values{ 1, 2, 3 };
+  eastl::vector<eastl::vector<uint8_t>> lists{ { 1 }, {}, { 2, 3, 4 } };
+  auto& ser = ctx.createSerializer();
+  ser.ext4b(values, IndexedContainer{ 10 });
+  ser.ext(lists,
+          IndexedContainer{ 10 },
+          [](auto& s, eastl::vector<uint8_t>& v) { s.container1b(v, 10); });
+
+  eastl::vector<uint32_t> valuesRes{};
+  eastl::vector<eastl::vector<uint8_t>> listsRes{};
+  auto& des = ctx.createDeserializer();
+  des.ext4b(valuesRes, IndexedContainer{ 10 });
+  des.ext(listsRes,
+          IndexedContainer{ 10 },
+          [](auto& s, eastl::vector<uint8_t>& v) { s.container1b(v, 10); });
+  EXPECT_THAT(valuesRes, Eq(values));
+  EXPECT_THAT(listsRes, Eq(lists));
+
+  bitsery::Deserializer<Reader> des2{ ctx.buf.begin(), ctx.getBufferSize() };
+  LazyContainerView<uint32_t> valuesView{};
+  LazyContainerView<eastl::vector<uint8_t>> listsView{};
+  des2.ext(valuesView, IndexedContainer{ 10 });
+  des2.ext(listsView, IndexedContainer{ 10 });
+  EXPECT_TRUE(des2.adapter().isCompletedSuccessfully());
+  eastl::vector<uint8_t> list{};
+  EXPECT_TRUE(listsView
+                .get(2,
+                     list,
+                     [](auto& s, eastl::vector<uint8_t>& v) {
+                       s.container1b(v, 10);
+                     })
+                .second);
+  EXPECT_THAT(list, Eq(lists[2]));
+  uint32_t value{};
+  EXPECT_TRUE(valuesView
+                .get(1, value, [](auto& s, uint32_t& v) { s.value4b(v); })
+                .second);
+  EXPECT_THAT(value, Eq(2u));
+}
+
+TEST(SerializeExtensionIndexedContainer, EmptyContainer)
+{
+  SerializationContext ctx{};
+  Table<eastl::vector<Item>> data{ 1, {}, 2 };
+  ctx.createSerializer().object(data);
+  EXPECT_THAT(ctx.getBufferSize(), Eq(9u));
+
+  Table<LazyContainerView<Item>> view{};
+  ctx.createDeserializer().object(view);
+  EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+  EXPECT_TRUE(view.items.empty());
+  EXPECT_THAT(view.after, Eq(2u));
+}
+
+TEST(SerializeExtensionIndexedContainer, InvalidOffsetsSetError)
+{
+  SerializationContext ctx{};
+  Table<eastl::vector<Item>> data{ 1, createItems(3), 2 };
+  ctx.createSerializer().object(data);
+  // offsets table starts after `before` and size
+  const size_t table = 5;
+
+  // second element ends before the first one
+  auto decreasing = ctx.buf;
+  decreasing[table + 4] = 0;
+  Table<LazyContainerView<Item>> view{};
+  {
+    bitsery::Deserializer<Reader> des{ decreasing.begin(),
+                                       ctx.getBufferSize() };
+    des.object(view);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(view.items.empty());
+  }
+  {
+    Table<eastl::vector<Item>> res{};
+    bitsery::Deserializer<Reader> des{ decreasing.begin(),
+                                       ctx.getBufferSize() };
+    des.object(res);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+  }
+
+  // last element ends after the end of buffer
+  auto overflow = ctx.buf;
+  overflow[table + 8 + 1] = 1;
+  {
+    bitsery::Deserializer<Reader> des{ overflow.begin(), ctx.getBufferSize() };
+    des.object(view);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::DataOverflow));
+  }
+}
@@ -0,0 +1,310 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <bitsery/ext/indexed_map.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <EASTL/map.h>
+#include <EASTL/unordered_map.h>
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::IndexedMap;
+using bitsery::ext::LazyMapView;
+using bitsery::ext::MapKeyLayout;
+
+using testing::Eq;
+
+struct Item
+{
+  uint32_t id{};
+  eastl::vector<uint16_t> values{};
+
+  bool operator==(const Item& other) const
+  {
+    return id == other.id && values == other.values;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Item& o)
+{
+  s.value4b(o.id);
+  s.container2b(o.values, 1000);
+}
+
+// the same data, deserialized either fully or as a view
+template<typename TItems>
+struct Table
+{
+  uint32_t before{};
+  TItems items{};
+  uint32_t after{};
+  MapKeyLayout layout{ MapKeyLayout::Sorted };
+};
+
+template<typename S, typename TItems>
+void
+serialize(S& s, Table<TItems>& o)
+{
+  s.value4b(o.before);
+  s.ext(o.items, IndexedMap{ 1000, o.layout });
+  s.value4b(o.after);
+}
+
+using ItemsMap = eastl::map<uint32_t, Item>;
+using ItemsView = LazyMapView<uint32_t, Item>;
+
+static ItemsMap
+createItems(size_t count)
+{
+  ItemsMap res{};
+  for (size_t i = 0; i < count; ++i) {
+    const auto key = static_cast<uint32_t>(i * 3 + 1);
+    res.emplace(key, Item{ key, eastl::vector<uint16_t>(i % 7, 3) });
+  }
+  return res;
+}
+
+TEST(SerializeExtensionIndexedMap, RoundTrip)
+{
+  SerializationContext ctx{};
+  Table<ItemsMap> data{ 1, createItems(100), 2 };
+  ctx.createSerializer().object(data);
+  // items: size, layout, keys, offsets table and values
+  size_t itemsSize = 1 + 1 + 100 * 4 + 100 * 4;
+  for (auto& item : data.items)
+    itemsSize += 4 + 1 + item.second.values.size() * 2;
+  EXPECT_THAT(ctx.getBufferSize(), Eq(4 + itemsSize + 4));
+
+  Table<ItemsMap> res{};
+  ctx.createDeserializer().object(res);
+  EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+  EXPECT_THAT(res.before, Eq(1u));
+  EXPECT_THAT(res.items, Eq(data.items));
+  EXPECT_THAT(res.after, Eq(2u));
+}
+
+TEST(SerializeExtensionIndexedMap, UnorderedMapIsWrittenSorted)
+{
+  for (auto layout : { MapKeyLayout::Sorted, MapKeyLayout::Eytzinger }) {
+    SerializationContext ctx{};
+    auto items = createItems(50);
+    Table<eastl::unordered_map<uint32_t, Item>> data{
+      1, { items.begin(), items.end() }, 2, layout
+    };
+    ctx.createSerializer().object(data);
+
+    Table<ItemsMap> res{};
+    ctx.createDeserializer().object(res);
+    EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+    EXPECT_THAT(res.items, Eq(items));
+
+    bitsery::Deserializer<Reader> des{ ctx.buf.begin(), ctx.getBufferSize() };
+    Table<ItemsView> view{};
+    des.object(view);
+    EXPECT_TRUE(des.adapter().isCompletedSuccessfully());
+    EXPECT_THAT(view.items.layout(), Eq(layout));
+    if (layout == MapKeyLayout::Sorted) {
+      for (size_t i = 0; i + 1 < view.items.size(); ++i)
+        EXPECT_TRUE(view.items.key(i) < view.items.key(i + 1));
+    }
+  }
+}
+
+TEST(SerializeExtensionIndexedMap, LazyViewFindsKeysInBothLayouts)
+{
+  for (auto layout : { MapKeyLayout::Sorted, MapKeyLayout::Eytzinger }) {
+    // every tree shape, including incomplete last level
+    for (size_t count = 0; count < 40; ++count) {
+      SerializationContext ctx{};
+      Table<ItemsMap> data{ 1, createItems(count), 2, layout };
+      ctx.createSerializer().object(data);
+
+      Table<ItemsView> view{};
+      ctx.createDeserializer().object(view);
+      EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+      EXPECT_THAT(view.after, Eq(2u));
+      EXPECT_THAT(view.items.size(), Eq(count));
+      for (auto& entry : data.items) {
+        const auto index = view.items.find(entry.first);
+        ASSERT_THAT(index, testing::Ne(ItemsView::npos));
+        EXPECT_THAT(view.items.key(index), Eq(entry.first));
+        Item item{};
+        EXPECT_TRUE(view.items.get(entry.first, item));
+        EXPECT_THAT(item, Eq(entry.second));
+        // keys are i * 3 + 1, so neighbours are missing
+        EXPECT_FALSE(view.items.contains(entry.first - 1));
+        EXPECT_FALSE(view.items.contains(entry.first + 1));
+      }
+      EXPECT_FALSE(view.items.contains(0u));
+      EXPECT_FALSE(view.items.contains(static_cast<uint32_t>(count * 3 + 1)));
+      Item item{};
+      EXPECT_FALSE(view.items.get(0u, item));
+    }
+  }
+}
+
+TEST(SerializeExtensionIndexedMap, StringKeys)
+{
+  eastl::unordered_map<eastl::string, uint32_t> data{
+    { "", 1 }, { "ab", 2 }, { "abc", 3 }, { "b", 4 }, { "aa", 5 }
+  };
+  for (auto layout : { MapKeyLayout::Sorted, MapKeyLayout::Eytzinger }) {
+    SerializationContext ctx{};
+    ctx.createSerializer().ext4b(data, IndexedMap{ 10, layout });
+
+    eastl::map<eastl::string, uint32_t> res{};
+    ctx.createDeserializer().ext4b(res, IndexedMap{ 10 });
+    EXPECT_TRUE(ctx.des->adapter().isCompletedSuccessfully());
+    EXPECT_THAT(res.size(), Eq(data.size()));
+    for (auto& entry : data)
+      EXPECT_THAT(res[entry.first], Eq(entry.second));
+
+    bitsery::Deserializer<Reader> des{ ctx.buf.begin(), ctx.getBufferSize() };
+    LazyMapView<eastl::string, uint32_t> view{};
+    des.ext(view, IndexedMap{ 10 });
+    EXPECT_TRUE(des.adapter().isCompletedSuccessfully());
+    for (auto& entry : data) {
+      const auto index = view.find(entry.first);
+      ASSERT_THAT(index, testing::Ne(view.npos));
+      EXPECT_THAT(view.key(index), Eq(entry.first));
+      uint32_t value{};
+      EXPECT_TRUE(
+        view.value(index, value, [](auto& s, uint32_t& v) { s.value4b(v); })
+          .second);
+      EXPECT_THAT(value, Eq(entry.second));
+    }
+    for (const char* missing : { "a", "abcd", "ba", "c" })
+      EXPECT_FALSE(view.contains(eastl::string{ missing }));
+  }
+}
+
+TEST(SerializeExtensionIndexedMap, LambdaOverloadAndEmptyMap)
+{
+  SerializationContext ctx{};
+  eastl::map<int16_t, eastl::vector<uint8_t>> lists{ { -5, { 1 } },
+                                                     { 0, {} },
+                                                     { 7, { 2, 3, 4 } } };
+  eastl::map<int16_t, eastl::vector<uint8_t>> empty{};
+  auto fnc = [](auto& s, eastl::vector<uint8_t>& v) { s.container1b(v, 10); };
+  auto& ser = ctx.createSerializer();
+  ser.ext(lists, IndexedMap{ 10, MapKeyLayout::Eytzinger }, fnc);
+  ser.ext(empty, IndexedMap{ 10 }, fnc);
+
+  decltype(lists) listsRes{};
+  decltype(empty) emptyRes{ { 1, {} } };
+  auto& des = ctx.createDeserializer();
+  des.ext(listsRes, IndexedMap{ 10 }, fnc);
+  des.ext(emptyRes, IndexedMap{ 10 }, fnc);
+  EXPECT_TRUE(des.adapter().isCompletedSuccessfully());
+  EXPECT_THAT(listsRes, Eq(lists));
+  EXPECT_TRUE(emptyRes.empty());
+
+  bitsery::Deserializer<Reader> des2{ ctx.buf.begin(), ctx.getBufferSize() };
+  LazyMapView<int16_t, eastl::vector<uint8_t>> listsView{};
+  LazyMapView<int16_t, eastl::vector<uint8_t>> emptyView{};
+  des2.ext(listsView, IndexedMap{ 10 });
+  des2.ext(emptyView, IndexedMap{ 10 });
+  EXPECT_TRUE(des2.adapter().isCompletedSuccessfully());
+  eastl::vector<uint8_t> list{};
+  EXPECT_TRUE(listsView.value(listsView.find(int16_t{ -5 }), list, fnc).second);
+  EXPECT_THAT(list, Eq(lists[-5]));
+  EXPECT_TRUE(emptyView.empty());
+  EXPECT_FALSE(emptyView.contains(int16_t{ 0 }));
+}
+
+TEST(SerializeExtensionIndexedMap, InvalidDataSetsError)
+{
+  SerializationContext ctx{};
+  Table<ItemsMap> data{ 1, createItems(3), 2 };
+  ctx.createSerializer().object(data);
+  // layout is after `before` and size, keys follow it
+  const size_t layout = 5;
+  const size_t keys = 6;
+  const size_t table = keys + 3 * 4;
+
+  auto badLayout = ctx.buf;
+  badLayout[layout] = 2;
+  {
+    Table<ItemsView> view{};
+    bitsery::Deserializer<Reader> des{ badLayout.begin(), ctx.getBufferSize() };
+    des.object(view);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+  }
+
+  // second key is the same as first
+  auto duplicate = ctx.buf;
+  duplicate[keys + 4] = duplicate[keys];
+  {
+    Table<ItemsMap> res{};
+    bitsery::Deserializer<Reader> des{ duplicate.begin(), ctx.getBufferSize() };
+    des.object(res);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+  }
+
+  // second value ends before the first one
+  auto decreasing = ctx.buf;
+  decreasing[table + 4] = 0;
+  {
+    Table<ItemsView> view{};
+    bitsery::Deserializer<Reader> des{ decreasing.begin(),
+                                       ctx.getBufferSize() };
+    des.object(view);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(view.items.empty());
+  }
+
+  // last value ends after the end of buffer
+  auto overflow = ctx.buf;
+  overflow[table + 8 + 1] = 1;
+  {
+    Table<ItemsView> view{};
+    bitsery::Deserializer<Reader> des{ overflow.begin(), ctx.getBufferSize() };
+    des.object(view);
+    EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::DataOverflow));
+    EXPECT_TRUE(view.items.empty());
+  }
+}
@@ -0,0 +1,383 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/ext/pointer.h>
+#include <bitsery/ext/utils/memory_pools.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::MemResourceBase;
+using bitsery::ext::MemResourceMonotonic;
+using bitsery::ext::MemResourceNewDelete;
+using bitsery::ext::MemResourcePool;
+using bitsery::ext::MemResourceSlab;
+using bitsery::ext::MemResourceThreadLocal;
+using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::PointerOwner;
+
+using testing::Eq;
+
+// counts allocations that reach upstream resource
+struct CountingResource final : MemResourceBase
+{
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    ++allocs;
+    if (typeId)
+      ++objectAllocs;
+    allocatedBytes += bytes;
+    return MemResourceNewDelete{}.allocate(bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    ++deallocs;
+    MemResourceNewDelete{}.deallocate(ptr, bytes, alignment, typeId);
+  }
+
+  size_t allocs{};
+  size_t objectAllocs{};
+  size_t deallocs{};
+  size_t allocatedBytes{};
+};
+
+bool
+isAligned(void* ptr, size_t alignment)
+{
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(MemResourceMonotonic, AllocatesChunksFromUpstreamWithGeometricGrowth)
+{
+  CountingResource upstream{};
+  {
+    MemResourceMonotonic arena{ 256, &upstream };
+    for (size_t i = 0; i < 1000; ++i)
+      arena.allocate(16, 8, 0);
+    EXPECT_THAT(arena.allocatedBytes(), Eq(16000u));
+    EXPECT_THAT(arena.capacity(), Eq(upstream.allocatedBytes));
+    EXPECT_THAT(upstream.allocs, ::testing::Lt(10u));
+  }
+  EXPECT_THAT(upstream.deallocs, Eq(upstream.allocs));
+}
+
+TEST(MemResourceMonotonic, ReleaseRewindsAndReusesChunks)
+{
+  CountingResource upstream{};
+  MemResourceMonotonic arena{ 256, &upstream };
+  void* first = arena.allocate(100, 8, 0);
+  for (size_t i = 0; i < 100; ++i)
+    arena.allocate(64, 8, 0);
+  const auto allocs = upstream.allocs;
+  const auto capacity = arena.capacity();
+
+  for (size_t frame = 0; frame < 10; ++frame) {
+    arena.release();
+    EXPECT_THAT(arena.allocatedBytes(), Eq(0u));
+    EXPECT_THAT(arena.allocate(100, 8, 0), Eq(first));
+    for (size_t i = 0; i < 100; ++i)
+      arena.allocate(64, 8, 0);
+  }
+  EXPECT_THAT(upstream.allocs, Eq(allocs));
+  EXPECT_THAT(arena.capacity(), Eq(capacity));
+
+  arena.releaseChunks();
+  EXPECT_THAT(arena.capacity(), Eq(0u));
+  EXPECT_THAT(upstream.deallocs, Eq(upstream.allocs));
+}
+
+TEST(MemResourceMonotonic, RespectsAlignment)
+{
+  MemResourceMonotonic arena{};
+  arena.allocate(1, 1, 0);
+  EXPECT_TRUE(isAligned(arena.allocate(8, 8, 0), 8));
+  arena.allocate(3, 1, 0);
+  EXPECT_TRUE(isAligned(arena.allocate(64, 64, 0), 64));
+  // larger than chunk
+  EXPECT_TRUE(isAligned(arena.allocate(10000, 16, 0), 16));
+}
+
+TEST(MemResourceMonotonic, UsesProvidedBufferFirst)
+{
+  CountingResource upstream{};
+  alignas(16) uint8_t buffer[256];
+  MemResourceMonotonic arena{ buffer, sizeof(buffer), &upstream };
+  auto ptr = static_cast<uint8_t*>(arena.allocate(200, 8, 0));
+  EXPECT_TRUE(ptr >= buffer && ptr + 200 <= buffer + sizeof(buffer));
+  EXPECT_THAT(upstream.allocs, Eq(0u));
+  arena.allocate(200, 8, 0);
+  EXPECT_THAT(upstream.allocs, Eq(1u));
+  arena.release();
+  EXPECT_THAT(arena.allocate(200, 8, 0), Eq(static_cast<void*>(ptr)));
+}
+
+TEST(MemResourcePool, RecyclesBlocksOfSameSizeClass)
+{
+  CountingResource upstream{};
+  MemResourcePool pool{ &upstream };
+  auto p1 = pool.allocate(24, 8, 0);
+  auto p2 = pool.allocate(32, 8, 0);
+  EXPECT_THAT(p1, ::testing::Ne(p2));
+  pool.deallocate(p1, 24, 8, 0);
+  EXPECT_THAT(pool.allocate(20, 4, 0), Eq(p1));
+  EXPECT_THAT(upstream.allocs, Eq(1u));
+  pool.deallocate(p2, 32, 8, 0);
+  pool.deallocate(p1, 20, 4, 0);
+}
+
+TEST(MemResourcePool, SizeClassesDontOverlap)
+{
+  MemResourcePool pool{};
+  eastl::vector<eastl::pair<uint8_t*, size_t>> blocks{};
+  for (size_t size = 1; size <= MemResourcePool::MaxBlockSize; size += 7) {
+    auto ptr = static_cast<uint8_t*>(pool.allocate(size, 1, 0));
+    memset(ptr, static_cast<int>(size), size);
+    blocks.emplace_back(ptr, size);
+  }
+  for (auto& b : blocks) {
+    for (size_t i = 0; i < b.second; ++i)
+      EXPECT_THAT(b.first[i], Eq(static_cast<uint8_t>(b.second)));
+    pool.deallocate(b.first, b.second, 1, 0);
+  }
+}
+
+TEST(MemResourcePool, LargeAndOverAlignedAllocationsGoToUpstream)
+{
+  CountingResource upstream{};
+  MemResourcePool pool{ &upstream };
+  auto large = pool.allocate(MemResourcePool::MaxBlockSize + 1, 8, 0);
+  EXPECT_THAT(upstream.allocs, Eq(1u));
+  pool.deallocate(large, MemResourcePool::MaxBlockSize + 1, 8, 0);
+  EXPECT_THAT(upstream.deallocs, Eq(1u));
+
+  auto small = pool.allocate(64, 8, 0);
+  EXPECT_THAT(upstream.allocs, Eq(2u));
+  pool.deallocate(small, 64, 8, 0);
+  pool.release();
+  EXPECT_THAT(upstream.deallocs, Eq(2u));
+}
+
+TEST(MemResourceThreadLocal, EachThreadHasItsOwnResource)
+{
+  MemResourceThreadLocal<MemResourcePool> res{};
+  auto main = &MemResourceThreadLocal<MemResourcePool>::local();
+  MemResourcePool* other = nullptr;
+  std::thread t{ [&other, &res]() {
+    other = &MemResourceThreadLocal<MemResourcePool>::local();
+    auto ptr = res.allocate(16, 8, 0);
+    res.deallocate(ptr, 16, 8, 0);
+  } };
+  t.join();
+  EXPECT_THAT(other, ::testing::Ne(main));
+  auto ptr = res.allocate(16, 8, 0);
+  res.deallocate(ptr, 16, 8, 0);
+}
+
+struct Node
+{
+  uint32_t value{};
+  Node* next{};
+};
+
+template<typename S>
+void
+serialize(S& s, Node& o)
+{
+  s.value4b(o.value);
+  s.ext(o.next, PointerOwner{});
+}
+
+TEST(MemResourceMonotonic, CanBeUsedForPointerDeserializationFrames)
+{
+  Node n3{ 3, nullptr };
+  Node n2{ 2, &n3 };
+  Node n1{ 1, &n2 };
+
+  MemResourceMonotonic arena{};
+  size_t capacity = 0;
+  for (size_t frame = 0; frame < 3; ++frame) {
+    PointerLinkingContext plctx{ &arena };
+    BasicSerializationContext<PointerLinkingContext> sctx{};
+    sctx.createSerializer(plctx).object(n1);
+    Node res{};
+    sctx.createDeserializer(plctx).object(res);
+    EXPECT_TRUE(plctx.isValid());
+    EXPECT_THAT(res.next->value, Eq(2u));
+    EXPECT_THAT(res.next->next->value, Eq(3u));
+    EXPECT_THAT(res.next->next->next, ::testing::IsNull());
+    EXPECT_THAT(arena.allocatedBytes(), ::testing::Gt(2 * sizeof(Node)));
+    // nodes are trivially destructible, drop whole frame at once
+    arena.release();
+    if (frame == 0)
+      capacity = arena.capacity();
+    EXPECT_THAT(arena.capacity(), Eq(capacity));
+  }
+}
+
+TEST(MemResourceSlab, RecyclesObjectsOfSameTypeAndReportsStats)
+{
+  MemResourceSlab slab{};
+  auto p1 = slab.allocate(24, 8, 42);
+  auto p2 = slab.allocate(24, 8, 42);
+  auto other = slab.allocate(24, 8, 7);
+  EXPECT_THAT(static_cast<uint8_t*>(p2) - static_cast<uint8_t*>(p1), Eq(24));
+  slab.deallocate(p1, 24, 8, 42);
+  EXPECT_THAT(slab.allocate(24, 8, 42), Eq(p1));
+
+  auto stats = slab.stats(42);
+  ASSERT_THAT(stats, ::testing::NotNull());
+  EXPECT_THAT(stats->objectSize, Eq(24u));
+  EXPECT_THAT(stats->liveObjects, Eq(2u));
+  EXPECT_THAT(stats->peakObjects, Eq(2u));
+  EXPECT_THAT(stats->allocations, Eq(3u));
+  EXPECT_THAT(stats->slabs, Eq(1u));
+  EXPECT_THAT(slab.stats(1), ::testing::IsNull());
+
+  size_t types = 0;
+  slab.forEachStats([&types](const bitsery::ext::SlabTypeStats&) { ++types; });
+  EXPECT_THAT(types, Eq(2u));
+  slab.deallocate(p1, 24, 8, 42);
+  slab.deallocate(p2, 24, 8, 42);
+  slab.deallocate(other, 24, 8, 7);
+  EXPECT_THAT(slab.stats(42)->liveObjects, Eq(0u));
+}
+
+TEST(MemResourceSlab, InternalAndArrayAllocationsGoToUpstream)
+{
+  CountingResource upstream{};
+  MemResourceSlab slab{ &upstream };
+  auto internal = slab.allocate(24, 8, 0);
+  EXPECT_THAT(upstream.allocs, Eq(1u));
+  auto obj = slab.allocate(24, 8, 42);
+  const auto allocs = upstream.allocs;
+  auto array = slab.allocate(48, 8, 42);
+  EXPECT_THAT(upstream.allocs, Eq(allocs + 1));
+  slab.deallocate(array, 48, 8, 42);
+  slab.deallocate(obj, 24, 8, 42);
+  slab.deallocate(internal, 24, 8, 0);
+  EXPECT_THAT(slab.stats(42)->allocations, Eq(1u));
+}
+
+TEST(MemResourceSlab, ManyTypesAndSlabs)
+{
+  CountingResource upstream{};
+  {
+    MemResourceSlab slab{ &upstream };
+    eastl::vector<eastl::pair<void*, size_t>> objects{};
+    for (size_t i = 0; i < 10000; ++i) {
+      auto typeId = 1000 + i % 100;
+      auto size = 8 + (typeId % 5) * 8;
+      objects.emplace_back(slab.allocate(size, 8, typeId), typeId);
+    }
+    EXPECT_THAT(slab.stats(1000)->liveObjects, Eq(100u));
+    EXPECT_THAT(slab.stats(1099)->capacity, ::testing::Ge(100u));
+    for (auto& o : objects)
+      slab.deallocate(o.first, 8 + (o.second % 5) * 8, 8, o.second);
+    slab.release();
+    EXPECT_THAT(slab.stats(1000)->slabs, Eq(0u));
+  }
+  EXPECT_THAT(upstream.deallocs, Eq(upstream.allocs));
+}
+
+struct Item
+{
+  uint32_t value{};
+};
+
+template<typename S>
+void
+serialize(S& s, Item& o)
+{
+  s.value4b(o.value);
+}
+
+struct Holder
+{
+  Item* a{};
+  Item* b{};
+};
+
+template<typename S>
+void
+serialize(S& s, Holder& o)
+{
+  s.ext(o.a, PointerOwner{});
+  s.ext(o.b, PointerOwner{});
+}
+
+TEST(MemResourceSlab, ObjectChurnThroughPointerOwnerDoesntReachUpstream)
+{
+  CountingResource upstream{};
+  MemResourceSlab slab{ &upstream };
+  Item i1{ 1 };
+  Item i2{ 2 };
+  Holder full{ &i1, &i2 };
+  Holder empty{};
+  Holder res{};
+  for (size_t frame = 0; frame < 100; ++frame) {
+    PointerLinkingContext plctx{ &slab };
+    BasicSerializationContext<PointerLinkingContext> sctx{};
+    sctx.createSerializer(plctx).object(frame % 2 ? empty : full);
+    sctx.createDeserializer(plctx).object(res);
+    EXPECT_TRUE(plctx.isValid());
+    if (frame % 2 == 0)
+      EXPECT_THAT(res.b->value, Eq(2u));
+    else
+      EXPECT_THAT(res.a, ::testing::IsNull());
+  }
+  // pointer linking context internals are allocated from upstream
+  EXPECT_THAT(upstream.objectAllocs, Eq(0u));
+  auto stats = slab.stats(bitsery::ext::DefaultRTTI::get<Item>());
+  ASSERT_THAT(stats, ::testing::NotNull());
+  EXPECT_THAT(stats->allocations, Eq(100u));
+  EXPECT_THAT(stats->liveObjects, Eq(0u));
+  EXPECT_THAT(stats->slabs, Eq(1u));
+}
@@ -0,0 +1,252 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/parallel_container.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <atomic>
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::ParallelContainer;
+using bitsery::ext::SequentialExecutor;
+using bitsery::ext::ThreadPoolExecutor;
+
+using testing::Eq;
+
+struct Entity
+{
+  uint32_t id{};
+  eastl::string name{};
+  eastl::vector<float> values{};
+
+  bool operator==(const Entity& other) const
+  {
+    return id == other.id && name == other.name && values == other.values;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Entity& o)
+{
+  s.value4b(o.id);
+  s.text1b(o.name, 100);
+  s.container4b(o.values, 100);
+}
+
+eastl::vector<Entity>
+createEntities(size_t count)
+{
+  eastl::vector<Entity> res(count);
+  for (size_t i = 0; i < count; ++i) {
+    res[i].id = static_cast<uint32_t>(i);
+    // different sizes, so that chunks have different sizes too
+    res[i].name = eastl::string(i % 37, 'a');
+    res[i].values.resize(i % 5, static_cast<float>(i));
+  }
+  return res;
+}
+
+TEST(ThreadPoolExecutor, RunsEachTaskOnce)
+{
+  ThreadPoolExecutor pool{ 4 };
+  EXPECT_THAT(pool.concurrency(), Eq(4u));
+  for (size_t count : { 0u, 1u, 3u, 1000u }) {
+    eastl::vector<std::atomic<int>> calls(count);
+    auto task = [&calls](size_t i) { ++calls[i]; };
+    pool.parallelFor(count, task);
+    for (auto& c : calls)
+      EXPECT_THAT(c.load(), Eq(1));
+  }
+}
+
+TEST(ThreadPoolExecutor, NestedCallsRunSequentially)
+{
+  ThreadPoolExecutor pool{ 3 };
+  std::atomic<size_t> total{};
+  auto outer = [&](size_t) {
+    auto inner = [&](size_t) { ++total; };
+    pool.parallelFor(10, inner);
+  };
+  pool.parallelFor(10, outer);
+  EXPECT_THAT(total.load(), Eq(100u));
+}
+
+TEST(SerializeExtensionParallelContainer, RoundTripObjects)
+{
+  ThreadPoolExecutor pool{ 4 };
+  auto data = createEntities(10000);
+  SerializationContext ctx{};
+  ctx.createSerializer().ext(data, ParallelContainer{ pool, 20000, 100 });
+  eastl::vector<Entity> res{ Entity{ 1, "old", {} } };
+  auto& des = ctx.createDeserializer();
+  des.ext(res, ParallelContainer{ pool, 20000, 100 });
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(des.adapter().isCompletedSuccessfully());
+  EXPECT_TRUE(res == data);
+}
+
+TEST(SerializeExtensionParallelContainer, SameOutputForAnyExecutor)
+{
+  ThreadPoolExecutor pool{ 8 };
+  SequentialExecutor sequential{};
+  eastl::vector<uint32_t> data(5000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<uint32_t>(i * i);
+
+  SerializationContext ctx1{};
+  ctx1.createSerializer().ext4b(data, ParallelContainer{ pool, 5000, 64 });
+  SerializationContext ctx2{};
+  ctx2.createSerializer().ext4b(data,
+                                ParallelContainer{ sequential, 5000, 64 });
+  ctx1.createDeserializer();
+  ctx2.createDeserializer();
+  EXPECT_THAT(ctx1.getBufferSize(), Eq(ctx2.getBufferSize()));
+  EXPECT_TRUE(eastl::equal(ctx1.buf.begin(),
+                           ctx1.buf.begin() +
+                             static_cast<ptrdiff_t>(ctx1.getBufferSize()),
+                           ctx2.buf.begin()));
+  // header: size, chunk size, chunk sizes table
+  EXPECT_THAT(ctx1.getBufferSize(), Eq(2u + 1u + 79u * 8u + 5000u * 4u));
+
+  eastl::vector<uint32_t> res{};
+  ctx1.createDeserializer().ext4b(res, ParallelContainer{ pool, 5000 });
+  EXPECT_THAT(res, Eq(data));
+}
+
+TEST(SerializeExtensionParallelContainer, EmptyAndSmallerThanChunk)
+{
+  ThreadPoolExecutor pool{ 2 };
+  eastl::vector<uint8_t> empty{};
+  eastl::vector<uint8_t> small{ 1, 2, 3 };
+  SerializationContext ctx{};
+  auto& ser = ctx.createSerializer();
+  ser.ext1b(empty, ParallelContainer{ pool, 10 });
+  ser.ext1b(small, ParallelContainer{ pool, 10 });
+  eastl::vector<uint8_t> res1{ 5 };
+  eastl::vector<uint8_t> res2{};
+  auto& des = ctx.createDeserializer();
+  des.ext1b(res1, ParallelContainer{ pool, 10 });
+  des.ext1b(res2, ParallelContainer{ pool, 10 });
+  EXPECT_TRUE(res1.empty());
+  EXPECT_THAT(res2, Eq(small));
+  EXPECT_TRUE(des.adapter().isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionParallelContainer, TupleContextIsSharedWithChunks)
+{
+  using Context = eastl::tuple<int, float>;
+  BasicSerializationContext<Context> ctx{};
+  Context serCtx{ 5, 1.0f };
+  ThreadPoolExecutor pool{ 4 };
+  eastl::vector<uint32_t> data(1000, 1);
+  ctx.createSerializer(serCtx).ext(
+    data, ParallelContainer{ pool, 1000, 10 }, [](auto& s, uint32_t& v) {
+      uint32_t tmp = v + static_cast<uint32_t>(s.template context<int>());
+      s.value4b(tmp);
+    });
+  Context desCtx{ 2, 1.0f };
+  eastl::vector<uint32_t> res{};
+  ctx.createDeserializer(desCtx).ext(
+    res, ParallelContainer{ pool, 1000, 10 }, [](auto& s, uint32_t& v) {
+      s.value4b(v);
+      v -= static_cast<uint32_t>(s.template context<int>());
+    });
+  EXPECT_THAT(res, Eq(eastl::vector<uint32_t>(1000, 4)));
+}
+
+TEST(SerializeExtensionParallelContainer, AllocationBudgetIsSlicedForChunks)
+{
+  ThreadPoolExecutor pool{ 4 };
+  auto data = createEntities(1000);
+  BasicSerializationContext<bitsery::AllocationBudget> ctx{};
+  bitsery::AllocationBudget serBudget{ 0 };
+  ctx.createSerializer(serBudget).ext(data, ParallelContainer{ pool, 1000, 50 });
+
+  // entities, names and values are charged to the same budget
+  bitsery::AllocationBudget budget{ 1000000 };
+  eastl::vector<Entity> res{};
+  auto& des = ctx.createDeserializer(budget);
+  des.ext(res, ParallelContainer{ pool, 1000, 50 });
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(res == data);
+  EXPECT_THAT(budget.usedBytes(),
+              ::testing::Gt(sizeof(Entity) * data.size()));
+
+  // enough for entities, but not for their content
+  bitsery::AllocationBudget small{ sizeof(Entity) * data.size() + 100 };
+  eastl::vector<Entity> res2{};
+  BasicSerializationContext<bitsery::AllocationBudget>::TDeserializer des2{
+    small, ctx.buf.begin(), ctx.getBufferSize()
+  };
+  des2.ext(res2, ParallelContainer{ pool, 1000, 50 });
+  EXPECT_THAT(des2.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionParallelContainer, InvalidChunkSizesSetError)
+{
+  ThreadPoolExecutor pool{ 2 };
+  eastl::vector<uint32_t> data(100, 7);
+  SerializationContext ctx{};
+  ctx.createSerializer().ext4b(data, ParallelContainer{ pool, 100, 10 });
+  ctx.createDeserializer();
+  // chunk table starts right after size and chunk size, move four bytes from
+  // the second chunk to the first, so total size still matches
+  auto corrupted = ctx.buf;
+  corrupted[2] = 44;
+  corrupted[10] = 36;
+  eastl::vector<uint32_t> res{};
+  bitsery::Deserializer<Reader> des{ corrupted.begin(), ctx.getBufferSize() };
+  des.ext4b(res, ParallelContainer{ pool, 100 });
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidData));
+
+  corrupted = ctx.buf;
+  corrupted[3] = 0x7F;
+  bitsery::Deserializer<Reader> des2{ corrupted.begin(),
+                                      ctx.getBufferSize() };
+  des2.ext4b(res, ParallelContainer{ pool, 100 });
+  EXPECT_THAT(des2.adapter().error(), Eq(bitsery::ReaderError::DataOverflow));
+}
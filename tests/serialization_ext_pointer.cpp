@@ -47,10 +47,12 @@ void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, cons
 }
 
 using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::DensePointerLinkingContext;
 using bitsery::ext::PointerObserver;
 using bitsery::ext::PointerOwner;
 using bitsery::ext::PointerType;
 using bitsery::ext::ReferencedByPointer;
+using bitsery::ext::UntrackedPointerOwner;
 
 using testing::Eq;
 
@@ -558,6 +560,243 @@ TEST(SerializeExtensionPointer, IntegrationTest)
   delete res.pi1;
 }
 
+TEST(SerializeExtensionPointer, IntegrationTestWithDensePointerLinkingContext)
+{
+  Test1Data data{};
+  data.vdata.push_back({ 165, -45 });
+  data.vdata.push_back({ 7895, -1576 });
+  data.vdata.push_back({ 5987, -798 });
+  // observers are serialized before owner
+  data.vptr.push_back(eastl::addressof(data.vdata[2]));
+  data.vptr.push_back(nullptr);
+  data.vptr.push_back(eastl::addressof(data.vdata[2]));
+  data.o1 = MyStruct1{ 145, 948 };
+  data.i1 = 945415;
+  data.po1 = eastl::addressof(data.vdata[1]);
+  data.pi1 = new int32_t{ 5 };
+
+  Test1Data res{};
+
+  DensePointerLinkingContext plctx1{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx1;
+  sctx1.createSerializer(plctx1).object(data);
+  sctx1.createDeserializer(plctx1).object(res);
+
+  EXPECT_THAT(plctx1.isValid(), Eq(true));
+  EXPECT_THAT(res.i1, Eq(data.i1));
+  EXPECT_THAT(res.vdata, ::testing::ContainerEq(data.vdata));
+  EXPECT_THAT(*res.pi1, Eq(*data.pi1));
+  EXPECT_THAT(res.po1, Eq(eastl::addressof(res.vdata[1])));
+  EXPECT_THAT(res.vptr[0], Eq(eastl::addressof(res.vdata[2])));
+  EXPECT_THAT(res.vptr[1], ::testing::IsNull());
+  EXPECT_THAT(res.vptr[2], Eq(eastl::addressof(res.vdata[2])));
+
+  // context can be reused after clear
+  plctx1.clear();
+  Test1Data res2{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx2;
+  sctx2.buf = sctx1.buf;
+  sctx2.des = eastl::unique_ptr<decltype(sctx2)::TDeserializer>(
+    new decltype(sctx2)::TDeserializer{ plctx1,
+                                        sctx2.buf.begin(),
+                                        sctx1.getBufferSize() });
+  sctx2.des->object(res2);
+  EXPECT_THAT(res2.vptr[0], Eq(eastl::addressof(res2.vdata[2])));
+  EXPECT_THAT(res2.po1, Eq(eastl::addressof(res2.vdata[1])));
+
+  delete data.pi1;
+  delete res.pi1;
+  delete res2.pi1;
+}
+
+struct ListNode
+{
+  uint32_t value{};
+  ListNode* next{};
+  // points to the first node of the list
+  ListNode* head{};
+};
+
+template<typename S>
+void
+serialize(S& s, ListNode& o)
+{
+  s.value4b(o.value);
+  s.ext(o.next, PointerOwner{});
+  s.ext(o.head, PointerObserver{});
+}
+
+TEST(SerializeExtensionPointer, DensePointerLinkingContextWithNestedOwners)
+{
+  // every node is created while its parent info is in use, and list is longer
+  // than single block of infos
+  const uint32_t count = 1000;
+  ListNode data{};
+  auto last = &data;
+  for (uint32_t i = 1; i < count; ++i) {
+    last->next = new ListNode{};
+    last = last->next;
+    last->value = i;
+  }
+  for (auto node = data.next; node; node = node->next)
+    node->head = data.next;
+
+  ListNode res{};
+  DensePointerLinkingContext plctx1{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx1;
+  sctx1.createSerializer(plctx1).ext(data.next, PointerOwner{});
+  sctx1.createDeserializer(plctx1).ext(res.next, PointerOwner{});
+  EXPECT_THAT(plctx1.isValid(), Eq(true));
+
+  uint32_t expected = 1;
+  for (auto node = res.next; node; node = node->next) {
+    EXPECT_THAT(node->value, Eq(expected++));
+    EXPECT_THAT(node->head, Eq(res.next));
+  }
+  EXPECT_THAT(expected, Eq(count));
+
+  for (auto list : { data.next, res.next }) {
+    while (list) {
+      auto next = list->next;
+      delete list;
+      list = next;
+    }
+  }
+}
+
+struct CountingResource final : bitsery::ext::MemResourceBase
+{
+  void* allocate(size_t bytes, size_t alignment, size_t typeId) final
+  {
+    ++allocs;
+    return bitsery::ext::MemResourceNewDelete{}.allocate(
+      bytes, alignment, typeId);
+  }
+
+  void deallocate(void* ptr,
+                  size_t bytes,
+                  size_t alignment,
+                  size_t typeId) noexcept final
+  {
+    ++deallocs;
+    bitsery::ext::MemResourceNewDelete{}.deallocate(
+      ptr, bytes, alignment, typeId);
+  }
+
+  size_t allocs{};
+  size_t deallocs{};
+};
+
+TEST(SerializeExtensionPointer,
+     DensePointerLinkingContextDoesNotAllocateInfosFromPropagatedResource)
+{
+  const uint32_t count = 600;
+  ListNode data{};
+  auto last = &data;
+  for (uint32_t i = 1; i < count; ++i) {
+    last->next = new ListNode{};
+    last = last->next;
+    last->value = i;
+  }
+
+  CountingResource resource{};
+  ListNode res{};
+  DensePointerLinkingContext plctx1{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx1;
+  sctx1.createSerializer(plctx1).ext(data.next, PointerOwner{});
+  sctx1.createDeserializer(plctx1).ext(
+    res.next, PointerOwner{ PointerType::Nullable, &resource, true });
+  EXPECT_THAT(plctx1.isValid(), Eq(true));
+  // only nodes are allocated from propagated resource
+  EXPECT_THAT(resource.allocs, Eq(count - 1));
+
+  for (auto list : { data.next, res.next }) {
+    while (list) {
+      auto next = list->next;
+      delete list;
+      list = next;
+    }
+  }
+}
+
+TEST(SerializeExtensionPointer,
+     WhenDensePointerLinkingContextReadsNonSequentialIdThenInvalidPointer)
+{
+  int32_t* res = nullptr;
+  DensePointerLinkingContext plctx1{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx1;
+  sctx1.createSerializer(plctx1);
+  bitsery::details::writeSize(sctx1.ser->adapter(), 2u);
+  auto& des = sctx1.createDeserializer(plctx1);
+  des.ext4b(res, PointerOwner{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+  EXPECT_THAT(res, ::testing::IsNull());
+}
+
+TEST(SerializeExtensionPointer,
+     DenseSerializationContextAssignsSequentialIdsAndGrows)
+{
+  using bitsery::ext::PointerOwnershipType;
+  bitsery::ext::pointer_utils::PointerLinkingContextSerializationDense ctx{};
+  eastl::vector<int32_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto& info = ctx.getInfoByPtr(eastl::addressof(data[i]),
+                                  PointerOwnershipType::Observer);
+    EXPECT_THAT(info.id, Eq(i + 1));
+  }
+  EXPECT_THAT(ctx.isPointerSerializationValid(), Eq(false));
+  // same pointer gets same id
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto& info = ctx.getInfoByPtr(eastl::addressof(data[i]),
+                                  PointerOwnershipType::Owner);
+    EXPECT_THAT(info.id, Eq(i + 1));
+  }
+  EXPECT_THAT(ctx.isPointerSerializationValid(), Eq(true));
+
+  // after clear ids start from beginning
+  ctx.clear();
+  EXPECT_THAT(ctx.getInfoByPtr(eastl::addressof(data[500]),
+                               PointerOwnershipType::Observer)
+                .id,
+              Eq(1u));
+  EXPECT_THAT(ctx.getInfoByPtr(eastl::addressof(data[0]),
+                               PointerOwnershipType::Observer)
+                .id,
+              Eq(2u));
+  EXPECT_THAT(ctx.isPointerSerializationValid(), Eq(false));
+}
+
+TEST(SerializeExtensionPointer,
+     DensePointerLinkingContextCanBeClearedForNextSerialization)
+{
+  MyStruct1 d1{ 1, 2 };
+  MyStruct1 d2{ 3, 4 };
+  MyStruct1* pd2 = &d2;
+  MyStruct1 r{};
+  MyStruct1* pr = nullptr;
+
+  DensePointerLinkingContext plctx1{};
+  BasicSerializationContext<DensePointerLinkingContext> sctx1;
+  auto& ser1 = sctx1.createSerializer(plctx1);
+  ser1.ext(d1, ReferencedByPointer{});
+  ser1.ext(d2, ReferencedByPointer{});
+  plctx1.clear();
+
+  // after clear d2 gets id 1, otherwise deserialization would fail
+  BasicSerializationContext<DensePointerLinkingContext> sctx2;
+  auto& ser2 = sctx2.createSerializer(plctx1);
+  ser2.ext(d2, ReferencedByPointer{});
+  ser2.ext(pd2, PointerObserver{});
+  EXPECT_THAT(plctx1.isValid(), Eq(true));
+  auto& des = sctx2.createDeserializer(plctx1);
+  des.ext(r, ReferencedByPointer{});
+  des.ext(pr, PointerObserver{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(plctx1.isValid(), Eq(true));
+  EXPECT_THAT(r, Eq(d2));
+  EXPECT_THAT(pr, Eq(&r));
+}
+
 TEST(SerializeExtensionPointer,
      PointerOwnerWithNonPolymorphicTypeCanUseLambdaOverload)
 {
@@ -638,3 +877,75 @@ TEST(SerializeExtensionPointer, ReferencedByPointerCanUseValueOverload)
 
   EXPECT_THAT(res, Eq(data));
 }
+
+struct RawTreeNode
+{
+  int32_t value{};
+  RawTreeNode* left{};
+  RawTreeNode* right{};
+
+  ~RawTreeNode()
+  {
+    delete left;
+    delete right;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, RawTreeNode& o)
+{
+  s.value4b(o.value);
+  s.ext(o.left, UntrackedPointerOwner{});
+  s.ext(o.right, UntrackedPointerOwner{});
+}
+
+TEST(SerializeExtensionPointer,
+     UntrackedPointerOwnerDoesntRequirePointerLinkingContext)
+{
+  RawTreeNode* data = new RawTreeNode{ 1, nullptr, nullptr };
+  data->left = new RawTreeNode{ 2, nullptr, nullptr };
+  data->right = new RawTreeNode{ 3, nullptr, nullptr };
+  data->right->left = new RawTreeNode{ 4, nullptr, nullptr };
+  RawTreeNode* res = nullptr;
+
+  BasicSerializationContext<void> sctx1;
+  sctx1.createSerializer().ext(data, UntrackedPointerOwner{});
+  auto& des = sctx1.createDeserializer();
+  des.ext(res, UntrackedPointerOwner{});
+
+  // each node is 4 bytes value + 1 byte presence flag for each child
+  EXPECT_THAT(sctx1.getBufferSize(), Eq(1u + 4u * 6u));
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(res->value, Eq(1));
+  EXPECT_THAT(res->left->value, Eq(2));
+  EXPECT_THAT(res->left->left, ::testing::IsNull());
+  EXPECT_THAT(res->right->value, Eq(3));
+  EXPECT_THAT(res->right->left->value, Eq(4));
+  EXPECT_THAT(res->right->right, ::testing::IsNull());
+  delete data;
+  delete res;
+}
+
+TEST(SerializeExtensionPointer,
+     UntrackedPointerOwnerDestroysResultWhenDataIsNull)
+{
+  int32_t* data = nullptr;
+  int32_t* res = new int32_t{ 5 };
+  BasicSerializationContext<void> sctx1;
+  sctx1.createSerializer().ext4b(data, UntrackedPointerOwner{});
+  sctx1.createDeserializer().ext4b(res, UntrackedPointerOwner{});
+  EXPECT_THAT(res, ::testing::IsNull());
+}
+
+TEST(SerializeExtensionPointer,
+     UntrackedPointerOwnerWhenNotNullAndReadsNullThenInvalidPointer)
+{
+  int32_t* data = nullptr;
+  int32_t* res = nullptr;
+  BasicSerializationContext<void> sctx1;
+  sctx1.createSerializer().ext4b(data, UntrackedPointerOwner{});
+  auto& des = sctx1.createDeserializer();
+  des.ext4b(res, UntrackedPointerOwner{ PointerType::NotNull });
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+}
@@ -49,11 +49,13 @@ void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, cons
 }
 
 using bitsery::ext::BaseClass;
+using bitsery::ext::FrozenPolymorphicContext;
 using bitsery::ext::VirtualBaseClass;
 
 using bitsery::ext::InheritanceContext;
 using bitsery::ext::PointerLinkingContext;
 using bitsery::ext::PolymorphicContext;
+using bitsery::ext::StaticPolymorphicContext;
 using bitsery::ext::StandardRTTI;
 
 using bitsery::ext::PointerObserver;
@@ -395,3 +397,261 @@ TEST_F(SerializeExtensionPointerPolymorphicTypes,
   EXPECT_THAT(sctx.des->adapter().error(),
               Eq(bitsery::ReaderError::InvalidPointer));
 }
+
+using TStaticContext = eastl::tuple<PointerLinkingContext,
+                                    InheritanceContext,
+                                    StaticPolymorphicContext<StandardRTTI>>;
+
+class SerializeExtensionPointerStaticPolymorphicContext : public testing::Test
+{
+public:
+  TStaticContext plctx{};
+  BasicSerializationContext<TStaticContext> sctx{};
+
+  bool isPointerContextValid() { return eastl::get<0>(plctx).isValid(); }
+
+  virtual void TearDown() override { EXPECT_TRUE(isPointerContextValid()); }
+};
+
+TEST_F(SerializeExtensionPointerStaticPolymorphicContext,
+       DoesntRequireRegistration)
+{
+  MultipleVirtualInheritance md1{ 3, 78, 14, -33 };
+  Base* baseData = &md1;
+  sctx.createSerializer(plctx).ext(baseData, PointerOwner{});
+  Base* baseRes = nullptr;
+  sctx.createDeserializer(plctx).ext(baseRes, PointerOwner{});
+
+  auto* res = dynamic_cast<MultipleVirtualInheritance*>(baseRes);
+  EXPECT_THAT(res, ::testing::NotNull());
+  EXPECT_THAT(res->x, Eq(md1.x));
+  EXPECT_THAT(res->y1, Eq(md1.y1));
+  EXPECT_THAT(res->y2, Eq(md1.y2));
+  EXPECT_THAT(res->z, Eq(md1.z));
+  delete baseRes;
+}
+
+TEST_F(SerializeExtensionPointerStaticPolymorphicContext,
+       WhenResultIsDifferentTypeThenRecreate)
+{
+  Derived1 d1{};
+  d1.x = 5;
+  d1.y1 = 6;
+  Base* baseData = &d1;
+  sctx.createSerializer(plctx).ext(baseData, PointerOwner{});
+  Base* baseRes = new MultipleVirtualInheritance{};
+  sctx.createDeserializer(plctx).ext(baseRes, PointerOwner{});
+  auto* res = dynamic_cast<Derived1*>(baseRes);
+  EXPECT_THAT(res, ::testing::NotNull());
+  EXPECT_THAT(dynamic_cast<MultipleVirtualInheritance*>(baseRes),
+              ::testing::IsNull());
+  EXPECT_THAT(res->y1, Eq(6));
+  delete baseRes;
+}
+
+TEST_F(SerializeExtensionPointerStaticPolymorphicContext,
+       WhenDataIsNullThenDestroysResult)
+{
+  Base* baseData = nullptr;
+  sctx.createSerializer(plctx).ext(baseData, PointerOwner{});
+  Base* baseRes = new MultipleVirtualInheritance{};
+  sctx.createDeserializer(plctx).ext(baseRes, PointerOwner{});
+  EXPECT_THAT(baseRes, ::testing::IsNull());
+}
+
+TEST_F(SerializeExtensionPointerStaticPolymorphicContext,
+       WritesSameDerivedIndexAsPolymorphicContext)
+{
+  MultipleVirtualInheritance md1{ 3, 78, 14, -33 };
+  Base* baseData = &md1;
+  Derived2* derivedData = &md1;
+
+  TContext ctx{};
+  SerContext runtimeSctx{};
+  auto& ser = runtimeSctx.createSerializer(ctx);
+  eastl::get<2>(ctx).registerBasesList<SerContext::TSerializer>(
+    bitsery::ext::PolymorphicClassesList<Base>{});
+  ser.ext(baseData, PointerOwner{});
+  ser.ext(derivedData, PointerOwner{});
+
+  auto& staticSer = sctx.createSerializer(plctx);
+  staticSer.ext(baseData, PointerOwner{});
+  staticSer.ext(derivedData, PointerOwner{});
+
+  EXPECT_THAT(sctx.getBufferSize(), Eq(runtimeSctx.getBufferSize()));
+  EXPECT_TRUE(eastl::equal(runtimeSctx.buf.begin(),
+                           runtimeSctx.buf.begin() +
+                             static_cast<ptrdiff_t>(sctx.getBufferSize()),
+                           sctx.buf.begin()));
+}
+
+TEST_F(SerializeExtensionPointerStaticPolymorphicContext,
+       WhenDerivedIndexIsOutOfRangeThenInvalidPointerError)
+{
+  auto& ser = sctx.createSerializer(plctx);
+  // pointer id
+  bitsery::details::writeSize(ser.adapter(), 1u);
+  // Base has 4 non abstract types in hierarchy
+  bitsery::details::writeSize(ser.adapter(), 4u);
+  Base* baseRes = nullptr;
+  auto& des = sctx.createDeserializer(plctx);
+  des.ext(baseRes, PointerOwner{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+  EXPECT_THAT(baseRes, ::testing::IsNull());
+  eastl::get<0>(plctx) = PointerLinkingContext{};
+}
+
+// frozen context is shared by reference, each "thread" has its own pointer
+// linking context
+using TFrozenContext = eastl::tuple<PointerLinkingContext,
+                                    InheritanceContext,
+                                    FrozenPolymorphicContext<StandardRTTI>&>;
+using FrozenSerContext = BasicSerializationContext<TFrozenContext>;
+
+class SerializeExtensionPointerFrozenPolymorphicContext : public testing::Test
+{
+public:
+  FrozenPolymorphicContext<StandardRTTI> serPc{};
+  FrozenPolymorphicContext<StandardRTTI> desPc{};
+
+  void SetUp() override
+  {
+    serPc.registerBasesList<FrozenSerContext::TSerializer>(
+      bitsery::ext::PolymorphicClassesList<Base>{});
+    serPc.freeze();
+    desPc.registerBasesList<FrozenSerContext::TDeserializer>(
+      bitsery::ext::PolymorphicClassesList<Base>{});
+    desPc.freeze();
+  }
+};
+
+TEST_F(SerializeExtensionPointerFrozenPolymorphicContext,
+       CanBeSharedBetweenMultipleSerializationContexts)
+{
+  EXPECT_TRUE(serPc.isFrozen());
+  for (int8_t i = 0; i < 3; ++i) {
+    MultipleVirtualInheritance md1{ 3, 78, 14, i };
+    Derived2* data = &md1;
+    Derived2* res = nullptr;
+    TFrozenContext serCtx{ PointerLinkingContext{},
+                          InheritanceContext{},
+                          serPc };
+    TFrozenContext desCtx{ PointerLinkingContext{},
+                          InheritanceContext{},
+                          desPc };
+    FrozenSerContext sctx{};
+    sctx.createSerializer(serCtx).ext(data, PointerOwner{});
+    sctx.createDeserializer(desCtx).ext(res, PointerOwner{});
+
+    auto* typedRes = dynamic_cast<MultipleVirtualInheritance*>(res);
+    EXPECT_THAT(typedRes, ::testing::NotNull());
+    EXPECT_THAT(typedRes->y2, Eq(md1.y2));
+    EXPECT_THAT(typedRes->z, Eq(i));
+    EXPECT_TRUE(eastl::get<0>(serCtx).isValid());
+    EXPECT_TRUE(eastl::get<0>(desCtx).isValid());
+    delete res;
+  }
+}
+
+TEST_F(SerializeExtensionPointerFrozenPolymorphicContext,
+       WritesSameDerivedIndexAsPolymorphicContext)
+{
+  MultipleVirtualInheritance md1{ 3, 78, 14, -33 };
+  Derived1 d1{};
+  Base* baseData = &md1;
+  Base* derived1Data = &d1;
+  Derived2* derivedData = &md1;
+
+  TContext ctx{};
+  SerContext runtimeSctx{};
+  auto& ser = runtimeSctx.createSerializer(ctx);
+  eastl::get<2>(ctx).registerBasesList<SerContext::TSerializer>(
+    bitsery::ext::PolymorphicClassesList<Base>{});
+  ser.ext(baseData, PointerOwner{});
+  ser.ext(derived1Data, PointerOwner{});
+  ser.ext(derivedData, PointerOwner{});
+
+  // duplicate registrations are ignored
+  FrozenPolymorphicContext<StandardRTTI> pc{};
+  pc.registerBasesList<FrozenSerContext::TSerializer>(
+    bitsery::ext::PolymorphicClassesList<Derived2, Base>{});
+  pc.registerBasesList<FrozenSerContext::TSerializer>(
+    bitsery::ext::PolymorphicClassesList<Base>{});
+  pc.freeze();
+  TFrozenContext frozenCtx{ PointerLinkingContext{}, InheritanceContext{}, pc };
+  FrozenSerContext sctx{};
+  auto& frozenSer = sctx.createSerializer(frozenCtx);
+  frozenSer.ext(baseData, PointerOwner{});
+  frozenSer.ext(derived1Data, PointerOwner{});
+  frozenSer.ext(derivedData, PointerOwner{});
+
+  EXPECT_THAT(sctx.getBufferSize(), Eq(runtimeSctx.getBufferSize()));
+  EXPECT_TRUE(eastl::equal(runtimeSctx.buf.begin(),
+                           runtimeSctx.buf.begin() +
+                             static_cast<ptrdiff_t>(sctx.getBufferSize()),
+                           sctx.buf.begin()));
+}
+
+TEST_F(SerializeExtensionPointerFrozenPolymorphicContext,
+       WhenResultIsDifferentTypeThenRecreate)
+{
+  Derived1 d1{};
+  d1.x = 5;
+  d1.y1 = 6;
+  Base* baseData = &d1;
+  TFrozenContext serCtx{ PointerLinkingContext{}, InheritanceContext{}, serPc };
+  TFrozenContext desCtx{ PointerLinkingContext{}, InheritanceContext{}, desPc };
+  FrozenSerContext sctx{};
+  sctx.createSerializer(serCtx).ext(baseData, PointerOwner{});
+  Base* baseRes = new MultipleVirtualInheritance{};
+  sctx.createDeserializer(desCtx).ext(baseRes, PointerOwner{});
+  auto* res = dynamic_cast<Derived1*>(baseRes);
+  EXPECT_THAT(res, ::testing::NotNull());
+  EXPECT_THAT(dynamic_cast<MultipleVirtualInheritance*>(baseRes),
+              ::testing::IsNull());
+  EXPECT_THAT(res->y1, Eq(6));
+  delete baseRes;
+}
+
+TEST_F(SerializeExtensionPointerFrozenPolymorphicContext,
+       WhenDerivedIndexIsOutOfRangeThenInvalidPointerError)
+{
+  TFrozenContext ctx{ PointerLinkingContext{}, InheritanceContext{}, desPc };
+  FrozenSerContext sctx{};
+  auto& ser = sctx.createSerializer(ctx);
+  // pointer id
+  bitsery::details::writeSize(ser.adapter(), 1u);
+  // Base has 4 non abstract types in hierarchy
+  bitsery::details::writeSize(ser.adapter(), 4u);
+  Base* baseRes = nullptr;
+  auto& des = sctx.createDeserializer(ctx);
+  des.ext(baseRes, PointerOwner{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+  EXPECT_THAT(baseRes, ::testing::IsNull());
+}
+
+TEST(SerializeExtensionPointerFrozenPolymorphicContextNotFrozen,
+     WhenNotFrozenThenInvalidPointerError)
+{
+  Derived1 d1{};
+  Base* baseData = &d1;
+  FrozenPolymorphicContext<StandardRTTI> serPc{};
+  serPc.registerBasesList<FrozenSerContext::TSerializer>(
+    bitsery::ext::PolymorphicClassesList<Base>{});
+  serPc.freeze();
+  // second call does nothing
+  serPc.freeze();
+  FrozenPolymorphicContext<StandardRTTI> desPc{};
+  desPc.registerBasesList<FrozenSerContext::TDeserializer>(
+    bitsery::ext::PolymorphicClassesList<Base>{});
+
+  TFrozenContext serCtx{ PointerLinkingContext{}, InheritanceContext{}, serPc };
+  TFrozenContext desCtx{ PointerLinkingContext{}, InheritanceContext{}, desPc };
+  FrozenSerContext sctx{};
+  sctx.createSerializer(serCtx).ext(baseData, PointerOwner{});
+  Base* baseRes = nullptr;
+  auto& des = sctx.createDeserializer(desCtx);
+  des.ext(baseRes, PointerOwner{});
+  EXPECT_THAT(des.adapter().error(), Eq(bitsery::ReaderError::InvalidPointer));
+  EXPECT_THAT(baseRes, ::testing::IsNull());
+}
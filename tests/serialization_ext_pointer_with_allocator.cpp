@@ -61,6 +61,7 @@ using bitsery::ext::PointerObserver;
 using bitsery::ext::PointerOwner;
 using bitsery::ext::ReferencedByPointer;
 using bitsery::ext::EastlSmartPtr;
+using bitsery::ext::UntrackedPointerOwner;
 
 using testing::Eq;
 
@@ -284,6 +285,32 @@ TEST_F(SerializeExtensionPointerWithAllocator,
   delete dRes;
 }
 
+TEST_F(SerializeExtensionPointerWithAllocator,
+       UntrackedPointerOwnerUsesMemResourceFromPointerLinkingContext)
+{
+  MemResourceForTest memRes{};
+  std::get<0>(plctx).setMemResource(&memRes);
+
+  Base* baseData = new Derived1{ 2, 1 };
+  createSerializer().ext(baseData, UntrackedPointerOwner{});
+  Base* baseRes = new Derived2;
+  createDeserializer().ext(baseRes, UntrackedPointerOwner{});
+
+  auto dData = dynamic_cast<Derived1*>(baseData);
+  auto dRes = dynamic_cast<Derived1*>(baseRes);
+
+  EXPECT_THAT(dRes, ::testing::NotNull());
+  EXPECT_THAT(*dData, *dRes);
+  EXPECT_THAT(memRes.allocs.size(), Eq(1u));
+  EXPECT_THAT(memRes.allocs[0].typeId,
+              Eq(bitsery::ext::StandardRTTI::get<Derived1>()));
+  EXPECT_THAT(memRes.deallocs.size(), Eq(1u));
+  EXPECT_THAT(memRes.deallocs[0].typeId,
+              Eq(bitsery::ext::StandardRTTI::get<Derived2>()));
+  delete dData;
+  delete dRes;
+}
+
 TEST_F(SerializeExtensionPointerWithAllocator,
        CorrectlyDeallocatesPreviousInstance)
 {
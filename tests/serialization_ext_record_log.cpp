@@ -0,0 +1,298 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <bitsery/ext/utils/record_log.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+#if BITSERY_HAS_MMAP
+
+using bitsery::ext::RecordLogReader;
+using bitsery::ext::RecordLogWriter;
+using bitsery::ext::RecordView;
+
+using testing::Eq;
+
+struct Record
+{
+  uint32_t id{};
+  eastl::vector<uint8_t> payload{};
+
+  bool operator==(const Record& other) const
+  {
+    return id == other.id && payload == other.payload;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Record& o)
+{
+  s.value4b(o.id);
+  s.container1b(o.payload, 100000);
+}
+
+static Record
+createRecord(uint32_t id)
+{
+  return Record{ id,
+                 eastl::vector<uint8_t>(id % 13, static_cast<uint8_t>(id)) };
+}
+
+// creates empty directory and removes it with all segments
+class TempDirectory
+{
+public:
+  TempDirectory()
+  {
+    char path[] = "/tmp/bitsery_record_log_XXXXXX";
+    _path = ::mkdtemp(path);
+  }
+
+  TempDirectory(const TempDirectory&) = delete;
+  TempDirectory& operator=(const TempDirectory&) = delete;
+
+  const char* path() const { return _path.c_str(); }
+
+  ~TempDirectory()
+  {
+    if (auto dir = ::opendir(_path.c_str())) {
+      while (auto entry = ::readdir(dir)) {
+        if (entry->d_name[0] != '.')
+          ::unlink((_path + "/" + entry->d_name).c_str());
+      }
+      ::closedir(dir);
+    }
+    ::rmdir(_path.c_str());
+  }
+
+private:
+  eastl::string _path{};
+};
+
+static eastl::vector<Record>
+readAll(RecordLogReader<>& reader)
+{
+  eastl::vector<Record> res{};
+  RecordView view{};
+  while (reader.next(view)) {
+    Record record{};
+    EXPECT_TRUE(RecordLogReader<>::deserialize(view, record).second);
+    res.push_back(record);
+  }
+  return res;
+}
+
+TEST(RecordLog, AppendAndReadBack)
+{
+  TempDirectory dir{};
+  eastl::vector<Record> expected{};
+  {
+    RecordLogWriter<> writer{ dir.path() };
+    EXPECT_TRUE(writer.isOpen());
+    for (uint32_t i = 0; i < 100; ++i) {
+      expected.push_back(createRecord(i));
+      EXPECT_THAT(writer.append(expected.back()), Eq(i));
+    }
+    EXPECT_TRUE(writer.waitDurable(99));
+    EXPECT_THAT(writer.durableCount(), Eq(100u));
+    EXPECT_THAT(writer.segmentIndex(), Eq(0u));
+  }
+  RecordLogReader<> reader{ dir.path() };
+  EXPECT_THAT(readAll(reader), Eq(expected));
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+}
+
+TEST(RecordLog, RecordsAreSplitIntoSegments)
+{
+  TempDirectory dir{};
+  eastl::vector<Record> expected{};
+  {
+    RecordLogWriter<> writer{ dir.path(), 64 };
+    for (uint32_t i = 0; i < 50; ++i) {
+      expected.push_back(createRecord(i));
+      writer.append(expected.back());
+    }
+    // bigger than segment, it gets its own segment
+    expected.push_back(Record{ 1000, eastl::vector<uint8_t>(200, 1) });
+    writer.append(expected.back());
+    expected.push_back(createRecord(1001));
+    EXPECT_TRUE(writer.waitDurable(writer.append(expected.back())));
+    EXPECT_GT(writer.segmentIndex(), 10u);
+  }
+  RecordLogReader<> reader{ dir.path(), 64 };
+  EXPECT_THAT(readAll(reader), Eq(expected));
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+}
+
+TEST(RecordLog, ReaderTailsLiveLog)
+{
+  TempDirectory dir{};
+  RecordLogReader<> reader{ dir.path(), 128 };
+  RecordView view{};
+  EXPECT_FALSE(reader.next(view));
+
+  RecordLogWriter<> writer{ dir.path(), 128 };
+  uint32_t id = 0;
+  for (size_t round = 0; round < 5; ++round) {
+    eastl::vector<Record> expected{};
+    uint64_t last{};
+    for (size_t i = 0; i < 7; ++i) {
+      expected.push_back(createRecord(id++));
+      last = writer.append(expected.back());
+    }
+    EXPECT_TRUE(writer.waitDurable(last));
+    EXPECT_THAT(readAll(reader), Eq(expected));
+    EXPECT_FALSE(reader.next(view));
+  }
+  EXPECT_GT(reader.segmentIndex(), 0u);
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+}
+
+TEST(RecordLog, ConcurrentAppendsAreGroupCommitted)
+{
+  TempDirectory dir{};
+  const uint32_t perThread = 200;
+  {
+    RecordLogWriter<> writer{ dir.path(), 4096 };
+    eastl::vector<std::thread> threads{};
+    for (uint32_t t = 0; t < 4; ++t) {
+      threads.push_back(std::thread{ [&writer, t, perThread]() {
+        for (uint32_t i = 0; i < perThread; ++i)
+          EXPECT_TRUE(
+            writer.waitDurable(writer.append(createRecord(t * perThread + i))));
+      } });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    EXPECT_THAT(writer.durableCount(), Eq(4 * perThread));
+  }
+  RecordLogReader<> reader{ dir.path(), 4096 };
+  auto records = readAll(reader);
+  ASSERT_THAT(records.size(), Eq(4 * perThread));
+  eastl::vector<int> seen(4 * perThread);
+  for (auto& record : records) {
+    EXPECT_THAT(record, Eq(createRecord(record.id)));
+    ++seen[record.id];
+  }
+  EXPECT_THAT(seen, Eq(eastl::vector<int>(4 * perThread, 1)));
+}
+
+TEST(RecordLog, ReopenTruncatesTornRecord)
+{
+  TempDirectory dir{};
+  eastl::vector<Record> expected{};
+  {
+    RecordLogWriter<> writer{ dir.path() };
+    for (uint32_t i = 0; i < 10; ++i) {
+      expected.push_back(createRecord(i));
+      writer.append(expected.back());
+    }
+  }
+  // partially written record: header says 100 bytes, only 3 are written
+  {
+    const auto path =
+      bitsery::ext::record_log_details::segmentPath(dir.path(), 0);
+    const int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    const uint8_t torn[] = { 100, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7 };
+    EXPECT_TRUE(bitsery::ext::record_log_details::writeAll(fd, torn, 11));
+    ::close(fd);
+  }
+  {
+    RecordLogWriter<> writer{ dir.path() };
+    expected.push_back(createRecord(10));
+    EXPECT_TRUE(writer.waitDurable(writer.append(expected.back())));
+  }
+  RecordLogReader<> reader{ dir.path() };
+  EXPECT_THAT(readAll(reader), Eq(expected));
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::NoError));
+}
+
+TEST(RecordLog, RecordBiggerThanSizePrefixIsRejected)
+{
+  TempDirectory dir{};
+  {
+    RecordLogWriter<> writer{ dir.path() };
+    // payload is not read when record is rejected
+    const uint8_t data[1]{};
+    const auto tooBig =
+      size_t{ bitsery::ext::record_log_details::MaxRecordSize };
+    if (sizeof(size_t) > sizeof(uint32_t)) {
+      EXPECT_THAT(writer.appendRecord(data, tooBig + 1),
+                  Eq(bitsery::ext::record_log_details::NoSequence));
+    }
+    EXPECT_THAT(writer.append(createRecord(5)), Eq(0u));
+    EXPECT_TRUE(writer.waitDurable(0));
+    EXPECT_TRUE(writer.isOpen());
+  }
+  RecordLogReader<> reader{ dir.path() };
+  EXPECT_THAT(readAll(reader), Eq(eastl::vector<Record>{ createRecord(5) }));
+}
+
+TEST(RecordLog, CorruptedRecordSetsError)
+{
+  TempDirectory dir{};
+  {
+    RecordLogWriter<> writer{ dir.path() };
+    for (uint32_t i = 0; i < 3; ++i)
+      writer.append(createRecord(i + 20));
+  }
+  {
+    // first byte of the second record payload
+    const auto path =
+      bitsery::ext::record_log_details::segmentPath(dir.path(), 0);
+    const int fd = ::open(path.c_str(), O_WRONLY);
+    const uint8_t value = 0xFF;
+    ::pwrite(fd, &value, 1, 8 + 12 + 8);
+    ::close(fd);
+  }
+  RecordLogReader<> reader{ dir.path() };
+  RecordView view{};
+  EXPECT_TRUE(reader.next(view));
+  EXPECT_FALSE(reader.next(view));
+  EXPECT_THAT(reader.error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+#endif
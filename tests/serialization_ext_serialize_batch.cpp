@@ -0,0 +1,211 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include <bitsery/ext/utils/executor.h>
+#include <bitsery/ext/utils/serialize_batch.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::BatchView;
+using bitsery::ext::SequentialExecutor;
+using bitsery::ext::ThreadPoolExecutor;
+using bitsery::ext::serializeBatch;
+
+using testing::Eq;
+
+using Bytes = eastl::vector<uint8_t>;
+
+struct Message
+{
+  uint32_t id{};
+  eastl::vector<uint32_t> values{};
+
+  bool operator==(const Message& other) const
+  {
+    return id == other.id && values == other.values;
+  }
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.value4b(o.id);
+  s.container4b(o.values, 100000);
+}
+
+static eastl::vector<Message>
+createMessages(size_t count)
+{
+  eastl::vector<Message> res{};
+  for (size_t i = 0; i < count; ++i) {
+    // sizes vary a lot, some messages are empty
+    auto size = (i * 7919) % 97 == 0 ? 5000 : (i * 31) % 17;
+    res.push_back(Message{ static_cast<uint32_t>(i),
+                           eastl::vector<uint32_t>(size, 3) });
+  }
+  return res;
+}
+
+TEST(ThreadPoolExecutor, StealsFromSlowRange)
+{
+  ThreadPoolExecutor pool{ 4 };
+  // first range (tasks 0..9) belongs to calling thread and is slow, others are
+  // empty, so workers steal from it
+  eastl::vector<std::thread::id> threads(40);
+  auto task = [&threads](size_t i) {
+    if (i < 10)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    threads[i] = std::this_thread::get_id();
+  };
+  pool.parallelFor(40, task);
+  auto slowRangeThreads = 0;
+  for (size_t i = 1; i < 10; ++i)
+    slowRangeThreads += threads[i] != threads[0];
+  EXPECT_THAT(slowRangeThreads, testing::Gt(0));
+}
+
+TEST(SerializeBatch, RoundTripWithThreadPool)
+{
+  ThreadPoolExecutor pool{ 4 };
+  auto data = createMessages(1000);
+  Bytes buf{};
+  auto written = serializeBatch(pool, buf, data);
+  EXPECT_THAT(buf.size(), Eq(written));
+
+  BatchView<> view{ buf.data(), buf.size() };
+  EXPECT_THAT(view.error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(view.size(), Eq(1000u));
+  EXPECT_THAT(view.bytesCount(), Eq(written));
+  eastl::vector<Message> res{};
+  auto state = view.deserializeAll(pool, res);
+  EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+  EXPECT_TRUE(state.second);
+  EXPECT_THAT(res, Eq(data));
+}
+
+TEST(SerializeBatch, MessagesAreStoredInOrderAfterIndex)
+{
+  ThreadPoolExecutor pool{ 3 };
+  auto data = createMessages(100);
+  Bytes parallel{};
+  serializeBatch(pool, parallel, data);
+  SequentialExecutor seq{};
+  Bytes sequential{};
+  serializeBatch(seq, sequential, data);
+  EXPECT_THAT(parallel, Eq(sequential));
+
+  // index is count + 1 offsets, then each message as quickSerialization
+  // writes it
+  size_t offset = (data.size() + 2) * 8;
+  for (auto& msg : data) {
+    Bytes single{};
+    auto size = bitsery::quickSerialization(
+      bitsery::OutputBufferAdapter<Bytes>{ single }, msg);
+    single.resize(size);
+    Bytes slot(parallel.begin() + static_cast<ptrdiff_t>(offset),
+               parallel.begin() + static_cast<ptrdiff_t>(offset + size));
+    EXPECT_THAT(slot, Eq(single));
+    offset += size;
+  }
+  EXPECT_THAT(offset, Eq(parallel.size()));
+}
+
+TEST(SerializeBatch, RandomAccess)
+{
+  SequentialExecutor seq{};
+  auto data = createMessages(50);
+  Bytes buf{};
+  serializeBatch(seq, buf, data);
+  BatchView<> view{ buf.data(), buf.size() };
+  for (size_t i : { 49u, 0u, 17u, 97u % 50u }) {
+    Message res{};
+    auto state = view.deserialize(i, res);
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res, Eq(data[i]));
+    EXPECT_THAT(view.messageSize(i),
+                Eq(bitsery::quickSerialization(bitsery::MeasureSize{}, res)));
+  }
+}
+
+TEST(SerializeBatch, EmptyBatch)
+{
+  SequentialExecutor seq{};
+  eastl::vector<Message> data{};
+  Bytes buf{};
+  EXPECT_THAT(serializeBatch(seq, buf, data), Eq(16u));
+  BatchView<> view{ buf.data(), buf.size() };
+  EXPECT_THAT(view.error(), Eq(bitsery::ReaderError::NoError));
+  EXPECT_THAT(view.size(), Eq(0u));
+  EXPECT_THAT(view.bytesCount(), Eq(16u));
+}
+
+TEST(SerializeBatch, InvalidIndexSetsError)
+{
+  SequentialExecutor seq{};
+  auto data = createMessages(10);
+  Bytes buf{};
+  serializeBatch(seq, buf, data);
+
+  BatchView<> truncated{ buf.data(), 50 };
+  EXPECT_THAT(truncated.error(), Eq(bitsery::ReaderError::DataOverflow));
+  EXPECT_THAT(truncated.size(), Eq(0u));
+
+  BatchView<> lastMissing{ buf.data(), buf.size() - 1 };
+  EXPECT_THAT(lastMissing.error(), Eq(bitsery::ReaderError::DataOverflow));
+
+  // offsets must not decrease
+  auto corrupted = buf;
+  corrupted[8 * 3] = 0;
+  corrupted[8 * 3 + 1] = 0;
+  BatchView<> decreasing{ corrupted.data(), corrupted.size() };
+  EXPECT_THAT(decreasing.error(), Eq(bitsery::ReaderError::InvalidData));
+  Message res{};
+  EXPECT_THAT(decreasing.deserialize(0, res).first,
+              Eq(bitsery::ReaderError::InvalidData));
+  eastl::vector<Message> all{};
+  EXPECT_THAT(decreasing.deserializeAll(seq, all).first,
+              Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,181 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/pointer.h>
+#include <bitsery/ext/utils/serialize_exact.h>
+#include <bitsery/traits/array.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::serializeExact;
+
+using testing::Eq;
+
+using Bytes = eastl::vector<uint8_t>;
+
+struct Message
+{
+  uint32_t id{};
+  eastl::string name{};
+  eastl::vector<float> values{};
+};
+
+template<typename S>
+void
+serialize(S& s, Message& o)
+{
+  s.value4b(o.id);
+  s.text1b(o.name, 1000);
+  s.container4b(o.values, 100000);
+}
+
+Bytes
+serializeWithGrowth(const Message& msg)
+{
+  Bytes res{};
+  auto written = bitsery::quickSerialization(
+    bitsery::OutputBufferAdapter<Bytes>{ res }, msg);
+  res.resize(written);
+  return res;
+}
+
+TEST(SerializeExact, BufferIsResizedToExactSize)
+{
+  Message msg{ 5, "exact", eastl::vector<float>(1000, 1.5f) };
+  Bytes buf{ 1, 2, 3 };
+  auto written = serializeExact(buf, msg);
+  EXPECT_THAT(written, Eq(4u + 6u + 2u + 4000u));
+  EXPECT_THAT(buf.size(), Eq(written));
+  EXPECT_THAT(buf, Eq(serializeWithGrowth(msg)));
+
+  Message res{};
+  auto state = bitsery::quickDeserialization(
+    bitsery::InputBufferAdapter<Bytes>{ buf.begin(), buf.size() }, res);
+  EXPECT_TRUE(state.second);
+  EXPECT_THAT(res.values, Eq(msg.values));
+
+  // shrinks too
+  msg.values.clear();
+  EXPECT_THAT(serializeExact(buf, msg), Eq(11u));
+  EXPECT_THAT(buf.size(), Eq(11u));
+}
+
+TEST(SerializeExact, StringBuffer)
+{
+  Message msg{ 1, "text", {} };
+  eastl::string buf{};
+  EXPECT_THAT(serializeExact(buf, msg), Eq(10u));
+  EXPECT_THAT(buf.size(), Eq(10u));
+}
+
+TEST(SerializeExact, CallerSuppliedBufferIsCheckedFirst)
+{
+  Message msg{ 5, "exact", eastl::vector<float>(10, 1.5f) };
+  eastl::array<uint8_t, 100> buf{};
+  buf.fill(0xFF);
+  auto res = serializeExact(buf.data(), 20, msg);
+  EXPECT_THAT(res.first, Eq(51u));
+  EXPECT_FALSE(res.second);
+  EXPECT_THAT(buf[0], Eq(0xFF));
+
+  res = serializeExact(buf.data(), buf.size(), msg);
+  EXPECT_THAT(res.first, Eq(51u));
+  EXPECT_TRUE(res.second);
+  auto expected = serializeWithGrowth(msg);
+  EXPECT_TRUE(eastl::equal(expected.begin(), expected.end(), buf.begin()));
+  EXPECT_THAT(buf[51], Eq(0xFF));
+}
+
+struct Node
+{
+  uint32_t value{};
+  Node* next{};
+};
+
+template<typename S>
+void
+serialize(S& s, Node& o)
+{
+  s.value4b(o.value);
+  s.ext(o.next, bitsery::ext::PointerObserver{});
+}
+
+struct Graph
+{
+  eastl::vector<Node*> nodes{};
+};
+
+template<typename S>
+void
+serialize(S& s, Graph& o)
+{
+  s.container(o.nodes, 100, [](S& s, Node*& node) {
+    s.ext(node, bitsery::ext::PointerOwner{});
+  });
+}
+
+TEST(SerializeExact, EachPassHasItsOwnContext)
+{
+  Node n1{ 1, nullptr };
+  Node n2{ 2, &n1 };
+  n1.next = &n2;
+  Graph graph{ { &n1, &n2 } };
+
+  bitsery::ext::PointerLinkingContext measureCtx{};
+  bitsery::ext::PointerLinkingContext ctx{};
+  Bytes buf{};
+  auto written = serializeExact(measureCtx, ctx, buf, graph);
+  EXPECT_TRUE(ctx.isValid());
+  EXPECT_THAT(buf.size(), Eq(written));
+
+  bitsery::ext::PointerLinkingContext growthCtx{};
+  Bytes expected{};
+  auto expectedSize = bitsery::quickSerialization(
+    growthCtx, bitsery::OutputBufferAdapter<Bytes>{ expected }, graph);
+  expected.resize(expectedSize);
+  EXPECT_THAT(buf, Eq(expected));
+}
@@ -0,0 +1,195 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/utils/size_predictor.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::BufferSizePredictor;
+using bitsery::ext::SizeEstimateEwma;
+using bitsery::ext::SizeEstimateMaxOfLast;
+
+using testing::Eq;
+using testing::Ge;
+
+struct Small
+{
+  uint32_t value{};
+};
+
+template<typename S>
+void
+serialize(S& s, Small& o)
+{
+  s.value4b(o.value);
+}
+
+struct Large
+{
+  eastl::vector<uint32_t> values{};
+};
+
+template<typename S>
+void
+serialize(S& s, Large& o)
+{
+  s.container4b(o.values, 100000);
+}
+
+TEST(SizeEstimate, MaxOfLastN)
+{
+  SizeEstimateMaxOfLast<3> est{};
+  EXPECT_THAT(est.predict(), Eq(0u));
+  est.add(10);
+  est.add(30);
+  est.add(20);
+  EXPECT_THAT(est.predict(), Eq(30u));
+  est.add(5);
+  EXPECT_THAT(est.predict(), Eq(30u));
+  est.add(5);
+  EXPECT_THAT(est.predict(), Eq(20u));
+}
+
+TEST(SizeEstimate, EwmaStartsFromFirstSizeAndAddsHeadroom)
+{
+  SizeEstimateEwma<1, 2> est{};
+  est.add(1000);
+  EXPECT_THAT(est.predict(), Eq(1250u));
+  est.add(2000);
+  EXPECT_THAT(est.predict(), Eq(1875u));
+}
+
+TEST(BufferSizePredictor, FirstMessageIsMissThenBufferIsPreparedUpFront)
+{
+  BufferSizePredictor<> predictor{};
+  Large large{};
+  large.values.resize(10000);
+
+  Buffer first{};
+  auto written = predictor.serialize(first, large);
+  EXPECT_THAT(written, Eq(40002u));
+  auto stats = predictor.stats<Large>();
+  ASSERT_NE(stats, nullptr);
+  EXPECT_THAT(stats->misses, Eq(1u));
+  EXPECT_THAT(stats->hits, Eq(0u));
+  EXPECT_THAT(stats->resizes, Ge(2u));
+  EXPECT_THAT(stats->predictedSize, Eq(40002u));
+
+  for (auto i = 0; i < 3; ++i) {
+    Buffer buf{};
+    EXPECT_THAT(predictor.serialize(buf, large), Eq(written));
+    EXPECT_TRUE(eastl::equal(buf.begin(), buf.begin() + 40002, first.begin()));
+  }
+  EXPECT_THAT(stats->misses, Eq(1u));
+  EXPECT_THAT(stats->hits, Eq(3u));
+  auto firstResizes = stats->resizes;
+
+  // bigger message doesn't fit
+  large.values.resize(20000);
+  Buffer buf{};
+  predictor.serialize(buf, large);
+  EXPECT_THAT(stats->misses, Eq(2u));
+  EXPECT_THAT(stats->resizes, Ge(firstResizes + 1));
+  EXPECT_THAT(predictor.predict<Large>(), Eq(80004u));
+}
+
+TEST(BufferSizePredictor, TracksEachTypeSeparately)
+{
+  BufferSizePredictor<SizeEstimateEwma<>> predictor{};
+  Small small{ 5 };
+  Large large{};
+  large.values.resize(100);
+  for (auto i = 0; i < 10; ++i) {
+    Buffer smallBuf{};
+    Buffer largeBuf{};
+    predictor.serialize(smallBuf, small);
+    predictor.serialize(largeBuf, large);
+  }
+  EXPECT_THAT(predictor.predict<Small>(), Eq(5u));
+  EXPECT_THAT(predictor.predict<Large>(), Eq(501u));
+  EXPECT_THAT(predictor.predict<int>(), Eq(0u));
+  EXPECT_EQ(predictor.stats<int>(), nullptr);
+
+  size_t typesCount{};
+  predictor.forEachStats(
+    [&typesCount](const bitsery::ext::SizePredictorStats& s) {
+      ++typesCount;
+      EXPECT_THAT(s.hits, Eq(9u));
+      EXPECT_THAT(s.misses, Eq(1u));
+    });
+  EXPECT_THAT(typesCount, Eq(2u));
+  auto total = predictor.totalStats();
+  EXPECT_THAT(total.hits, Eq(18u));
+  EXPECT_THAT(total.misses, Eq(2u));
+}
+
+TEST(BufferSizePredictor, ManualPrepareAndRecord)
+{
+  BufferSizePredictor<> predictor{};
+  predictor.record<Large>(0, 5000);
+  eastl::string buf{};
+  EXPECT_THAT(predictor.prepare<Large>(buf), Eq(5000u));
+  EXPECT_THAT(buf.size(), Ge(5000u));
+
+  // doesn't shrink bigger buffer
+  eastl::string bigBuf(10000, 'a');
+  predictor.prepare<Large>(bigBuf);
+  EXPECT_THAT(bigBuf.size(), Eq(10000u));
+}
+
+TEST(BufferSizePredictor, WithContext)
+{
+  BufferSizePredictor<> predictor{};
+  int ctx{};
+  Small small{ 7 };
+  Buffer buf{};
+  EXPECT_THAT(predictor.serialize(ctx, buf, small), Eq(4u));
+  Small res{};
+  bitsery::quickDeserialization(
+    bitsery::InputBufferAdapter<Buffer>{ buf.begin(), 4 }, res);
+  EXPECT_THAT(res.value, Eq(7u));
+}
@@ -0,0 +1,244 @@
+// MIT License
+//
+// Copyright (c) 2017 Mindaugas Vinkelis
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <bitsery/ext/eastl_smart_ptr.h>
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/ext/pointer.h>
+
+#include "serialization_test_utils.h"
+#include <gmock/gmock.h>
+
+void* __cdecl operator new[](size_t size, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+void* __cdecl operator new[](size_t size, size_t alignement, size_t offset, const char* name, int flags, unsigned debugFlags, const char* file, int line)
+{
+	(void)name;
+	(void)alignement;
+	(void)offset;
+	(void)flags;
+	(void)debugFlags;
+	(void)file;
+	(void)line;
+	return new uint8_t[size];
+}
+
+using bitsery::ext::BaseClass;
+using bitsery::ext::VirtualBaseClass;
+
+using bitsery::ext::InheritanceContext;
+using bitsery::ext::PointerLinkingContext;
+using bitsery::ext::PolymorphicContext;
+using bitsery::ext::StaticRTTI;
+
+using PointerOwner = bitsery::ext::PointerOwnerBase<StaticRTTI>;
+using EastlSmartPtr = bitsery::ext::EastlSmartPtrBase<StaticRTTI>;
+
+using testing::Eq;
+
+struct Shape
+{
+  BITSERY_STATIC_RTTI_BASE(Shape)
+
+  uint8_t id{};
+
+  virtual ~Shape() = default;
+};
+
+template<typename S>
+void
+serialize(S& s, Shape& o)
+{
+  s.value1b(o.id);
+}
+
+// non virtual inheritance
+struct Circle : Shape
+{
+  BITSERY_STATIC_RTTI(Circle)
+
+  uint16_t radius{};
+};
+
+template<typename S>
+void
+serialize(S& s, Circle& o)
+{
+  s.ext(o, BaseClass<Shape>{});
+  s.value2b(o.radius);
+}
+
+// virtual inheritance
+struct Rectangle : virtual Shape
+{
+  BITSERY_STATIC_RTTI(Rectangle)
+
+  uint16_t width{};
+  uint16_t height{};
+};
+
+template<typename S>
+void
+serialize(S& s, Rectangle& o)
+{
+  s.ext(o, VirtualBaseClass<Shape>{});
+  s.value2b(o.width);
+  s.value2b(o.height);
+}
+
+namespace bitsery {
+namespace ext {
+
+template<>
+struct PolymorphicBaseClass<Shape> : PolymorphicDerivedClasses<Circle, Rectangle>
+{
+};
+
+}
+}
+
+using TContext = eastl::tuple<PointerLinkingContext,
+                              InheritanceContext,
+                              PolymorphicContext<StaticRTTI>>;
+using SerContext = BasicSerializationContext<TContext>;
+
+class SerializeExtensionStaticRTTI : public testing::Test
+{
+public:
+  TContext plctx{};
+  SerContext sctx{};
+
+  typename SerContext::TSerializer& createSerializer()
+  {
+    auto& res = sctx.createSerializer(plctx);
+    eastl::get<2>(plctx).clear();
+    eastl::get<2>(plctx).registerBasesList<SerContext::TSerializer>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    return res;
+  }
+
+  typename SerContext::TDeserializer& createDeserializer()
+  {
+    auto& res = sctx.createDeserializer(plctx);
+    eastl::get<2>(plctx).clear();
+    eastl::get<2>(plctx).registerBasesList<SerContext::TDeserializer>(
+      bitsery::ext::PolymorphicClassesList<Shape>{});
+    return res;
+  }
+
+  virtual void TearDown() override
+  {
+    EXPECT_TRUE(eastl::get<0>(plctx).isValid());
+  }
+};
+
+TEST(StaticRTTI, TypeIdsAreComputedAtCompileTime)
+{
+  static_assert(StaticRTTI::get<Shape>() != StaticRTTI::get<Circle>(), "");
+  static_assert(StaticRTTI::get<int32_t>() != StaticRTTI::get<uint32_t>(), "");
+  static_assert(StaticRTTI::get<const Shape>() == StaticRTTI::get<Shape>(),
+                "");
+  static_assert(StaticRTTI::isPolymorphic<Shape>(), "");
+  static_assert(!StaticRTTI::isPolymorphic<MyStruct1>(), "");
+}
+
+TEST(StaticRTTI, RuntimeTypeIdIsMostDerivedType)
+{
+  Rectangle r{};
+  Circle c{};
+  Shape& rs = r;
+  Shape& cs = c;
+  EXPECT_THAT(StaticRTTI::get(rs), Eq(StaticRTTI::get<Rectangle>()));
+  EXPECT_THAT(StaticRTTI::get(cs), Eq(StaticRTTI::get<Circle>()));
+  MyStruct1 s{};
+  EXPECT_THAT(StaticRTTI::get(s), Eq(StaticRTTI::get<MyStruct1>()));
+}
+
+TEST(StaticRTTI, CastsWithAndWithoutVirtualInheritance)
+{
+  Rectangle r{};
+  Circle c{};
+  Shape* rs = &r;
+  Shape* cs = &c;
+  EXPECT_THAT((StaticRTTI::cast<Rectangle, Shape>(&r)), Eq(rs));
+  EXPECT_THAT((StaticRTTI::cast<Shape, Rectangle>(rs)), Eq(&r));
+  EXPECT_THAT((StaticRTTI::cast<Shape, Circle>(cs)), Eq(&c));
+  // virtual base can only be casted to its most derived type
+  EXPECT_THAT((StaticRTTI::cast<Shape, Rectangle>(cs)), ::testing::IsNull());
+}
+
+TEST_F(SerializeExtensionStaticRTTI, PointerOwner)
+{
+  Rectangle r{};
+  r.id = 4;
+  r.width = 800;
+  r.height = 600;
+  Shape* data = &r;
+  createSerializer().ext(data, PointerOwner{});
+  Shape* res = new Circle{};
+  createDeserializer().ext(res, PointerOwner{});
+
+  auto resRect = StaticRTTI::cast<Shape, Rectangle>(res);
+  EXPECT_THAT(resRect, ::testing::NotNull());
+  EXPECT_THAT(resRect->id, Eq(4));
+  EXPECT_THAT(resRect->width, Eq(800));
+  EXPECT_THAT(resRect->height, Eq(600));
+  delete res;
+}
+
+TEST_F(SerializeExtensionStaticRTTI, EastlSmartPtr)
+{
+  eastl::vector<eastl::unique_ptr<Shape>> data{};
+  data.emplace_back(new Circle{});
+  data.emplace_back(new Rectangle{});
+  eastl::shared_ptr<Shape> sharedData{ new Circle{} };
+  StaticRTTI::cast<Shape, Circle>(data[0].get())->radius = 7;
+  StaticRTTI::cast<Shape, Rectangle>(data[1].get())->width = 9;
+  auto& ser = createSerializer();
+  ser.container(data, 10, [](decltype(ser)& ser, eastl::unique_ptr<Shape>& o) {
+    ser.ext(o, EastlSmartPtr{});
+  });
+  ser.ext(sharedData, EastlSmartPtr{});
+
+  eastl::vector<eastl::unique_ptr<Shape>> res{};
+  eastl::shared_ptr<Shape> sharedRes{};
+  auto& des = createDeserializer();
+  des.container(res, 10, [](decltype(des)& des, eastl::unique_ptr<Shape>& o) {
+    des.ext(o, EastlSmartPtr{});
+  });
+  des.ext(sharedRes, EastlSmartPtr{});
+  eastl::get<0>(plctx).clearSharedState();
+
+  EXPECT_THAT(res.size(), Eq(2u));
+  auto circle = StaticRTTI::cast<Shape, Circle>(res[0].get());
+  auto rect = StaticRTTI::cast<Shape, Rectangle>(res[1].get());
+  EXPECT_THAT(circle->radius, Eq(7));
+  EXPECT_THAT(rect->width, Eq(9));
+  EXPECT_THAT(StaticRTTI::get(*sharedRes), Eq(StaticRTTI::get<Circle>()));
+}